@@ -0,0 +1,570 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedallocator.h"
+
+#include <gst/allocators/allocators.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__has_include)
+#if __has_include(<linux/udmabuf.h>) && defined(F_SEAL_SHRINK)
+#include <linux/udmabuf.h>
+#define GST_ZED_HAVE_UDMABUF 1
+#endif
+#endif
+
+#define GST_ZED_HUGEPAGE_ALLOCATOR_TYPE_NAME "GstZedHugePageAllocator"
+#define GST_ZED_MEMFD_ALLOCATOR_TYPE_NAME "GstZedMemfdAllocator"
+#define GST_ZED_UDMABUF_ALLOCATOR_TYPE_NAME "GstZedUdmabufAllocator"
+
+// Used when the huge page size cannot be read from /proc/meminfo [bytes]
+#define DEFAULT_HUGEPAGE_SIZE (2 * 1024 * 1024)
+
+typedef struct {
+    GstAllocator parent;
+
+    gsize page_size;       // Base page size [bytes]
+    gsize hugepage_size;   // Default huge page size [bytes]
+    gboolean hugetlb;      // Reserved huge pages still available
+
+    GstZedAllocatorStats stats;   // Under the object lock
+} GstZedHugePageAllocator;
+
+typedef struct {
+    GstAllocatorClass parent_class;
+} GstZedHugePageAllocatorClass;
+
+typedef struct {
+    GstMemory mem;
+
+    guint8 *data;        // Start of the mapping, or of the parent mapping
+    gsize map_size;      // Mapped size, 0 for shared memories [bytes]
+} GstZedHugePageMemory;
+
+typedef struct {
+    GstFdAllocator parent;
+
+    gsize page_size;   // Base page size [bytes]
+} GstZedMemfdAllocator;
+
+typedef struct {
+    GstFdAllocatorClass parent_class;
+} GstZedMemfdAllocatorClass;
+
+typedef struct {
+    GstDmaBufAllocator parent;
+
+    gsize page_size;   // Base page size [bytes]
+    gint device;       // `/dev/udmabuf`, open for the life of the process
+} GstZedUdmabufAllocator;
+
+typedef struct {
+    GstDmaBufAllocatorClass parent_class;
+} GstZedUdmabufAllocatorClass;
+
+static GType gst_zed_hugepage_allocator_get_type(void);
+
+/* The static library is linked in each ZED plugin: the first one loaded registers
+ * the type, the others reuse it */
+static GType gst_zed_register_shared_type(GType parent, const gchar *name, guint class_size,
+                                          GClassInitFunc class_init, guint instance_size,
+                                          GInstanceInitFunc instance_init) {
+    GType type = g_type_from_name(name);
+
+    if (type == 0) {
+        type = g_type_register_static_simple(parent, g_intern_static_string(name), class_size,
+                                             class_init, instance_size, instance_init,
+                                             (GTypeFlags) 0);
+    }
+
+    return type;
+}
+
+/* Register the new `allocator` process-wide as `name` and return it */
+static GstAllocator *gst_zed_allocator_register(const gchar *name, gpointer allocator) {
+    gst_object_ref_sink(allocator);
+    gst_allocator_register(name, GST_ALLOCATOR_CAST(gst_object_ref(allocator)));
+
+    return GST_ALLOCATOR_CAST(allocator);
+}
+
+/* Default huge page size of the system */
+static gsize gst_zed_read_hugepage_size(void) {
+    gsize size = DEFAULT_HUGEPAGE_SIZE;
+    FILE *f = fopen("/proc/meminfo", "r");
+    char line[128];
+    unsigned long kb;
+
+    if (!f) {
+        return size;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        if (sscanf(line, "Hugepagesize: %lu kB", &kb) == 1) {
+            size = kb * 1024;
+            break;
+        }
+    }
+    fclose(f);
+
+    return size;
+}
+
+/* Map `size` bytes advised for transparent huge pages and pre-fault them. Large
+ * mappings are aligned on the huge page size for all of them to be eligible. */
+static guint8 *gst_zed_hugepage_map_thp(GstZedHugePageAllocator *self, gsize size,
+                                        gsize *map_size) {
+    gboolean large = (size >= self->hugepage_size);
+    gsize align = large ? self->hugepage_size : self->page_size;
+    gsize len = GST_ROUND_UP_N(size, align);
+    gsize span = large ? len + align : len;
+
+    guint8 *raw = static_cast<guint8 *>(
+        mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED) {
+        return NULL;
+    }
+
+    // Trim the mapping to the aligned range
+    guint8 *data = reinterpret_cast<guint8 *>(
+        GST_ROUND_UP_N(reinterpret_cast<guintptr>(raw), static_cast<guintptr>(align)));
+    if (data > raw) {
+        munmap(raw, data - raw);
+    }
+    if (raw + span > data + len) {
+        munmap(data + len, (raw + span) - (data + len));
+    }
+
+#ifdef MADV_HUGEPAGE
+    madvise(data, len, MADV_HUGEPAGE);
+#endif
+    // Pre-fault after the advice, for the pages to be huge when possible
+    for (gsize off = 0; off < len; off += self->page_size) {
+        data[off] = 0;
+    }
+
+    *map_size = len;
+    return data;
+}
+
+static GstMemory *gst_zed_hugepage_alloc(GstAllocator *allocator, gsize size,
+                                         GstAllocationParams *params) {
+    GstZedHugePageAllocator *self = reinterpret_cast<GstZedHugePageAllocator *>(allocator);
+    gsize maxsize = size + params->prefix + params->padding;
+    guint8 *data = static_cast<guint8 *>(MAP_FAILED);
+    gsize map_size = 0;
+    gboolean hugetlb = FALSE;
+
+    // Mappings are page aligned: any alignment up to the page size is met
+    if (params->align >= self->page_size) {
+        return NULL;
+    }
+
+    // Small memories would waste most of a huge page
+    GST_OBJECT_LOCK(self);
+    gboolean try_hugetlb = self->hugetlb && maxsize >= self->hugepage_size;
+    GST_OBJECT_UNLOCK(self);
+
+    if (try_hugetlb) {
+        map_size = GST_ROUND_UP_N(maxsize, self->hugepage_size);
+        data = static_cast<guint8 *>(mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE,
+                                          -1, 0));
+        if (data != MAP_FAILED) {
+            hugetlb = TRUE;
+        } else {
+            // No reserved huge page left: stop trying
+            GST_OBJECT_LOCK(self);
+            self->hugetlb = FALSE;
+            GST_OBJECT_UNLOCK(self);
+        }
+    }
+
+    if (data == MAP_FAILED) {
+        data = gst_zed_hugepage_map_thp(self, maxsize, &map_size);
+        if (!data) {
+            return NULL;
+        }
+    }
+
+    GstZedHugePageMemory *mem = g_new0(GstZedHugePageMemory, 1);
+    gst_memory_init(GST_MEMORY_CAST(mem), (GstMemoryFlags) params->flags, allocator, NULL, maxsize,
+                    params->align | GST_ZED_ALLOCATOR_ALIGN, params->prefix, size);
+    mem->data = data;
+    mem->map_size = map_size;
+
+    GST_OBJECT_LOCK(self);
+    self->stats.allocations++;
+    self->stats.hugetlb += hugetlb ? 1 : 0;
+    self->stats.bytes += map_size;
+    self->stats.faults_avoided += map_size / (hugetlb ? self->hugepage_size : self->page_size);
+    GST_OBJECT_UNLOCK(self);
+
+    return GST_MEMORY_CAST(mem);
+}
+
+static void gst_zed_hugepage_free(GstAllocator *allocator, GstMemory *memory) {
+    GstZedHugePageMemory *mem = reinterpret_cast<GstZedHugePageMemory *>(memory);
+
+    (void) allocator;
+    if (mem->map_size > 0) {
+        munmap(mem->data, mem->map_size);
+    }
+    g_free(mem);
+}
+
+static gpointer gst_zed_hugepage_mem_map(GstMemory *memory, gsize maxsize, GstMapFlags flags) {
+    (void) maxsize;
+    (void) flags;
+    return reinterpret_cast<GstZedHugePageMemory *>(memory)->data;
+}
+
+static void gst_zed_hugepage_mem_unmap(GstMemory *memory) {
+    (void) memory;
+}
+
+static GstMemory *gst_zed_hugepage_mem_share(GstMemory *memory, gssize offset, gssize size) {
+    GstZedHugePageMemory *mem = reinterpret_cast<GstZedHugePageMemory *>(memory);
+    GstMemory *parent = memory->parent ? memory->parent : memory;
+
+    if (size == -1) {
+        size = memory->size - offset;
+    }
+
+    // Shares the parent mapping, which stays alive until the shared memory is freed
+    GstZedHugePageMemory *sub = g_new0(GstZedHugePageMemory, 1);
+    GstMemoryFlags flags =
+        (GstMemoryFlags) (GST_MINI_OBJECT_FLAGS(parent) | GST_MINI_OBJECT_FLAG_LOCK_READONLY);
+    gst_memory_init(GST_MEMORY_CAST(sub), flags, memory->allocator, parent, memory->maxsize,
+                    memory->align, memory->offset + offset, size);
+    sub->data = mem->data;
+    sub->map_size = 0;
+
+    return GST_MEMORY_CAST(sub);
+}
+
+static void gst_zed_hugepage_allocator_class_init(GstZedHugePageAllocatorClass *klass) {
+    GstAllocatorClass *allocator_class = GST_ALLOCATOR_CLASS(klass);
+
+    allocator_class->alloc = gst_zed_hugepage_alloc;
+    allocator_class->free = gst_zed_hugepage_free;
+}
+
+static void gst_zed_hugepage_allocator_init(GstZedHugePageAllocator *self) {
+    GstAllocator *allocator = GST_ALLOCATOR_CAST(self);
+
+    allocator->mem_type = GST_ZED_HUGEPAGE_ALLOCATOR_NAME;
+    allocator->mem_map = gst_zed_hugepage_mem_map;
+    allocator->mem_unmap = gst_zed_hugepage_mem_unmap;
+    allocator->mem_share = gst_zed_hugepage_mem_share;
+
+    self->page_size = sysconf(_SC_PAGESIZE);
+    self->hugepage_size = gst_zed_read_hugepage_size();
+    self->hugetlb = TRUE;
+}
+
+static GType gst_zed_hugepage_allocator_get_type(void) {
+    static gsize type_id = 0;
+
+    if (g_once_init_enter(&type_id)) {
+        GType type = gst_zed_register_shared_type(
+            GST_TYPE_ALLOCATOR, GST_ZED_HUGEPAGE_ALLOCATOR_TYPE_NAME,
+            sizeof(GstZedHugePageAllocatorClass),
+            (GClassInitFunc) gst_zed_hugepage_allocator_class_init,
+            sizeof(GstZedHugePageAllocator), (GInstanceInitFunc) gst_zed_hugepage_allocator_init);
+        g_once_init_leave(&type_id, type);
+    }
+
+    return type_id;
+}
+
+GstAllocator *gst_zed_hugepage_allocator_get(void) {
+    GstAllocator *allocator = gst_allocator_find(GST_ZED_HUGEPAGE_ALLOCATOR_NAME);
+
+    if (!allocator) {
+        allocator = gst_zed_allocator_register(
+            GST_ZED_HUGEPAGE_ALLOCATOR_NAME,
+            g_object_new(gst_zed_hugepage_allocator_get_type(), NULL));
+    }
+
+    return allocator;
+}
+
+void gst_zed_hugepage_allocator_get_stats(GstAllocator *allocator, GstZedAllocatorStats *stats) {
+    GstZedHugePageAllocator *self = reinterpret_cast<GstZedHugePageAllocator *>(allocator);
+
+    GST_OBJECT_LOCK(self);
+    *stats = self->stats;
+    GST_OBJECT_UNLOCK(self);
+}
+
+// ----> memfd
+/* Anonymous memfd file of `size` bytes, -1 on failure. `sealing` allows the seals
+ * required by udmabuf. */
+static gint gst_zed_memfd_create(gsize size, gboolean sealing) {
+#ifdef MFD_CLOEXEC
+    gint fd = memfd_create("zed-frame", MFD_CLOEXEC | (sealing ? MFD_ALLOW_SEALING : 0));
+    if (fd < 0) {
+        return -1;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+#else
+    (void) size;
+    (void) sealing;
+    return -1;
+#endif
+}
+
+/* Wrap the file `fd` of `map_size` bytes in a memory of `allocator` kept mapped, its
+ * pages pre-faulted. Takes `fd`. */
+static GstMemory *gst_zed_fd_memory_new(GstAllocator *allocator, gint fd, gsize map_size,
+                                        gsize page_size, gsize size, GstAllocationParams *params) {
+    GstMemory *mem =
+        gst_fd_allocator_alloc(allocator, fd, map_size, GST_FD_MEMORY_FLAG_KEEP_MAPPED);
+    GstMapInfo info;
+
+    if (!mem) {
+        close(fd);
+        return NULL;
+    }
+    GST_MINI_OBJECT_FLAGS(mem) |= params->flags;
+
+    // The mapping is kept: touching it once avoids the page faults of the first frame
+    if (gst_memory_map(mem, &info, GST_MAP_WRITE)) {
+        for (gsize off = 0; off < info.maxsize; off += page_size) {
+            info.data[off] = 0;
+        }
+        gst_memory_unmap(mem, &info);
+    }
+    gst_memory_resize(mem, params->prefix, size);
+
+    return mem;
+}
+
+static GstMemory *gst_zed_memfd_alloc(GstAllocator *allocator, gsize size,
+                                      GstAllocationParams *params) {
+    GstZedMemfdAllocator *self = reinterpret_cast<GstZedMemfdAllocator *>(allocator);
+    gsize map_size = GST_ROUND_UP_N(size + params->prefix + params->padding, self->page_size);
+
+    // Mappings are page aligned: any alignment up to the page size is met
+    if (params->align >= self->page_size) {
+        return NULL;
+    }
+
+    gint fd = gst_zed_memfd_create(map_size, FALSE);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    return gst_zed_fd_memory_new(allocator, fd, map_size, self->page_size, size, params);
+}
+
+static void gst_zed_memfd_allocator_class_init(GstZedMemfdAllocatorClass *klass) {
+    GST_ALLOCATOR_CLASS(klass)->alloc = gst_zed_memfd_alloc;
+}
+
+static void gst_zed_memfd_allocator_init(GstZedMemfdAllocator *self) {
+    self->page_size = sysconf(_SC_PAGESIZE);
+}
+
+static GType gst_zed_memfd_allocator_get_type(void) {
+    static gsize type_id = 0;
+
+    if (g_once_init_enter(&type_id)) {
+        GType type = gst_zed_register_shared_type(
+            GST_TYPE_FD_ALLOCATOR, GST_ZED_MEMFD_ALLOCATOR_TYPE_NAME,
+            sizeof(GstZedMemfdAllocatorClass), (GClassInitFunc) gst_zed_memfd_allocator_class_init,
+            sizeof(GstZedMemfdAllocator), (GInstanceInitFunc) gst_zed_memfd_allocator_init);
+        g_once_init_leave(&type_id, type);
+    }
+
+    return type_id;
+}
+
+GstAllocator *gst_zed_memfd_allocator_get(void) {
+#ifdef MFD_CLOEXEC
+    GstAllocator *allocator = gst_allocator_find(GST_ZED_MEMFD_ALLOCATOR_NAME);
+
+    if (!allocator) {
+        allocator = gst_zed_allocator_register(
+            GST_ZED_MEMFD_ALLOCATOR_NAME, g_object_new(gst_zed_memfd_allocator_get_type(), NULL));
+    }
+
+    return allocator;
+#else
+    return NULL;
+#endif
+}
+// <---- memfd
+
+// ----> udmabuf
+#ifdef GST_ZED_HAVE_UDMABUF
+static GstMemory *gst_zed_udmabuf_alloc(GstAllocator *allocator, gsize size,
+                                        GstAllocationParams *params) {
+    GstZedUdmabufAllocator *self = reinterpret_cast<GstZedUdmabufAllocator *>(allocator);
+    gsize map_size = GST_ROUND_UP_N(size + params->prefix + params->padding, self->page_size);
+
+    if (params->align >= self->page_size) {
+        return NULL;
+    }
+
+    // udmabuf requires the memfd not to be shrinkable
+    gint fd = gst_zed_memfd_create(map_size, TRUE);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    struct udmabuf_create create;
+    memset(&create, 0, sizeof(create));
+    create.memfd = static_cast<__u32>(fd);
+    create.flags = UDMABUF_FLAGS_CLOEXEC;
+    create.offset = 0;
+    create.size = map_size;
+
+    // The DMABuf holds its own reference on the pages of the memfd
+    gint dmabuf = ioctl(self->device, UDMABUF_CREATE, &create);
+    close(fd);
+    if (dmabuf < 0) {
+        return NULL;
+    }
+
+    return gst_zed_fd_memory_new(allocator, dmabuf, map_size, self->page_size, size, params);
+}
+
+static void gst_zed_udmabuf_allocator_class_init(GstZedUdmabufAllocatorClass *klass) {
+    GST_ALLOCATOR_CLASS(klass)->alloc = gst_zed_udmabuf_alloc;
+}
+
+static void gst_zed_udmabuf_allocator_init(GstZedUdmabufAllocator *self) {
+    self->page_size = sysconf(_SC_PAGESIZE);
+    self->device = open("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+}
+
+static GType gst_zed_udmabuf_allocator_get_type(void) {
+    static gsize type_id = 0;
+
+    if (g_once_init_enter(&type_id)) {
+        GType type = gst_zed_register_shared_type(
+            GST_TYPE_DMABUF_ALLOCATOR, GST_ZED_UDMABUF_ALLOCATOR_TYPE_NAME,
+            sizeof(GstZedUdmabufAllocatorClass),
+            (GClassInitFunc) gst_zed_udmabuf_allocator_class_init,
+            sizeof(GstZedUdmabufAllocator), (GInstanceInitFunc) gst_zed_udmabuf_allocator_init);
+        g_once_init_leave(&type_id, type);
+    }
+
+    return type_id;
+}
+
+GstAllocator *gst_zed_udmabuf_allocator_get(void) {
+    GstAllocator *allocator = gst_allocator_find(GST_ZED_UDMABUF_ALLOCATOR_NAME);
+
+    if (!allocator) {
+        GstZedUdmabufAllocator *self = reinterpret_cast<GstZedUdmabufAllocator *>(
+            g_object_new(gst_zed_udmabuf_allocator_get_type(), NULL));
+
+        // Only the allocators with the device open are registered, never finalized
+        if (self->device < 0) {
+            gst_object_unref(gst_object_ref_sink(self));
+            return NULL;
+        }
+        allocator = gst_zed_allocator_register(GST_ZED_UDMABUF_ALLOCATOR_NAME, self);
+    }
+
+    return allocator;
+}
+#else
+GstAllocator *gst_zed_udmabuf_allocator_get(void) {
+    return NULL;
+}
+#endif
+// <---- udmabuf
+#else
+GstAllocator *gst_zed_hugepage_allocator_get(void) {
+    return NULL;
+}
+
+void gst_zed_hugepage_allocator_get_stats(GstAllocator *allocator, GstZedAllocatorStats *stats) {
+    (void) allocator;
+    memset(stats, 0, sizeof(*stats));
+}
+
+GstAllocator *gst_zed_memfd_allocator_get(void) {
+    return NULL;
+}
+
+GstAllocator *gst_zed_udmabuf_allocator_get(void) {
+    return NULL;
+}
+#endif
+
+// ----> DMABuf caps
+/* Copy of `caps` with all their structures in system memory */
+static GstCaps *gst_zed_caps_system_memory(const GstCaps *caps) {
+    GstCaps *sysmem = gst_caps_copy(caps);
+
+    for (guint i = 0; i < gst_caps_get_size(sysmem); i++) {
+        gst_caps_set_features(sysmem, i, NULL);
+    }
+
+    return sysmem;
+}
+
+GstCaps *gst_zed_caps_add_dmabuf(GstCaps *caps) {
+    GstCaps *dmabuf = gst_caps_new_empty();
+
+    for (guint i = 0; i < gst_caps_get_size(caps); i++) {
+        GstStructure *s = gst_caps_get_structure(caps, i);
+
+        if (gst_structure_has_name(s, "video/x-raw")) {
+            gst_caps_append_structure_full(
+                dmabuf, gst_structure_copy(s),
+                gst_caps_features_new(GST_CAPS_FEATURE_MEMORY_DMABUF, NULL));
+        }
+    }
+
+    return gst_caps_merge(dmabuf, caps);
+}
+
+gboolean gst_zed_caps_can_intersect_any_memory(const GstCaps *caps1, const GstCaps *caps2) {
+    GstCaps *sysmem1 = gst_zed_caps_system_memory(caps1);
+    GstCaps *sysmem2 = gst_zed_caps_system_memory(caps2);
+    gboolean ret = gst_caps_can_intersect(sysmem1, sysmem2);
+
+    gst_caps_unref(sysmem1);
+    gst_caps_unref(sysmem2);
+
+    return ret;
+}
+// <---- DMABuf caps
@@ -0,0 +1,83 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_ALLOCATOR_H_
+#define _GST_ZED_ALLOCATOR_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Allocators of the ZED source output frames, shared by the ZED plugins.
+ *
+ * Huge page allocator: memories are mapped with MAP_HUGETLB when huge pages are reserved, with
+ * transparent huge pages advised otherwise, and pre-faulted: the first write of a
+ * frame does not trigger a page fault storm. They are at least 64 bytes aligned.
+ * Memories are recycled by the buffer pool of the element, never returned to the
+ * system while streaming.
+ *
+ * memfd allocator: `GstFdMemory` backed by an anonymous memfd file, pre-faulted
+ * and kept mapped. Frames can be passed by file descriptor to other processes
+ * (e.g. `unixfdsink`) without being copied.
+ *
+ * udmabuf allocator: memfd pages exported as DMABuf through `/dev/udmabuf`, for
+ * the consumers negotiating `memory:DMABuf` caps. Still mappable by the CPU.
+ *
+ * Only available on Linux. */
+
+#define GST_ZED_HUGEPAGE_ALLOCATOR_NAME "ZedHugePageMemory"
+#define GST_ZED_MEMFD_ALLOCATOR_NAME "ZedMemfdMemory"
+#define GST_ZED_UDMABUF_ALLOCATOR_NAME "ZedUdmabufMemory"
+
+/* Minimum alignment of the memories, as a `GstAllocationParams` align mask */
+#define GST_ZED_ALLOCATOR_ALIGN 63
+
+/* Counters of the allocator, for all the elements using it */
+typedef struct {
+    guint64 allocations;       // Memories allocated
+    guint64 hugetlb;           // Memories backed by reserved huge pages
+    guint64 bytes;             // Total size mapped [bytes]
+    guint64 faults_avoided;    // Pages pre-faulted at allocation time
+} GstZedAllocatorStats;
+
+/* Process-wide huge page allocator, NULL if not supported. Unref after use. */
+GstAllocator *gst_zed_hugepage_allocator_get(void);
+
+/* Read the counters of `allocator`, returned by `gst_zed_hugepage_allocator_get` */
+void gst_zed_hugepage_allocator_get_stats(GstAllocator *allocator, GstZedAllocatorStats *stats);
+
+/* Process-wide memfd allocator, NULL if not supported. Unref after use. */
+GstAllocator *gst_zed_memfd_allocator_get(void);
+
+/* Process-wide udmabuf allocator, NULL if `/dev/udmabuf` is not available. Unref
+ * after use. */
+GstAllocator *gst_zed_udmabuf_allocator_get(void);
+
+/* Take `caps` and return them preceded by a `memory:DMABuf` copy of their raw video
+ * structures, preferred by the negotiation */
+GstCaps *gst_zed_caps_add_dmabuf(GstCaps *caps);
+
+/* TRUE if `caps1` and `caps2` can intersect, whatever their caps features */
+gboolean gst_zed_caps_can_intersect_any_memory(const GstCaps *caps1, const GstCaps *caps2);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_ALLOCATOR_H_
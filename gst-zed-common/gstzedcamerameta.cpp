@@ -0,0 +1,95 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedcamerameta.h"
+
+GType gst_zed_camera_meta_api_get_type(void) {
+    static gsize type_id = 0;
+    static const gchar *tags[] = {NULL};
+
+    if (g_once_init_enter(&type_id)) {
+        // The static library is linked in each ZED plugin: the first one loaded registers
+        // the type, the others reuse it
+        GType type = g_type_from_name(GST_ZED_CAMERA_META_API_NAME);
+        if (type == 0) {
+            type = gst_meta_api_type_register(GST_ZED_CAMERA_META_API_NAME, tags);
+        }
+        g_once_init_leave(&type_id, type);
+    }
+
+    return type_id;
+}
+
+static gboolean gst_zed_camera_meta_init(GstMeta *meta, gpointer params, GstBuffer *buffer) {
+    GstZedCameraMeta *cmeta = reinterpret_cast<GstZedCameraMeta *>(meta);
+
+    (void) params;
+    (void) buffer;
+    cmeta->state.flags = 0;
+    cmeta->state.exposure_time = -1;
+    cmeta->state.analog_gain = -1;
+    cmeta->state.digital_gain = -1;
+    cmeta->state.white_balance = -1;
+    cmeta->age = 0;
+
+    return TRUE;
+}
+
+static gboolean gst_zed_camera_meta_transform(GstBuffer *transbuf, GstMeta *meta,
+                                              GstBuffer *buffer, GQuark type, gpointer data) {
+    GstZedCameraMeta *cmeta = reinterpret_cast<GstZedCameraMeta *>(meta);
+
+    (void) buffer;
+    (void) type;
+    (void) data;
+
+    // Frame level state: valid for any transformation of the frame
+    return gst_buffer_add_zed_camera_meta(transbuf, &cmeta->state, cmeta->age) != NULL;
+}
+
+const GstMetaInfo *gst_zed_camera_meta_get_info(void) {
+    static const GstMetaInfo *meta_info = NULL;
+
+    if (g_once_init_enter((GstMetaInfo **) &meta_info)) {
+        const GstMetaInfo *info = gst_meta_get_info(GST_ZED_CAMERA_META_IMPL_NAME);
+        if (!info) {
+            info = gst_meta_register(GST_ZED_CAMERA_META_API_TYPE, GST_ZED_CAMERA_META_IMPL_NAME,
+                                     sizeof(GstZedCameraMeta), gst_zed_camera_meta_init, NULL,
+                                     gst_zed_camera_meta_transform);
+        }
+        g_once_init_leave((GstMetaInfo **) &meta_info, (GstMetaInfo *) info);
+    }
+
+    return meta_info;
+}
+
+GstZedCameraMeta *gst_buffer_add_zed_camera_meta(GstBuffer *buffer,
+                                                 const GstZedCameraState *state, guint age) {
+    GstZedCameraMeta *meta = reinterpret_cast<GstZedCameraMeta *>(
+        gst_buffer_add_meta(buffer, GST_ZED_CAMERA_META_INFO, NULL));
+
+    if (meta) {
+        meta->state = *state;
+        meta->age = age;
+    }
+
+    return meta;
+}
@@ -0,0 +1,78 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_CAMERA_META_H_
+#define _GST_ZED_CAMERA_META_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Per-frame state of the camera image controls, as chosen by the auto algorithms
+ * or set manually. The values are read from the camera every few frames only:
+ * `age` tells how many frames ago.
+ *
+ * The API type is registered by name: applications not linking the ZED plugins
+ * retrieve the meta with `gst_buffer_get_meta(buffer,
+ * g_type_from_name(GST_ZED_CAMERA_META_API_NAME))` */
+
+#define GST_ZED_CAMERA_META_API_NAME "GstZedCameraMetaAPI"
+#define GST_ZED_CAMERA_META_IMPL_NAME "GstZedCameraMeta"
+
+typedef enum {
+    GST_ZED_CAMERA_STATE_AUTO_EXPOSURE = (1 << 0),
+    GST_ZED_CAMERA_STATE_AUTO_ANALOG_GAIN = (1 << 1),
+    GST_ZED_CAMERA_STATE_AUTO_DIGITAL_GAIN = (1 << 2),
+    GST_ZED_CAMERA_STATE_AUTO_WHITE_BALANCE = (1 << 3),
+    GST_ZED_CAMERA_STATE_HDR = (1 << 4),
+} GstZedCameraStateFlags;
+
+/* Values are -1 when not reported by the camera */
+typedef struct {
+    guint32 flags;          // `GstZedCameraStateFlags`
+    gint exposure_time;     // Exposure time [usec]
+    gint analog_gain;       // Analog gain [mdB]
+    gint digital_gain;      // Digital gain [1,256]
+    gint white_balance;     // White balance color temperature [K]
+} GstZedCameraState;
+
+typedef struct {
+    GstMeta meta;
+
+    GstZedCameraState state;
+    guint age;   // Frames since the state was read from the camera
+} GstZedCameraMeta;
+
+GType gst_zed_camera_meta_api_get_type(void);
+#define GST_ZED_CAMERA_META_API_TYPE (gst_zed_camera_meta_api_get_type())
+
+const GstMetaInfo *gst_zed_camera_meta_get_info(void);
+#define GST_ZED_CAMERA_META_INFO (gst_zed_camera_meta_get_info())
+
+#define gst_buffer_get_zed_camera_meta(b)                                                          \
+    ((GstZedCameraMeta *) gst_buffer_get_meta((b), GST_ZED_CAMERA_META_API_TYPE))
+
+GstZedCameraMeta *gst_buffer_add_zed_camera_meta(GstBuffer *buffer,
+                                                 const GstZedCameraState *state, guint age);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_CAMERA_META_H_
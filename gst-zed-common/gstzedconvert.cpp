@@ -0,0 +1,426 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedconvert.h"
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GST_ZED_CONVERT_NEON
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define GST_ZED_CONVERT_SSSE3
+#define GST_ZED_SSSE3_TARGET
+#define GST_ZED_HAS_SSSE3() TRUE
+#elif (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+// SSSE3 not enabled by the compiler flags: its kernels are built for it anyway and
+// selected at run time
+#include <tmmintrin.h>
+#define GST_ZED_CONVERT_SSSE3
+#define GST_ZED_SSSE3_TARGET __attribute__((target("ssse3")))
+#define GST_ZED_HAS_SSSE3() __builtin_cpu_supports("ssse3")
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define GST_ZED_COPY_NT_SSE2
+#define GST_ZED_CONVERT_SSE2
+#elif defined(__aarch64__)
+#define GST_ZED_COPY_NT_AARCH64
+#endif
+
+// BT.601 luma coefficients, 7 bits fixed point (sum is 128)
+#define LUMA_B 15
+#define LUMA_G 75
+#define LUMA_R 38
+#define LUMA_SHIFT 7
+
+void gst_zed_copy_plane(const guint8 *src, gsize src_stride, guint8 *dst, gsize dst_stride,
+                        gsize row_bytes, guint height) {
+    if (src_stride == row_bytes && dst_stride == row_bytes) {
+        memcpy(dst, src, row_bytes * height);
+        return;
+    }
+
+    for (guint v = 0; v < height; v++) {
+        memcpy(dst, src, row_bytes);
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+
+/* Copy one row, streaming 64 bytes blocks past the caches */
+static void gst_zed_copy_row_nt(const guint8 *src, guint8 *dst, gsize bytes) {
+#if defined(GST_ZED_COPY_NT_SSE2)
+    // Streaming stores need an aligned destination
+    gsize head = MIN((16 - (reinterpret_cast<guintptr>(dst) & 15)) & 15, bytes);
+    memcpy(dst, src, head);
+    src += head;
+    dst += head;
+    bytes -= head;
+
+    for (; bytes >= 64; bytes -= 64, src += 64, dst += 64) {
+        const __m128i *in = reinterpret_cast<const __m128i *>(src);
+        __m128i *out = reinterpret_cast<__m128i *>(dst);
+        __m128i a = _mm_loadu_si128(in);
+        __m128i b = _mm_loadu_si128(in + 1);
+        __m128i c = _mm_loadu_si128(in + 2);
+        __m128i d = _mm_loadu_si128(in + 3);
+        _mm_stream_si128(out, a);
+        _mm_stream_si128(out + 1, b);
+        _mm_stream_si128(out + 2, c);
+        _mm_stream_si128(out + 3, d);
+    }
+#elif defined(GST_ZED_COPY_NT_AARCH64)
+    for (; bytes >= 64; bytes -= 64, src += 64, dst += 64) {
+        __asm__ volatile("ldp q0, q1, [%0]\n\t"
+                         "ldp q2, q3, [%0, #32]\n\t"
+                         "stnp q0, q1, [%1]\n\t"
+                         "stnp q2, q3, [%1, #32]\n\t"
+                         :
+                         : "r"(src), "r"(dst)
+                         : "v0", "v1", "v2", "v3", "memory");
+    }
+#endif
+
+    memcpy(dst, src, bytes);
+}
+
+void gst_zed_copy_plane_nt(const guint8 *src, gsize src_stride, guint8 *dst, gsize dst_stride,
+                           gsize row_bytes, guint height) {
+    for (guint v = 0; v < height; v++) {
+        gst_zed_copy_row_nt(src, dst, row_bytes);
+        src += src_stride;
+        dst += dst_stride;
+    }
+
+#if defined(GST_ZED_COPY_NT_SSE2)
+    _mm_sfence();   // Streaming stores are weakly ordered
+#endif
+}
+
+#ifdef GST_ZED_CONVERT_SSSE3
+/* SSSE3 part of a BGRA -> BGR/RGB row, returns the number of pixels converted */
+GST_ZED_SSSE3_TARGET static guint gst_zed_bgra_to_3ch_row_ssse3(const guint8 *in, guint8 *out,
+                                                                guint width, gboolean swap) {
+    const __m128i mask =
+        swap ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+             : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    guint u = 0;
+
+    // 4 pixels per iteration, 16 bytes stored for 12 written: stop before the row end
+    for (; u + 6 <= width; u += 4) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4 * u));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 3 * u), _mm_shuffle_epi8(px, mask));
+    }
+    return u;
+}
+
+/* SSSE3 part of a BGRA -> GRAY8 row, returns the number of pixels converted */
+GST_ZED_SSSE3_TARGET static guint gst_zed_bgra_to_gray8_row_ssse3(const guint8 *in, guint8 *out,
+                                                                  guint width) {
+    const __m128i coeffs = _mm_setr_epi8(LUMA_B, LUMA_G, LUMA_R, 0, LUMA_B, LUMA_G, LUMA_R, 0,
+                                         LUMA_B, LUMA_G, LUMA_R, 0, LUMA_B, LUMA_G, LUMA_R, 0);
+    const __m128i round = _mm_set1_epi16(1 << (LUMA_SHIFT - 1));
+    guint u = 0;
+
+    for (; u + 8 <= width; u += 8) {
+        __m128i px0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4 * u));
+        __m128i px1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4 * u + 16));
+        // {B*cb + G*cg, R*cr} pairs, then one sum per pixel
+        __m128i y =
+            _mm_hadd_epi16(_mm_maddubs_epi16(px0, coeffs), _mm_maddubs_epi16(px1, coeffs));
+        y = _mm_srli_epi16(_mm_add_epi16(y, round), LUMA_SHIFT);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + u),
+                         _mm_packus_epi16(y, _mm_setzero_si128()));
+    }
+    return u;
+}
+#endif
+
+/* BGRA -> BGR (`swap` FALSE) or RGB (`swap` TRUE) */
+static void gst_zed_convert_bgra_to_3ch(const guint8 *src, gsize src_stride, guint8 *dst,
+                                        gsize dst_stride, guint width, guint height,
+                                        gboolean swap) {
+    const guint first = swap ? 2 : 0;
+    const guint last = swap ? 0 : 2;
+
+#ifdef GST_ZED_CONVERT_SSSE3
+    const gboolean ssse3 = GST_ZED_HAS_SSSE3();
+#endif
+
+    for (guint v = 0; v < height; v++) {
+        const guint8 *in = src + v * src_stride;
+        guint8 *out = dst + v * dst_stride;
+        guint u = 0;
+
+#if defined(GST_ZED_CONVERT_NEON)
+        for (; u + 16 <= width; u += 16) {
+            uint8x16x4_t px = vld4q_u8(in + 4 * u);
+            uint8x16x3_t res;
+            res.val[0] = px.val[first];
+            res.val[1] = px.val[1];
+            res.val[2] = px.val[last];
+            vst3q_u8(out + 3 * u, res);
+        }
+#elif defined(GST_ZED_CONVERT_SSSE3)
+        if (ssse3) {
+            u = gst_zed_bgra_to_3ch_row_ssse3(in, out, width, swap);
+        }
+#endif
+
+        for (; u < width; u++) {
+            out[3 * u] = in[4 * u + first];
+            out[3 * u + 1] = in[4 * u + 1];
+            out[3 * u + 2] = in[4 * u + last];
+        }
+    }
+}
+
+void gst_zed_convert_bgra_to_bgr(const guint8 *src, gsize src_stride, guint8 *dst,
+                                 gsize dst_stride, guint width, guint height) {
+    gst_zed_convert_bgra_to_3ch(src, src_stride, dst, dst_stride, width, height, FALSE);
+}
+
+void gst_zed_convert_bgra_to_rgb(const guint8 *src, gsize src_stride, guint8 *dst,
+                                 gsize dst_stride, guint width, guint height) {
+    gst_zed_convert_bgra_to_3ch(src, src_stride, dst, dst_stride, width, height, TRUE);
+}
+
+void gst_zed_convert_bgra_to_gray8(const guint8 *src, gsize src_stride, guint8 *dst,
+                                   gsize dst_stride, guint width, guint height) {
+#ifdef GST_ZED_CONVERT_SSSE3
+    const gboolean ssse3 = GST_ZED_HAS_SSSE3();
+#endif
+
+    for (guint v = 0; v < height; v++) {
+        const guint8 *in = src + v * src_stride;
+        guint8 *out = dst + v * dst_stride;
+        guint u = 0;
+
+#if defined(GST_ZED_CONVERT_NEON)
+        for (; u + 8 <= width; u += 8) {
+            uint8x8x4_t px = vld4_u8(in + 4 * u);
+            uint16x8_t y = vmull_u8(px.val[0], vdup_n_u8(LUMA_B));
+            y = vmlal_u8(y, px.val[1], vdup_n_u8(LUMA_G));
+            y = vmlal_u8(y, px.val[2], vdup_n_u8(LUMA_R));
+            vst1_u8(out + u, vrshrn_n_u16(y, LUMA_SHIFT));
+        }
+#elif defined(GST_ZED_CONVERT_SSSE3)
+        if (ssse3) {
+            u = gst_zed_bgra_to_gray8_row_ssse3(in, out, width);
+        }
+#endif
+
+        for (; u < width; u++) {
+            out[u] = static_cast<guint8>((LUMA_B * in[4 * u] + LUMA_G * in[4 * u + 1] +
+                                          LUMA_R * in[4 * u + 2] + (1 << (LUMA_SHIFT - 1))) >>
+                                         LUMA_SHIFT);
+        }
+    }
+}
+
+// ----> Measures
+
+/* Copy the 4 floats of a point */
+static inline void gst_zed_copy_point(float *out, const float *pt) {
+#if defined(GST_ZED_CONVERT_NEON)
+    vst1q_f32(out, vld1q_f32(pt));
+#elif defined(GST_ZED_CONVERT_SSE2)
+    _mm_storeu_ps(out, _mm_loadu_ps(pt));
+#else
+    memcpy(out, pt, 4 * sizeof(float));
+#endif
+}
+
+void gst_zed_convert_points(const guint8 *src, gsize src_stride, guint8 *dst, guint width,
+                            guint height, guint step, gboolean xyz) {
+    float *out = reinterpret_cast<float *>(dst);
+
+    for (guint v = 0; v < height; v += step) {
+        const float *pt = reinterpret_cast<const float *>(src + v * src_stride);
+        const float *row_end = pt + 4 * width;
+
+        if (xyz) {
+            // 4 floats stored for 3 written, the fourth one being overwritten by the next
+            // point: the last point of the row is not to write past the row end
+            for (; pt + 4 * step < row_end; pt += 4 * step) {
+                gst_zed_copy_point(out, pt);
+                out += 3;
+            }
+            out[0] = pt[0];
+            out[1] = pt[1];
+            out[2] = pt[2];
+            out += 3;
+        } else {
+            for (; pt < row_end; pt += 4 * step) {
+                gst_zed_copy_point(out, pt);
+                out += 4;
+            }
+        }
+    }
+}
+
+void gst_zed_convert_confidence_to_gray8(const guint8 *src, gsize src_stride, guint8 *dst,
+                                         gsize dst_stride, guint width, guint height) {
+#if defined(GST_ZED_CONVERT_NEON)
+    const float32x4_t scale = vdupq_n_f32(2.55f);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t max = vdupq_n_f32(255.f);
+#elif defined(GST_ZED_CONVERT_SSE2)
+    const __m128 scale = _mm_set1_ps(2.55f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 max = _mm_set1_ps(255.f);
+#endif
+
+    for (guint v = 0; v < height; v++) {
+        const float *in = reinterpret_cast<const float *>(src + v * src_stride);
+        guint8 *out = dst + v * dst_stride;
+        guint u = 0;
+
+        // NaN values fail the comparison and are saturated as in the scalar code
+#if defined(GST_ZED_CONVERT_NEON)
+        for (; u + 8 <= width; u += 8) {
+            float32x4_t a = vaddq_f32(vmulq_f32(vld1q_f32(in + u), scale), half);
+            float32x4_t b = vaddq_f32(vmulq_f32(vld1q_f32(in + u + 4), scale), half);
+            a = vbslq_f32(vcltq_f32(a, max), a, max);
+            b = vbslq_f32(vcltq_f32(b, max), b, max);
+            uint16x8_t y = vcombine_u16(vmovn_u32(vcvtq_u32_f32(a)), vmovn_u32(vcvtq_u32_f32(b)));
+            vst1_u8(out + u, vmovn_u16(y));
+        }
+#elif defined(GST_ZED_CONVERT_SSE2)
+        for (; u + 16 <= width; u += 16) {
+            __m128i q[4];
+            for (guint k = 0; k < 4; k++) {
+                __m128 val = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + u + 4 * k), scale), half);
+                __m128 below = _mm_cmplt_ps(val, max);
+                val = _mm_or_ps(_mm_and_ps(below, val), _mm_andnot_ps(below, max));
+                q[k] = _mm_cvttps_epi32(val);
+            }
+            __m128i y = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + u), y);
+        }
+#endif
+
+        for (; u < width; u++) {
+            float val = in[u] * 2.55f + 0.5f;
+            out[u] = static_cast<guint8>(val < 255.f ? val : 255.f);
+        }
+    }
+}
+
+void gst_zed_convert_disparity_to_gray16(const guint8 *src, gsize src_stride, guint8 *dst,
+                                         gsize dst_stride, guint width, guint height,
+                                         float scale) {
+#if defined(GST_ZED_CONVERT_NEON)
+    const float32x4_t k = vdupq_n_f32(scale);
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const float32x4_t max = vdupq_n_f32(65535.f);
+#elif defined(GST_ZED_CONVERT_SSE2)
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 k = _mm_set1_ps(scale);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max = _mm_set1_ps(65535.f);
+    // No unsigned 32 -> 16 bits saturation in SSE2: packed as signed around 32768
+    const __m128i bias = _mm_set1_epi32(32768);
+    const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+#endif
+
+    for (guint v = 0; v < height; v++) {
+        const float *in = reinterpret_cast<const float *>(src + v * src_stride);
+        guint16 *out = reinterpret_cast<guint16 *>(dst + v * dst_stride);
+        guint u = 0;
+
+#if defined(GST_ZED_CONVERT_NEON)
+        for (; u + 8 <= width; u += 8) {
+            float32x4_t a = vaddq_f32(vmulq_f32(vabsq_f32(vld1q_f32(in + u)), k), half);
+            float32x4_t b = vaddq_f32(vmulq_f32(vabsq_f32(vld1q_f32(in + u + 4)), k), half);
+            uint32x4_t ia = vandq_u32(vcvtq_u32_f32(a),
+                                      vandq_u32(vcgeq_f32(a, zero), vcltq_f32(a, max)));
+            uint32x4_t ib = vandq_u32(vcvtq_u32_f32(b),
+                                      vandq_u32(vcgeq_f32(b, zero), vcltq_f32(b, max)));
+            vst1q_u16(out + u, vcombine_u16(vmovn_u32(ia), vmovn_u32(ib)));
+        }
+#elif defined(GST_ZED_CONVERT_SSE2)
+        for (; u + 8 <= width; u += 8) {
+            __m128i w[2];
+            for (guint i = 0; i < 2; i++) {
+                __m128 val = _mm_and_ps(_mm_loadu_ps(in + u + 4 * i), abs_mask);
+                val = _mm_add_ps(_mm_mul_ps(val, k), half);
+                __m128 valid = _mm_and_ps(_mm_cmpge_ps(val, zero), _mm_cmplt_ps(val, max));
+                __m128i d = _mm_and_si128(_mm_cvttps_epi32(val), _mm_castps_si128(valid));
+                w[i] = _mm_sub_epi32(d, bias);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + u),
+                             _mm_xor_si128(_mm_packs_epi32(w[0], w[1]), bias16));
+        }
+#endif
+
+        for (; u < width; u++) {
+            float val = (in[u] < 0.f ? -in[u] : in[u]) * scale + 0.5f;
+            // NaN and infinite values fail the range check
+            out[u] = (val >= 0.f && val < 65535.f) ? static_cast<guint16>(val) : 0;
+        }
+    }
+}
+
+void gst_zed_mask_depth_gray16(const guint8 *depth, gsize depth_stride, const guint8 *conf,
+                               gsize conf_stride, guint8 *dst, gsize dst_stride, guint width,
+                               guint height, float max_conf) {
+#if defined(GST_ZED_CONVERT_NEON)
+    const float32x4_t max = vdupq_n_f32(max_conf);
+#elif defined(GST_ZED_CONVERT_SSE2)
+    const __m128 max = _mm_set1_ps(max_conf);
+#endif
+
+    for (guint v = 0; v < height; v++) {
+        const guint16 *in = reinterpret_cast<const guint16 *>(depth + v * depth_stride);
+        const float *c = reinterpret_cast<const float *>(conf + v * conf_stride);
+        guint16 *out = reinterpret_cast<guint16 *>(dst + v * dst_stride);
+        guint u = 0;
+
+        // Selected with the comparison masks, narrowed to 16 bits
+#if defined(GST_ZED_CONVERT_NEON)
+        for (; u + 8 <= width; u += 8) {
+            uint16x8_t keep = vcombine_u16(vmovn_u32(vcleq_f32(vld1q_f32(c + u), max)),
+                                           vmovn_u32(vcleq_f32(vld1q_f32(c + u + 4), max)));
+            vst1q_u16(out + u, vandq_u16(vld1q_u16(in + u), keep));
+        }
+#elif defined(GST_ZED_CONVERT_SSE2)
+        for (; u + 8 <= width; u += 8) {
+            __m128i keep =
+                _mm_packs_epi32(_mm_castps_si128(_mm_cmple_ps(_mm_loadu_ps(c + u), max)),
+                                _mm_castps_si128(_mm_cmple_ps(_mm_loadu_ps(c + u + 4), max)));
+            __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + u));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + u), _mm_and_si128(d, keep));
+        }
+#endif
+
+        for (; u < width; u++) {
+            out[u] = (c[u] <= max_conf) ? in[u] : 0;
+        }
+    }
+}
+
+// <---- Measures
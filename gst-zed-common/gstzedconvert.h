@@ -0,0 +1,90 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_CONVERT_H_
+#define _GST_ZED_CONVERT_H_
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Pixel conversion kernels shared by the ZED source elements, used while copying
+ * the retrieved `sl::Mat` into the output buffer. Each function processes a
+ * `width`x`height` area; strides are in bytes and may include padding.
+ *
+ * NEON (Jetson) and SSE2 code paths are used when the compiler targets them, a
+ * scalar implementation otherwise. On x86 the SSSE3 paths are built even without
+ * `-mssse3` and selected at run time when the CPU supports them. */
+
+/* Signature shared by the conversion kernels below */
+typedef void (*GstZedConvertFunc)(const guint8 *src, gsize src_stride, guint8 *dst,
+                                  gsize dst_stride, guint width, guint height);
+
+/* Copy `height` rows of `row_bytes` bytes */
+void gst_zed_copy_plane(const guint8 *src, gsize src_stride, guint8 *dst, gsize dst_stride,
+                        gsize row_bytes, guint height);
+
+/* Same as `gst_zed_copy_plane`, with non-temporal stores on SSE2 and AArch64: frames
+ * larger than the caches are written without evicting the data in use */
+void gst_zed_copy_plane_nt(const guint8 *src, gsize src_stride, guint8 *dst, gsize dst_stride,
+                           gsize row_bytes, guint height);
+
+/* Drop the alpha channel: BGRA -> BGR */
+void gst_zed_convert_bgra_to_bgr(const guint8 *src, gsize src_stride, guint8 *dst,
+                                 gsize dst_stride, guint width, guint height);
+
+/* Drop the alpha channel and swap red and blue: BGRA -> RGB */
+void gst_zed_convert_bgra_to_rgb(const guint8 *src, gsize src_stride, guint8 *dst,
+                                 gsize dst_stride, guint width, guint height);
+
+/* BT.601 luma: BGRA -> GRAY8 */
+void gst_zed_convert_bgra_to_gray8(const guint8 *src, gsize src_stride, guint8 *dst,
+                                   gsize dst_stride, guint width, guint height);
+
+// ----> Measures
+
+/* Pack the F32_C4 points of the area, keeping one point every `step` along rows and
+ * columns, into contiguous rows. With `xyz` the fourth channel (packed color) is
+ * dropped. */
+void gst_zed_convert_points(const guint8 *src, gsize src_stride, guint8 *dst, guint width,
+                            guint height, guint step, gboolean xyz);
+
+/* F32 confidence [0-100] -> GRAY8 [0-255] */
+void gst_zed_convert_confidence_to_gray8(const guint8 *src, gsize src_stride, guint8 *dst,
+                                         gsize dst_stride, guint width, guint height);
+
+/* F32 disparity -> unsigned fixed point GRAY16, `|d| * scale` rounded. The values out
+ * of range, NaN and infinite ones included, are set to 0. */
+void gst_zed_convert_disparity_to_gray16(const guint8 *src, gsize src_stride, guint8 *dst,
+                                         gsize dst_stride, guint width, guint height,
+                                         float scale);
+
+/* U16 depth with the pixels whose F32 confidence is above `max_conf` (less reliable)
+ * set to 0 */
+void gst_zed_mask_depth_gray16(const guint8 *depth, gsize depth_stride, const guint8 *conf,
+                               gsize conf_stride, guint8 *dst, gsize dst_stride, guint width,
+                               guint height, float max_conf);
+
+// <---- Measures
+
+G_END_DECLS
+
+#endif   // _GST_ZED_CONVERT_H_
@@ -0,0 +1,333 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedcopyengine.h"
+#include "gstzedscale.h"
+
+// Slices smaller than this are not worth waking a worker
+#define MIN_SLICE_ROWS 16
+
+// Copies larger than this use non-temporal stores [bytes]
+#define NT_MIN_BYTES (4 * 1024 * 1024)
+
+// Rows written between two image statistics passes, small enough to stay in the L2 cache
+#define STATS_CHUNK_ROWS 8
+
+struct _GstZedCopyEngine {
+    guint n_threads;   // Threads processing the slices, including the caller
+    GThread **workers;
+
+    GMutex lock;
+    GCond work_cond;   // New job or exit request
+    GCond done_cond;   // Last worker done with the job
+
+    // ----> Current job, under the lock
+    guint64 job_id;          // Incremented for each job
+    gboolean quit;
+    GstZedSliceFunc func;
+    gpointer user_data;
+    guint n_rows;
+    guint slice_rows;
+    guint n_slices;
+    gint next_slice;         // Next slice to process [atomic]
+    guint busy_workers;      // Workers still processing the job
+    // <---- Current job
+};
+
+/* Process the slices of the current job until none is left */
+static void gst_zed_copy_engine_process(GstZedCopyEngine *engine) {
+    guint slice;
+
+    while ((slice = g_atomic_int_add(&engine->next_slice, 1)) < engine->n_slices) {
+        guint first = slice * engine->slice_rows;
+        engine->func(engine->user_data, first, MIN(engine->slice_rows, engine->n_rows - first));
+    }
+}
+
+static gpointer gst_zed_copy_engine_worker(gpointer data) {
+    GstZedCopyEngine *engine = static_cast<GstZedCopyEngine *>(data);
+    guint64 done_id = 0;
+
+    g_mutex_lock(&engine->lock);
+    while (TRUE) {
+        while (!engine->quit && engine->job_id == done_id) {
+            g_cond_wait(&engine->work_cond, &engine->lock);
+        }
+        if (engine->quit) {
+            break;
+        }
+        done_id = engine->job_id;
+        g_mutex_unlock(&engine->lock);
+
+        gst_zed_copy_engine_process(engine);
+
+        g_mutex_lock(&engine->lock);
+        if (--engine->busy_workers == 0) {
+            g_cond_signal(&engine->done_cond);
+        }
+    }
+    g_mutex_unlock(&engine->lock);
+
+    return NULL;
+}
+
+GstZedCopyEngine *gst_zed_copy_engine_new(guint n_threads) {
+    GstZedCopyEngine *engine = g_new0(GstZedCopyEngine, 1);
+
+    if (n_threads == 0) {
+        n_threads = CLAMP(g_get_num_processors(), 1, GST_ZED_COPY_ENGINE_AUTO_MAX_THREADS);
+    }
+    engine->n_threads = n_threads;
+
+    g_mutex_init(&engine->lock);
+    g_cond_init(&engine->work_cond);
+    g_cond_init(&engine->done_cond);
+
+    engine->workers = g_new0(GThread *, n_threads);
+    for (guint i = 0; i + 1 < n_threads; i++) {
+        engine->workers[i] = g_thread_new("zedcopy", gst_zed_copy_engine_worker, engine);
+    }
+
+    return engine;
+}
+
+void gst_zed_copy_engine_free(GstZedCopyEngine *engine) {
+    if (!engine) {
+        return;
+    }
+
+    g_mutex_lock(&engine->lock);
+    engine->quit = TRUE;
+    g_cond_broadcast(&engine->work_cond);
+    g_mutex_unlock(&engine->lock);
+
+    for (guint i = 0; i + 1 < engine->n_threads; i++) {
+        g_thread_join(engine->workers[i]);
+    }
+    g_free(engine->workers);
+
+    g_cond_clear(&engine->done_cond);
+    g_cond_clear(&engine->work_cond);
+    g_mutex_clear(&engine->lock);
+    g_free(engine);
+}
+
+guint gst_zed_copy_engine_get_n_threads(GstZedCopyEngine *engine) {
+    return engine ? engine->n_threads : 1;
+}
+
+void gst_zed_copy_engine_run(GstZedCopyEngine *engine, guint n_rows, GstZedSliceFunc func,
+                             gpointer user_data) {
+    guint n_slices = engine ? MIN(engine->n_threads, n_rows / MIN_SLICE_ROWS) : 1;
+
+    if (n_slices <= 1) {
+        if (n_rows > 0) {
+            func(user_data, 0, n_rows);
+        }
+        return;
+    }
+
+    // ----> Wake the workers
+    g_mutex_lock(&engine->lock);
+    engine->func = func;
+    engine->user_data = user_data;
+    engine->n_rows = n_rows;
+    engine->slice_rows = (n_rows + n_slices - 1) / n_slices;
+    engine->n_slices = (n_rows + engine->slice_rows - 1) / engine->slice_rows;
+    engine->next_slice = 0;
+    engine->busy_workers = engine->n_threads - 1;
+    engine->job_id++;
+    g_cond_broadcast(&engine->work_cond);
+    g_mutex_unlock(&engine->lock);
+    // <---- Wake the workers
+
+    gst_zed_copy_engine_process(engine);
+
+    // The job data lives on the caller stack: wait for every worker to leave it
+    g_mutex_lock(&engine->lock);
+    while (engine->busy_workers > 0) {
+        g_cond_wait(&engine->done_cond, &engine->lock);
+    }
+    g_mutex_unlock(&engine->lock);
+}
+
+// ----> Sliced kernels
+typedef struct {
+    const guint8 *src;
+    gsize src_stride;
+    guint src_w;
+    guint src_h;
+    guint channels;
+    guint8 *dst;
+    gsize dst_stride;
+    gsize row_bytes;   // Plane copy only
+    guint dst_w;
+    guint dst_h;
+    GstZedConvertFunc convert;
+    GstZedSliceFunc kernel;              // Image statistics only: kernel writing the rows
+    GstZedImageStatsAccumulator *stats;
+} GstZedCopyJob;
+
+static void gst_zed_copy_plane_slice(gpointer data, guint first_row, guint n_rows) {
+    const GstZedCopyJob *job = static_cast<const GstZedCopyJob *>(data);
+    const guint8 *src = job->src + first_row * job->src_stride;
+    guint8 *dst = job->dst + first_row * job->dst_stride;
+
+    if (job->stats) {
+        // Read back right away: keep the rows in the caches
+        gst_zed_copy_plane(src, job->src_stride, dst, job->dst_stride, job->row_bytes, n_rows);
+    } else {
+        gst_zed_copy_plane_nt(src, job->src_stride, dst, job->dst_stride, job->row_bytes, n_rows);
+    }
+}
+
+static void gst_zed_copy_convert_slice(gpointer data, guint first_row, guint n_rows) {
+    const GstZedCopyJob *job = static_cast<const GstZedCopyJob *>(data);
+
+    job->convert(job->src + first_row * job->src_stride, job->src_stride,
+                 job->dst + first_row * job->dst_stride, job->dst_stride, job->dst_w, n_rows);
+}
+
+static void gst_zed_copy_scale_slice(gpointer data, guint first_row, guint n_rows) {
+    const GstZedCopyJob *job = static_cast<const GstZedCopyJob *>(data);
+
+    gst_zed_scale_image_rows(job->src, job->src_stride, job->src_w, job->src_h, job->channels,
+                             job->dst, job->dst_stride, job->dst_w, job->dst_h, job->convert,
+                             first_row, n_rows);
+}
+
+/* Run the job kernel by chunks of rows, each followed by the statistics of its rows */
+static void gst_zed_copy_stats_slice(gpointer data, guint first_row, guint n_rows) {
+    GstZedCopyJob *job = static_cast<GstZedCopyJob *>(data);
+    GstZedImageStatsSlice slice;
+
+    gst_zed_image_stats_slice_init(&slice, job->stats, job->dst_w);
+    for (guint done = 0; done < n_rows; done += STATS_CHUNK_ROWS) {
+        guint row = first_row + done;
+        guint rows = MIN(STATS_CHUNK_ROWS, n_rows - done);
+
+        job->kernel(job, row, rows);
+        gst_zed_image_stats_slice_add_rows(&slice, job->dst + row * job->dst_stride,
+                                           job->dst_stride, rows);
+    }
+    gst_zed_image_stats_slice_flush(&slice);
+}
+
+static void gst_zed_copy_job_run(GstZedCopyEngine *engine, GstZedCopyJob *job, guint n_rows,
+                                 GstZedSliceFunc kernel) {
+    if (job->stats) {
+        job->kernel = kernel;
+        gst_zed_copy_engine_run(engine, n_rows, gst_zed_copy_stats_slice, job);
+    } else {
+        gst_zed_copy_engine_run(engine, n_rows, kernel, job);
+    }
+}
+// <---- Sliced kernels
+
+void gst_zed_copy_engine_copy_plane(GstZedCopyEngine *engine, const guint8 *src, gsize src_stride,
+                                    guint8 *dst, gsize dst_stride, gsize row_bytes, guint height) {
+    if (row_bytes * height < NT_MIN_BYTES) {
+        // Small enough to stay in the caches: faster as one plain copy
+        gst_zed_copy_plane(src, src_stride, dst, dst_stride, row_bytes, height);
+        return;
+    }
+
+    GstZedCopyJob job = {};
+    job.src = src;
+    job.src_stride = src_stride;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+    job.row_bytes = row_bytes;
+    gst_zed_copy_engine_run(engine, height, gst_zed_copy_plane_slice, &job);
+}
+
+void gst_zed_copy_engine_convert(GstZedCopyEngine *engine, GstZedConvertFunc convert,
+                                 const guint8 *src, gsize src_stride, guint8 *dst,
+                                 gsize dst_stride, guint width, guint height) {
+    GstZedCopyJob job = {};
+    job.src = src;
+    job.src_stride = src_stride;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+    job.dst_w = width;
+    job.convert = convert;
+    gst_zed_copy_engine_run(engine, height, gst_zed_copy_convert_slice, &job);
+}
+
+void gst_zed_copy_engine_scale(GstZedCopyEngine *engine, const guint8 *src, gsize src_stride,
+                               guint src_w, guint src_h, guint channels, guint8 *dst,
+                               gsize dst_stride, guint dst_w, guint dst_h,
+                               GstZedConvertFunc convert) {
+    GstZedCopyJob job = {};
+    job.src = src;
+    job.src_stride = src_stride;
+    job.src_w = src_w;
+    job.src_h = src_h;
+    job.channels = channels;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+    job.dst_w = dst_w;
+    job.dst_h = dst_h;
+    job.convert = convert;
+    gst_zed_copy_engine_run(engine, dst_h, gst_zed_copy_scale_slice, &job);
+}
+
+void gst_zed_copy_engine_copy_image(GstZedCopyEngine *engine, const guint8 *src,
+                                    gsize src_stride, guint src_w, guint src_h, guint channels,
+                                    guint8 *dst, gsize dst_stride, guint dst_w, guint dst_h,
+                                    GstZedConvertFunc convert,
+                                    GstZedImageStatsAccumulator *stats) {
+    if (!stats) {
+        if (src_w != dst_w || src_h != dst_h) {
+            gst_zed_copy_engine_scale(engine, src, src_stride, src_w, src_h, channels, dst,
+                                      dst_stride, dst_w, dst_h, convert);
+        } else if (convert) {
+            gst_zed_copy_engine_convert(engine, convert, src, src_stride, dst, dst_stride, dst_w,
+                                        dst_h);
+        } else {
+            gst_zed_copy_engine_copy_plane(engine, src, src_stride, dst, dst_stride,
+                                           dst_w * channels, dst_h);
+        }
+        return;
+    }
+
+    GstZedCopyJob job = {};
+    job.src = src;
+    job.src_stride = src_stride;
+    job.src_w = src_w;
+    job.src_h = src_h;
+    job.channels = channels;
+    job.dst = dst;
+    job.dst_stride = dst_stride;
+    job.row_bytes = dst_w * channels;
+    job.dst_w = dst_w;
+    job.dst_h = dst_h;
+    job.convert = convert;
+    job.stats = stats;
+
+    if (src_w != dst_w || src_h != dst_h) {
+        gst_zed_copy_job_run(engine, &job, dst_h, gst_zed_copy_scale_slice);
+    } else if (convert) {
+        gst_zed_copy_job_run(engine, &job, dst_h, gst_zed_copy_convert_slice);
+    } else {
+        gst_zed_copy_job_run(engine, &job, dst_h, gst_zed_copy_plane_slice);
+    }
+}
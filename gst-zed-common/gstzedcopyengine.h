@@ -0,0 +1,85 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_COPY_ENGINE_H_
+#define _GST_ZED_COPY_ENGINE_H_
+
+#include <glib.h>
+
+#include "gstzedconvert.h"
+#include "gstzedimagestats.h"
+
+G_BEGIN_DECLS
+
+/* Persistent worker pool splitting the per-frame copies and conversions of the ZED
+ * source elements into row slices. The calling thread processes a slice too and
+ * returns once every slice is done. The workers inherit the scheduling and the CPU
+ * affinity of the thread creating the engine.
+ *
+ * A NULL engine is valid: the work is then done by the calling thread alone. */
+
+typedef struct _GstZedCopyEngine GstZedCopyEngine;
+
+/* Number of threads used when 0 is requested, the copies being memory bound */
+#define GST_ZED_COPY_ENGINE_AUTO_MAX_THREADS 4
+
+/* Process the `n_rows` rows starting at `first_row` */
+typedef void (*GstZedSliceFunc)(gpointer user_data, guint first_row, guint n_rows);
+
+/* Create an engine of `n_threads` threads, including the caller. 0 picks the number
+ * of CPUs, up to `GST_ZED_COPY_ENGINE_AUTO_MAX_THREADS` */
+GstZedCopyEngine *gst_zed_copy_engine_new(guint n_threads);
+
+void gst_zed_copy_engine_free(GstZedCopyEngine *engine);
+
+guint gst_zed_copy_engine_get_n_threads(GstZedCopyEngine *engine);
+
+/* Call `func` on slices covering `n_rows` rows, in parallel */
+void gst_zed_copy_engine_run(GstZedCopyEngine *engine, guint n_rows, GstZedSliceFunc func,
+                             gpointer user_data);
+
+/* Sliced `gst_zed_copy_plane`, with non-temporal stores for frames larger than the caches */
+void gst_zed_copy_engine_copy_plane(GstZedCopyEngine *engine, const guint8 *src, gsize src_stride,
+                                    guint8 *dst, gsize dst_stride, gsize row_bytes, guint height);
+
+/* Sliced conversion kernel, see `gstzedconvert.h` */
+void gst_zed_copy_engine_convert(GstZedCopyEngine *engine, GstZedConvertFunc convert,
+                                 const guint8 *src, gsize src_stride, guint8 *dst,
+                                 gsize dst_stride, guint width, guint height);
+
+/* Sliced `gst_zed_scale_image` */
+void gst_zed_copy_engine_scale(GstZedCopyEngine *engine, const guint8 *src, gsize src_stride,
+                               guint src_w, guint src_h, guint channels, guint8 *dst,
+                               gsize dst_stride, guint dst_w, guint dst_h,
+                               GstZedConvertFunc convert);
+
+/* Copy a `src_w`x`src_h` image of `channels` bytes pixels into the `dst_w`x`dst_h` area of
+ * `dst`, scaling it and converting it with `convert` when not NULL, with the cheapest of
+ * the kernels above. With `stats`, each slice adds the statistics of the rows it writes */
+void gst_zed_copy_engine_copy_image(GstZedCopyEngine *engine, const guint8 *src,
+                                    gsize src_stride, guint src_w, guint src_h, guint channels,
+                                    guint8 *dst, gsize dst_stride, guint dst_w, guint dst_h,
+                                    GstZedConvertFunc convert,
+                                    GstZedImageStatsAccumulator *stats);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_COPY_ENGINE_H_
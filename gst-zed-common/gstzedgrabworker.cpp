@@ -0,0 +1,171 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedgrabworker.h"
+
+typedef enum {
+    GRAB_IDLE,        // No grab requested
+    GRAB_REQUESTED,   // Waiting for the worker
+    GRAB_RUNNING,     // In the grab function
+    GRAB_DONE,        // Result not consumed yet
+} GstZedGrabState;
+
+struct _GstZedGrabWorker {
+    GThread *thread;
+    GstZedGrabFunc func;
+    gpointer user_data;
+    GDestroyNotify destroy;
+
+    GMutex lock;
+    GCond cond;   // Any change of the fields below
+
+    // ----> Under the lock
+    GstZedGrabState state;
+    gint ret;                 // Result of the last grab
+    guint generation;         // Incremented by each flush
+    guint grab_generation;    // `generation` when the last grab was requested
+    gboolean flushing;        // Waits of the streaming thread interrupted
+    gboolean quit;
+    gboolean abandoned;       // Stop timed out: the worker frees itself
+    // <---- Under the lock
+};
+
+static void gst_zed_grab_worker_destroy(GstZedGrabWorker *worker) {
+    if (worker->destroy) {
+        worker->destroy(worker->user_data);
+    }
+    g_mutex_clear(&worker->lock);
+    g_cond_clear(&worker->cond);
+    g_free(worker);
+}
+
+static gpointer gst_zed_grab_worker_thread(gpointer data) {
+    GstZedGrabWorker *worker = static_cast<GstZedGrabWorker *>(data);
+
+    g_mutex_lock(&worker->lock);
+    while (TRUE) {
+        while (!worker->quit && worker->state != GRAB_REQUESTED) {
+            g_cond_wait(&worker->cond, &worker->lock);
+        }
+        if (worker->quit) {
+            break;
+        }
+        worker->state = GRAB_RUNNING;
+        g_mutex_unlock(&worker->lock);
+
+        gint ret = worker->func(worker->user_data);
+
+        g_mutex_lock(&worker->lock);
+        worker->ret = ret;
+        worker->state = GRAB_DONE;
+        g_cond_broadcast(&worker->cond);
+    }
+    gboolean abandoned = worker->abandoned;
+    g_mutex_unlock(&worker->lock);
+
+    if (abandoned) {
+        gst_zed_grab_worker_destroy(worker);
+    }
+
+    return NULL;
+}
+
+GstZedGrabWorker *gst_zed_grab_worker_new(const gchar *name, GstZedGrabFunc func,
+                                          gpointer user_data, GDestroyNotify destroy) {
+    GstZedGrabWorker *worker = g_new0(GstZedGrabWorker, 1);
+
+    worker->func = func;
+    worker->user_data = user_data;
+    worker->destroy = destroy;
+    worker->state = GRAB_IDLE;
+    g_mutex_init(&worker->lock);
+    g_cond_init(&worker->cond);
+
+    worker->thread = g_thread_new(name, gst_zed_grab_worker_thread, worker);
+
+    return worker;
+}
+
+gboolean gst_zed_grab_worker_free(GstZedGrabWorker *worker, gint64 timeout) {
+    gint64 end_time = g_get_monotonic_time() + timeout;
+
+    g_mutex_lock(&worker->lock);
+    worker->quit = TRUE;
+    g_cond_broadcast(&worker->cond);
+
+    while (worker->state == GRAB_RUNNING) {
+        if (!g_cond_wait_until(&worker->cond, &worker->lock, end_time)) {
+            break;
+        }
+    }
+    worker->abandoned = (worker->state == GRAB_RUNNING);
+    gboolean abandoned = worker->abandoned;
+    GThread *thread = worker->thread;   // `worker` may be freed once unlocked
+    g_mutex_unlock(&worker->lock);
+
+    if (abandoned) {
+        g_thread_unref(thread);
+        return FALSE;
+    }
+
+    g_thread_join(thread);
+    gst_zed_grab_worker_destroy(worker);
+
+    return TRUE;
+}
+
+GstZedGrabResult gst_zed_grab_worker_grab(GstZedGrabWorker *worker, gint *ret) {
+    GstZedGrabResult result = GST_ZED_GRAB_FLUSHING;
+
+    g_mutex_lock(&worker->lock);
+    while (!worker->flushing) {
+        if (worker->state == GRAB_IDLE) {
+            worker->state = GRAB_REQUESTED;
+            worker->grab_generation = worker->generation;
+            g_cond_broadcast(&worker->cond);
+        } else if (worker->state == GRAB_DONE) {
+            worker->state = GRAB_IDLE;
+            if (worker->grab_generation == worker->generation) {
+                *ret = worker->ret;
+                result = GST_ZED_GRAB_DONE;
+                break;
+            }
+            continue;   // Grabbed before the last flush: the frame is dropped
+        }
+        g_cond_wait(&worker->cond, &worker->lock);
+    }
+    g_mutex_unlock(&worker->lock);
+
+    return result;
+}
+
+void gst_zed_grab_worker_set_flushing(GstZedGrabWorker *worker, gboolean flushing) {
+    g_mutex_lock(&worker->lock);
+    worker->flushing = flushing;
+    if (flushing) {
+        worker->generation++;
+        if (worker->state == GRAB_REQUESTED) {
+            worker->state = GRAB_IDLE;   // Not started yet: no stale frame grabbed
+        }
+    }
+    g_cond_broadcast(&worker->cond);
+    g_mutex_unlock(&worker->lock);
+}
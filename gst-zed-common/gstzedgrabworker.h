@@ -0,0 +1,67 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_GRAB_WORKER_H_
+#define _GST_ZED_GRAB_WORKER_H_
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Thread grabbing the camera frames on behalf of the streaming thread of the ZED
+ * source elements. The streaming thread waits for each frame on a condition that
+ * `gst_zed_grab_worker_set_flushing` interrupts, so that a flush or a state change
+ * never waits for a stalled grab to time out in the SDK.
+ *
+ * A grab interrupted by a flush keeps running, but its frame is stale: its result
+ * is dropped and the next `gst_zed_grab_worker_grab` call waits for a new grab. The
+ * grab function only gets `user_data`, owned by the worker, which may outlive the
+ * element when a blocked grab is abandoned. The worker inherits the scheduling and
+ * the CPU affinity of the thread creating it. */
+
+typedef struct _GstZedGrabWorker GstZedGrabWorker;
+
+/* Grab one frame, called from the worker thread. Returns the SDK error code. */
+typedef gint (*GstZedGrabFunc)(gpointer user_data);
+
+typedef enum {
+    GST_ZED_GRAB_DONE,       // `*ret` holds the result of the grab function
+    GST_ZED_GRAB_FLUSHING,   // Interrupted by `gst_zed_grab_worker_set_flushing`
+} GstZedGrabResult;
+
+/* `destroy(user_data)` is called once the worker no longer grabs */
+GstZedGrabWorker *gst_zed_grab_worker_new(const gchar *name, GstZedGrabFunc func,
+                                          gpointer user_data, GDestroyNotify destroy);
+
+/* Stop the worker, waiting at most `timeout` [usec] for the grab in progress.
+ * Returns FALSE when the grab is still blocked: the worker and `user_data` are
+ * then freed from the worker thread when it returns, and the camera must be left
+ * to `user_data`. */
+gboolean gst_zed_grab_worker_free(GstZedGrabWorker *worker, gint64 timeout);
+
+/* Grab a frame on the worker thread and wait for it */
+GstZedGrabResult gst_zed_grab_worker_grab(GstZedGrabWorker *worker, gint *ret);
+
+void gst_zed_grab_worker_set_flushing(GstZedGrabWorker *worker, gboolean flushing);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_GRAB_WORKER_H_
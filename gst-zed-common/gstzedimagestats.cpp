@@ -0,0 +1,356 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+#include "gstzedimagestats.h"
+#include "gstzedconvert.h"
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GST_ZED_STATS_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GST_ZED_STATS_SSE2
+#endif
+
+// BT.601 luma coefficients, as in `gst_zed_convert_bgra_to_gray8`
+#define LUMA_B 15
+#define LUMA_G 75
+#define LUMA_R 38
+#define LUMA_SHIFT 7
+
+/* BGR (`swap` FALSE) or RGB (`swap` TRUE) -> luma */
+static void gst_zed_image_stats_luma_3ch(const guint8 *in, guint8 *out, guint width,
+                                         gboolean swap) {
+    const guint first = swap ? 2 : 0;
+    const guint last = swap ? 0 : 2;
+    guint u = 0;
+
+#if defined(GST_ZED_STATS_NEON)
+    for (; u + 8 <= width; u += 8) {
+        uint8x8x3_t px = vld3_u8(in + 3 * u);
+        uint16x8_t y = vmull_u8(px.val[first], vdup_n_u8(LUMA_B));
+        y = vmlal_u8(y, px.val[1], vdup_n_u8(LUMA_G));
+        y = vmlal_u8(y, px.val[last], vdup_n_u8(LUMA_R));
+        vst1_u8(out + u, vrshrn_n_u16(y, LUMA_SHIFT));
+    }
+#endif
+
+    for (; u < width; u++) {
+        out[u] = static_cast<guint8>((LUMA_B * in[3 * u + first] + LUMA_G * in[3 * u + 1] +
+                                      LUMA_R * in[3 * u + last] + (1 << (LUMA_SHIFT - 1))) >>
+                                     LUMA_SHIFT);
+    }
+}
+
+/* Mean of each group of 4 pixels of a luma row, for `n` groups */
+static void gst_zed_image_stats_downscale_row(const guint8 *y, guint8 *out, guint n) {
+    guint i = 0;
+
+#if defined(GST_ZED_STATS_NEON)
+    for (; i + 8 <= n; i += 8) {
+        uint32x4_t lo = vpaddlq_u16(vpaddlq_u8(vld1q_u8(y + 4 * i)));
+        uint32x4_t hi = vpaddlq_u16(vpaddlq_u8(vld1q_u8(y + 4 * i + 16)));
+        vst1_u8(out + i, vrshrn_n_u16(vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)), 2));
+    }
+#elif defined(GST_ZED_STATS_SSE2)
+    const __m128i low_bytes = _mm_set1_epi16(0x00FF);
+    const __m128i low_words = _mm_set1_epi32(0xFFFF);
+    const __m128i round = _mm_set1_epi32(2);
+    __m128i means[4];
+    for (; i + 16 <= n; i += 16) {
+        for (guint k = 0; k < 4; k++) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + 4 * i + 16 * k));
+            // Byte pairs in 16 bits lanes, then pairs of pairs in 32 bits lanes
+            __m128i sums = _mm_add_epi16(_mm_and_si128(v, low_bytes), _mm_srli_epi16(v, 8));
+            sums = _mm_add_epi32(_mm_and_si128(sums, low_words), _mm_srli_epi32(sums, 16));
+            means[k] = _mm_srli_epi32(_mm_add_epi32(sums, round), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                         _mm_packus_epi16(_mm_packs_epi32(means[0], means[1]),
+                                          _mm_packs_epi32(means[2], means[3])));
+    }
+#endif
+
+    for (; i < n; i++) {
+        out[i] = static_cast<guint8>((y[4 * i] + y[4 * i + 1] + y[4 * i + 2] + y[4 * i + 3] + 2) >>
+                                     2);
+    }
+}
+
+/* Histogram, sum and sum of squares of a luma row */
+static void gst_zed_image_stats_row_sums(const guint8 *y, guint width, guint32 *histogram,
+                                         guint64 *sum, guint64 *sum_sq) {
+    guint u = 0;
+
+    for (guint i = 0; i < width; i++) {
+        histogram[y[i]]++;
+    }
+
+#if defined(GST_ZED_STATS_NEON)
+    uint32x4_t acc = vdupq_n_u32(0);
+    uint32x4_t acc_sq = vdupq_n_u32(0);
+    for (; u + 16 <= width; u += 16) {
+        uint8x16_t v = vld1q_u8(y + u);
+        acc = vpadalq_u16(acc, vpaddlq_u8(v));
+        acc_sq = vpadalq_u16(acc_sq, vmull_u8(vget_low_u8(v), vget_low_u8(v)));
+        acc_sq = vpadalq_u16(acc_sq, vmull_u8(vget_high_u8(v), vget_high_u8(v)));
+    }
+    guint32 lanes[4], lanes_sq[4];
+    vst1q_u32(lanes, acc);
+    vst1q_u32(lanes_sq, acc_sq);
+    for (guint i = 0; i < 4; i++) {
+        *sum += lanes[i];
+        *sum_sq += lanes_sq[i];
+    }
+#elif defined(GST_ZED_STATS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    __m128i acc_sq = zero;
+    for (; u + 16 <= width; u += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + u));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+        acc_sq = _mm_add_epi32(acc_sq,
+                               _mm_add_epi32(_mm_madd_epi16(lo, lo), _mm_madd_epi16(hi, hi)));
+    }
+    guint64 lanes[2];
+    guint32 lanes_sq[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_sq), acc_sq);
+    *sum += lanes[0] + lanes[1];
+    for (guint i = 0; i < 4; i++) {
+        *sum_sq += lanes_sq[i];
+    }
+#endif
+
+    for (; u < width; u++) {
+        *sum += y[u];
+        *sum_sq += y[u] * y[u];
+    }
+}
+
+/* Sum and sum of squares of the Laplacian of the `cur` luma row, between `prev` and `next`.
+ * The 32 bits lanes hold the sums of up to `GST_ZED_IMAGE_STATS_MAX_WIDTH` pixels */
+static void gst_zed_image_stats_row_laplacian(const guint8 *prev, const guint8 *cur,
+                                              const guint8 *next, guint width, gint64 *sum,
+                                              guint64 *sum_sq) {
+    guint u = 1;
+
+#if defined(GST_ZED_STATS_NEON)
+    int32x4_t acc = vdupq_n_s32(0);
+    uint32x4_t acc_sq = vdupq_n_u32(0);
+    for (; u + 9 <= width; u += 8) {
+        int16x8_t center = vreinterpretq_s16_u16(vshll_n_u8(vld1_u8(cur + u), 2));
+        uint16x8_t around = vaddl_u8(vld1_u8(cur + u - 1), vld1_u8(cur + u + 1));
+        around = vaddw_u8(around, vld1_u8(prev + u));
+        around = vaddw_u8(around, vld1_u8(next + u));
+        int16x8_t lap = vsubq_s16(center, vreinterpretq_s16_u16(around));
+        acc = vpadalq_s16(acc, lap);
+        int32x4_t sq = vaddq_s32(vmull_s16(vget_low_s16(lap), vget_low_s16(lap)),
+                                 vmull_s16(vget_high_s16(lap), vget_high_s16(lap)));
+        acc_sq = vaddq_u32(acc_sq, vreinterpretq_u32_s32(sq));
+    }
+    gint32 lanes[4];
+    guint32 lanes_sq[4];
+    vst1q_s32(lanes, acc);
+    vst1q_u32(lanes_sq, acc_sq);
+    for (guint i = 0; i < 4; i++) {
+        *sum += lanes[i];
+        *sum_sq += lanes_sq[i];
+    }
+#elif defined(GST_ZED_STATS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = zero;
+    __m128i acc_sq = zero;
+    for (; u + 9 <= width; u += 8) {
+#define LOAD8(p) _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)), zero)
+        __m128i around = _mm_add_epi16(_mm_add_epi16(LOAD8(cur + u - 1), LOAD8(cur + u + 1)),
+                                       _mm_add_epi16(LOAD8(prev + u), LOAD8(next + u)));
+        __m128i lap = _mm_sub_epi16(_mm_slli_epi16(LOAD8(cur + u), 2), around);
+#undef LOAD8
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(lap, ones));
+        acc_sq = _mm_add_epi32(acc_sq, _mm_madd_epi16(lap, lap));
+    }
+    gint32 lanes[4];
+    guint32 lanes_sq[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), acc);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes_sq), acc_sq);
+    for (guint i = 0; i < 4; i++) {
+        *sum += lanes[i];
+        *sum_sq += lanes_sq[i];
+    }
+#endif
+
+    for (; u + 1 < width; u++) {
+        gint lap = 4 * cur[u] - cur[u - 1] - cur[u + 1] - prev[u] - next[u];
+        *sum += lap;
+        *sum_sq += lap * lap;
+    }
+}
+
+void gst_zed_image_stats_begin(GstZedImageStatsAccumulator *acc, GstZedPixelLayout layout,
+                               gboolean luma_stats) {
+    memset(acc, 0, sizeof(*acc));
+    acc->layout = layout;
+    acc->luma_stats = luma_stats;
+    g_mutex_init(&acc->lock);
+}
+
+void gst_zed_image_stats_set_lowres(GstZedImageStatsAccumulator *acc, const guint8 *frame,
+                                    gsize frame_stride, guint8 *lowres, gsize lowres_stride,
+                                    guint lowres_w, guint lowres_h) {
+    acc->frame = frame;
+    acc->frame_stride = frame_stride;
+    acc->lowres = lowres;
+    acc->lowres_stride = lowres_stride;
+    acc->lowres_w = lowres_w;
+    acc->lowres_h = lowres_h;
+}
+
+/* Write the thumbnail pixels of the `width` pixels luma row `y`, read from `row` */
+static void gst_zed_image_stats_add_lowres(GstZedImageStatsAccumulator *acc, const guint8 *row,
+                                           const guint8 *y, guint width) {
+    static const guint pixel_bytes[] = {1, 4, 3, 3};   // `GstZedPixelLayout` order
+    const guint scale = GST_ZED_IMAGE_STATS_LOWRES_SCALE;
+    gsize offset = row - acc->frame;
+    guint v = offset / acc->frame_stride;
+    guint u = (offset % acc->frame_stride) / pixel_bytes[acc->layout] / scale;
+
+    if (v % scale != 0 || v / scale >= acc->lowres_h || u >= acc->lowres_w) {
+        return;
+    }
+
+    gst_zed_image_stats_downscale_row(y, acc->lowres + (v / scale) * acc->lowres_stride + u,
+                                      MIN(width / scale, acc->lowres_w - u));
+}
+
+void gst_zed_image_stats_end(GstZedImageStatsAccumulator *acc, GstZedImageStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    if (acc->n_pixels > 0) {
+        for (guint i = 0; i < GST_ZED_IMAGE_STATS_BINS; i++) {
+            stats->histogram[i] = static_cast<guint32>(acc->histogram[i]);
+        }
+        stats->n_pixels = acc->n_pixels;
+        stats->mean = static_cast<gdouble>(acc->sum) / acc->n_pixels;
+        stats->variance =
+            static_cast<gdouble>(acc->sum_sq) / acc->n_pixels - stats->mean * stats->mean;
+    }
+
+    if (acc->lap_n > 0) {
+        gdouble lap_mean = static_cast<gdouble>(acc->lap_sum) / acc->lap_n;
+        stats->sharpness = static_cast<gdouble>(acc->lap_sum_sq) / acc->lap_n - lap_mean * lap_mean;
+    }
+
+    g_mutex_clear(&acc->lock);
+}
+
+void gst_zed_image_stats_slice_init(GstZedImageStatsSlice *slice,
+                                    GstZedImageStatsAccumulator *acc, guint width) {
+    slice->acc = acc;
+    slice->width = MIN(width, GST_ZED_IMAGE_STATS_MAX_WIDTH);
+    slice->n_rows = 0;
+    slice->rows[0] = slice->rows[1] = NULL;
+    memset(slice->histogram, 0, sizeof(slice->histogram));
+    slice->sum = 0;
+    slice->sum_sq = 0;
+    slice->lap_sum = 0;
+    slice->lap_sum_sq = 0;
+    slice->lap_n = 0;
+}
+
+void gst_zed_image_stats_slice_add_rows(GstZedImageStatsSlice *slice, const guint8 *rows,
+                                        gsize stride, guint n_rows) {
+    const guint width = slice->width;
+
+    for (guint v = 0; v < n_rows; v++, rows += stride) {
+        GstZedImageStatsAccumulator *acc = slice->acc;
+
+        if (!acc->luma_stats) {
+            // Thumbnail only: the other rows are not converted at all
+            gsize offset = rows - acc->frame;
+            if (!acc->frame || (offset / acc->frame_stride) % GST_ZED_IMAGE_STATS_LOWRES_SCALE) {
+                continue;
+            }
+        }
+
+        // Ring of three rows: the two previous ones are still needed by the Laplacian
+        guint8 *luma = slice->luma[slice->n_rows % 3];
+        const guint8 *y = luma;
+
+        switch (acc->layout) {
+        case GST_ZED_PIXEL_GRAY8:
+            y = rows;
+            break;
+        case GST_ZED_PIXEL_BGRA:
+            gst_zed_convert_bgra_to_gray8(rows, 0, luma, 0, width, 1);
+            break;
+        case GST_ZED_PIXEL_BGR:
+            gst_zed_image_stats_luma_3ch(rows, luma, width, FALSE);
+            break;
+        case GST_ZED_PIXEL_RGB:
+            gst_zed_image_stats_luma_3ch(rows, luma, width, TRUE);
+            break;
+        }
+
+        if (acc->frame) {
+            gst_zed_image_stats_add_lowres(acc, rows, y, width);
+        }
+        if (!acc->luma_stats) {
+            continue;
+        }
+
+        gst_zed_image_stats_row_sums(y, width, slice->histogram, &slice->sum, &slice->sum_sq);
+
+        if (slice->n_rows >= 2 && width >= 3) {
+            gst_zed_image_stats_row_laplacian(slice->rows[0], slice->rows[1], y, width,
+                                              &slice->lap_sum, &slice->lap_sum_sq);
+            slice->lap_n += width - 2;
+        }
+
+        slice->rows[0] = slice->rows[1];
+        slice->rows[1] = y;
+        slice->n_rows++;
+    }
+}
+
+void gst_zed_image_stats_slice_flush(GstZedImageStatsSlice *slice) {
+    GstZedImageStatsAccumulator *acc = slice->acc;
+
+    if (slice->n_rows == 0) {   // Also the case of the thumbnail alone
+        return;
+    }
+
+    g_mutex_lock(&acc->lock);
+    for (guint i = 0; i < GST_ZED_IMAGE_STATS_BINS; i++) {
+        acc->histogram[i] += slice->histogram[i];
+    }
+    acc->n_pixels += static_cast<guint64>(slice->width) * slice->n_rows;
+    acc->sum += slice->sum;
+    acc->sum_sq += slice->sum_sq;
+    acc->lap_sum += slice->lap_sum;
+    acc->lap_sum_sq += slice->lap_sum_sq;
+    acc->lap_n += slice->lap_n;
+    g_mutex_unlock(&acc->lock);
+}
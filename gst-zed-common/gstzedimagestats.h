@@ -0,0 +1,133 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+#ifndef _GST_ZED_IMAGE_STATS_H_
+#define _GST_ZED_IMAGE_STATS_H_
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Luma statistics of the output frames, computed by the copy engine on the rows
+ * each slice just wrote, while they are still in the caches.
+ *
+ * The luma is the BT.601 one of `gst_zed_convert_bgra_to_gray8`. The sharpness is the
+ * variance of its 4-neighbour Laplacian, which drops as the image gets blurry. The
+ * Laplacian is not computed on the first and last rows of the copy engine slices. Only
+ * the first `GST_ZED_IMAGE_STATS_MAX_WIDTH` columns are processed.
+ *
+ * The same pass can also write a low resolution luma thumbnail of the frame, see
+ * `gst_zed_image_stats_set_lowres`. */
+
+#define GST_ZED_IMAGE_STATS_BINS 256
+
+// Widest row processed [pixels]: the slices keep their luma rows on the stack
+#define GST_ZED_IMAGE_STATS_MAX_WIDTH 8192
+
+// Downscaling factor of the luma thumbnail
+#define GST_ZED_IMAGE_STATS_LOWRES_SCALE 4
+
+/* Pixel layout of the rows the statistics are computed on */
+typedef enum {
+    GST_ZED_PIXEL_GRAY8,
+    GST_ZED_PIXEL_BGRA,
+    GST_ZED_PIXEL_BGR,
+    GST_ZED_PIXEL_RGB,
+} GstZedPixelLayout;
+
+typedef struct {
+    guint32 histogram[GST_ZED_IMAGE_STATS_BINS];   // Luma histogram
+    guint64 n_pixels;                              // Pixels counted in the histogram
+    gdouble mean;                                  // Mean luma [0,255]
+    gdouble variance;                              // Luma variance
+    gdouble sharpness;                             // Variance of the luma Laplacian
+} GstZedImageStats;
+
+/* Statistics of one frame, shared by the slices of the copies writing it */
+typedef struct {
+    GstZedPixelLayout layout;
+    gboolean luma_stats;   // Histogram, moments and sharpness wanted
+
+    // ----> Luma thumbnail, written by the slices
+    const guint8 *frame;   // First byte of the frame, NULL for no thumbnail
+    gsize frame_stride;
+    guint8 *lowres;
+    gsize lowres_stride;
+    guint lowres_w;
+    guint lowres_h;
+    // <---- Luma thumbnail
+
+    GMutex lock;   // Slices merging their partial sums
+    guint64 histogram[GST_ZED_IMAGE_STATS_BINS];
+    guint64 n_pixels;
+    guint64 sum;
+    guint64 sum_sq;
+    gint64 lap_sum;
+    guint64 lap_sum_sq;
+    guint64 lap_n;
+} GstZedImageStatsAccumulator;
+
+/* Partial sums of one slice, merged into the frame ones by `gst_zed_image_stats_slice_flush` */
+typedef struct {
+    GstZedImageStatsAccumulator *acc;
+    guint width;
+    guint n_rows;                   // Rows added so far
+    const guint8 *rows[2];          // Luma of the last two rows added
+    guint8 luma[3][GST_ZED_IMAGE_STATS_MAX_WIDTH];   // Ring of converted luma rows
+    guint32 histogram[GST_ZED_IMAGE_STATS_BINS];
+    guint64 sum;
+    guint64 sum_sq;
+    gint64 lap_sum;
+    guint64 lap_sum_sq;
+    guint64 lap_n;
+} GstZedImageStatsSlice;
+
+/* Start the statistics of a frame of `layout` pixels. Without `luma_stats` only the
+ * thumbnail is computed */
+void gst_zed_image_stats_begin(GstZedImageStatsAccumulator *acc, GstZedPixelLayout layout,
+                               gboolean luma_stats);
+
+/* Also write the luma thumbnail of the frame starting at `frame` into the
+ * `lowres_w`x`lowres_h` image `lowres`. Its pixels are the mean of
+ * `GST_ZED_IMAGE_STATS_LOWRES_SCALE` pixels on one row every
+ * `GST_ZED_IMAGE_STATS_LOWRES_SCALE` rows. The position of the rows added is deduced from
+ * their address: several copies can write the same frame. */
+void gst_zed_image_stats_set_lowres(GstZedImageStatsAccumulator *acc, const guint8 *frame,
+                                    gsize frame_stride, guint8 *lowres, gsize lowres_stride,
+                                    guint lowres_w, guint lowres_h);
+
+/* Compute the statistics of the frame into `stats`. Without any pixel added the
+ * statistics are all 0 */
+void gst_zed_image_stats_end(GstZedImageStatsAccumulator *acc, GstZedImageStats *stats);
+
+/* Start a slice of `width` pixels wide rows */
+void gst_zed_image_stats_slice_init(GstZedImageStatsSlice *slice,
+                                    GstZedImageStatsAccumulator *acc, guint width);
+
+/* Add the next `n_rows` rows of the slice. The rows added before must still be readable */
+void gst_zed_image_stats_slice_add_rows(GstZedImageStatsSlice *slice, const guint8 *rows,
+                                        gsize stride, guint n_rows);
+
+/* Merge the partial sums of the slice into the frame ones */
+void gst_zed_image_stats_slice_flush(GstZedImageStatsSlice *slice);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_IMAGE_STATS_H_
@@ -0,0 +1,60 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+#ifndef _GST_ZED_IMAGE_STATS_META_H_
+#define _GST_ZED_IMAGE_STATS_META_H_
+
+#include <gst/gst.h>
+
+#include "gstzedimagestats.h"
+
+G_BEGIN_DECLS
+
+/* Luma statistics of the frame, see `gstzedimagestats.h`. Tagged "video": dropped by
+ * the elements changing the frame content.
+ *
+ * The API type is registered by name: applications not linking the ZED plugins
+ * retrieve the meta with `gst_buffer_get_meta(buffer,
+ * g_type_from_name(GST_ZED_IMAGE_STATS_META_API_NAME))` */
+
+#define GST_ZED_IMAGE_STATS_META_API_NAME "GstZedImageStatsMetaAPI"
+#define GST_ZED_IMAGE_STATS_META_IMPL_NAME "GstZedImageStatsMeta"
+
+typedef struct {
+    GstMeta meta;
+
+    GstZedImageStats stats;
+} GstZedImageStatsMeta;
+
+GType gst_zed_image_stats_meta_api_get_type(void);
+#define GST_ZED_IMAGE_STATS_META_API_TYPE (gst_zed_image_stats_meta_api_get_type())
+
+const GstMetaInfo *gst_zed_image_stats_meta_get_info(void);
+#define GST_ZED_IMAGE_STATS_META_INFO (gst_zed_image_stats_meta_get_info())
+
+#define gst_buffer_get_zed_image_stats_meta(b)                                                     \
+    ((GstZedImageStatsMeta *) gst_buffer_get_meta((b), GST_ZED_IMAGE_STATS_META_API_TYPE))
+
+GstZedImageStatsMeta *gst_buffer_add_zed_image_stats_meta(GstBuffer *buffer,
+                                                          const GstZedImageStats *stats);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_IMAGE_STATS_META_H_
@@ -0,0 +1,672 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedmetrics.h"
+
+#include <atomic>
+#include <math.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#define CACHE_LINE 64
+
+// Counter shards, the updating threads being spread over them
+#define COUNTER_SHARDS 4
+
+// Histogram buckets: 32 per power of two from 32 nsec up to 2^40 nsec (18 min)
+#define HISTOGRAM_SUB_BITS 5
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BIT 39
+#define HISTOGRAM_BUCKETS ((HISTOGRAM_MAX_BIT - HISTOGRAM_SUB_BITS + 2) * HISTOGRAM_SUB_BUCKETS)
+
+#define N_QUANTILES 4
+
+static const gdouble gst_zed_quantiles[N_QUANTILES] = {0.5, 0.9, 0.99, 0.999};
+static const gchar *gst_zed_quantile_fields[N_QUANTILES] = {"-p50", "-p90", "-p99", "-p999"};
+
+typedef struct {
+    std::atomic<guint64> value;
+    guint8 padding[CACHE_LINE - sizeof(std::atomic<guint64>)];
+} GstZedCounterShard;
+
+struct _GstZedCounter {
+    GstZedCounterShard shards[COUNTER_SHARDS];   // Each on its own cache line
+};
+
+struct _GstZedGauge {
+    std::atomic<guint64> bits;   // gdouble value
+};
+
+struct _GstZedHistogram {
+    std::atomic<guint64> count;
+    std::atomic<guint64> sum;   // [nsec]
+    std::atomic<guint64> max;   // [nsec]
+    std::atomic<guint64> buckets[HISTOGRAM_BUCKETS];
+};
+
+typedef enum {
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM,
+} GstZedMetricType;
+
+typedef struct {
+    GstZedMetricType type;
+    gchar *name;
+    gchar *help;
+    gpointer metric;
+} GstZedMetric;
+
+/* Percentiles read from a histogram */
+typedef struct {
+    guint64 count;
+    guint64 sum;   // [nsec]
+    guint64 max;   // [nsec]
+    guint64 quantiles[N_QUANTILES];   // [nsec]
+} GstZedHistogramSnapshot;
+
+struct _GstZedMetrics {
+    GPtrArray *metrics;   // GstZedMetric, in their order of addition
+
+    // ----> Export
+    GThread *thread;     // NULL if not exporting
+    gchar *labels;
+    gchar *location;     // Prometheus text file, NULL if none
+    gchar *socket_path;  // Unix domain socket, NULL if none
+    gint listen_fd;      // Listening on `socket_path`, -1 if none
+    gint wake_fd[2];     // Pipe interrupting the export thread
+    guint interval;      // Period of the file updates [msec]
+    // <---- Export
+};
+
+static void gst_zed_metric_free(gpointer data) {
+    GstZedMetric *metric = static_cast<GstZedMetric *>(data);
+
+    switch (metric->type) {
+    case METRIC_COUNTER:
+        delete static_cast<GstZedCounter *>(metric->metric);
+        break;
+    case METRIC_GAUGE:
+        delete static_cast<GstZedGauge *>(metric->metric);
+        break;
+    case METRIC_HISTOGRAM:
+        delete static_cast<GstZedHistogram *>(metric->metric);
+        break;
+    }
+    g_free(metric->name);
+    g_free(metric->help);
+    g_free(metric);
+}
+
+GstZedMetrics *gst_zed_metrics_new(void) {
+    GstZedMetrics *metrics = g_new0(GstZedMetrics, 1);
+
+    metrics->metrics = g_ptr_array_new_with_free_func(gst_zed_metric_free);
+    metrics->listen_fd = -1;
+
+    return metrics;
+}
+
+void gst_zed_metrics_free(GstZedMetrics *metrics) {
+    gst_zed_metrics_stop_export(metrics);
+    g_ptr_array_unref(metrics->metrics);
+    g_free(metrics);
+}
+
+static gpointer gst_zed_metrics_add(GstZedMetrics *metrics, GstZedMetricType type,
+                                    const gchar *name, const gchar *help, gpointer metric) {
+    GstZedMetric *entry = g_new0(GstZedMetric, 1);
+
+    entry->type = type;
+    entry->name = g_strdup(name);
+    entry->help = g_strdup(help);
+    entry->metric = metric;
+    g_ptr_array_add(metrics->metrics, entry);
+
+    return metric;
+}
+
+GstZedCounter *gst_zed_metrics_add_counter(GstZedMetrics *metrics, const gchar *name,
+                                           const gchar *help) {
+    return static_cast<GstZedCounter *>(
+        gst_zed_metrics_add(metrics, METRIC_COUNTER, name, help, new GstZedCounter()));
+}
+
+GstZedGauge *gst_zed_metrics_add_gauge(GstZedMetrics *metrics, const gchar *name,
+                                       const gchar *help) {
+    return static_cast<GstZedGauge *>(
+        gst_zed_metrics_add(metrics, METRIC_GAUGE, name, help, new GstZedGauge()));
+}
+
+GstZedHistogram *gst_zed_metrics_add_histogram(GstZedMetrics *metrics, const gchar *name,
+                                               const gchar *help) {
+    return static_cast<GstZedHistogram *>(
+        gst_zed_metrics_add(metrics, METRIC_HISTOGRAM, name, help, new GstZedHistogram()));
+}
+
+// ----> Updates
+
+/* Shard of the calling thread, assigned at its first update */
+static guint gst_zed_counter_shard(void) {
+    static std::atomic<guint> next_shard(0);
+    static thread_local guint shard =
+        next_shard.fetch_add(1, std::memory_order_relaxed) % COUNTER_SHARDS;
+
+    return shard;
+}
+
+void gst_zed_counter_add(GstZedCounter *counter, guint64 n) {
+    counter->shards[gst_zed_counter_shard()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+static guint64 gst_zed_counter_read(GstZedCounter *counter) {
+    guint64 value = 0;
+
+    for (guint i = 0; i < COUNTER_SHARDS; i++) {
+        value += counter->shards[i].value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+void gst_zed_gauge_set(GstZedGauge *gauge, gdouble value) {
+    guint64 bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    gauge->bits.store(bits, std::memory_order_relaxed);
+}
+
+static gdouble gst_zed_gauge_read(GstZedGauge *gauge) {
+    guint64 bits = gauge->bits.load(std::memory_order_relaxed);
+    gdouble value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* Values below 32 have their own bucket, the larger ones share a bucket with the values
+ * having the same 6 most significant bits */
+static guint gst_zed_histogram_bucket(guint64 value) {
+    if (value < HISTOGRAM_SUB_BUCKETS) {
+        return static_cast<guint>(value);
+    }
+
+    guint bit = 63 - __builtin_clzll(value);
+    if (bit > HISTOGRAM_MAX_BIT) {
+        return HISTOGRAM_BUCKETS - 1;
+    }
+
+    guint shift = bit - HISTOGRAM_SUB_BITS;
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + static_cast<guint>(value >> shift) -
+           HISTOGRAM_SUB_BUCKETS;
+}
+
+/* Middle of the values counted by `bucket` */
+static guint64 gst_zed_histogram_bucket_value(guint bucket) {
+    if (bucket < HISTOGRAM_SUB_BUCKETS) {
+        return bucket;
+    }
+
+    guint shift = bucket / HISTOGRAM_SUB_BUCKETS - 1;
+    guint64 low = static_cast<guint64>(HISTOGRAM_SUB_BUCKETS + bucket % HISTOGRAM_SUB_BUCKETS)
+                  << shift;
+    return low + ((G_GUINT64_CONSTANT(1) << shift) >> 1);
+}
+
+void gst_zed_histogram_record(GstZedHistogram *histogram, GstClockTime duration) {
+    histogram->buckets[gst_zed_histogram_bucket(duration)].fetch_add(1,
+                                                                    std::memory_order_relaxed);
+    histogram->sum.fetch_add(duration, std::memory_order_relaxed);
+    histogram->count.fetch_add(1, std::memory_order_relaxed);
+
+    guint64 max = histogram->max.load(std::memory_order_relaxed);
+    while (duration > max &&
+           !histogram->max.compare_exchange_weak(max, duration, std::memory_order_relaxed)) {
+    }
+}
+
+// <---- Updates
+
+// ----> Snapshots
+
+/* Buckets read one by one while being updated: the percentiles are computed from the
+ * samples counted in the buckets read */
+static void gst_zed_histogram_snapshot(GstZedHistogram *histogram,
+                                       GstZedHistogramSnapshot *snapshot) {
+    guint64 *counts = g_new(guint64, HISTOGRAM_BUCKETS);
+    guint64 total = 0;
+
+    for (guint i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        counts[i] = histogram->buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    snapshot->count = histogram->count.load(std::memory_order_relaxed);
+    snapshot->sum = histogram->sum.load(std::memory_order_relaxed);
+    snapshot->max = histogram->max.load(std::memory_order_relaxed);
+
+    guint64 seen = 0;
+    guint bucket = 0;
+    for (guint q = 0; q < N_QUANTILES; q++) {
+        guint64 rank = MAX(static_cast<guint64>(ceil(gst_zed_quantiles[q] * total)), 1);
+
+        while (bucket < HISTOGRAM_BUCKETS && seen + counts[bucket] < rank) {
+            seen += counts[bucket++];
+        }
+        snapshot->quantiles[q] =
+            total == 0 ? 0
+                       : MIN(gst_zed_histogram_bucket_value(MIN(bucket, HISTOGRAM_BUCKETS - 1)),
+                             snapshot->max);
+    }
+
+    g_free(counts);
+}
+
+/* Structure field of `name` followed by `suffix`, without the "zed_" prefix */
+static gchar *gst_zed_metric_field(const gchar *name, const gchar *suffix) {
+    if (g_str_has_prefix(name, "zed_")) {
+        name += 4;
+    }
+
+    gchar *field = g_strconcat(name, suffix, NULL);
+    g_strdelimit(field, "_", '-');
+    return field;
+}
+
+GstStructure *gst_zed_metrics_get_structure(GstZedMetrics *metrics, const gchar *name) {
+    GstStructure *structure = gst_structure_new_empty(name);
+
+    for (guint i = 0; i < metrics->metrics->len; i++) {
+        GstZedMetric *metric = static_cast<GstZedMetric *>(g_ptr_array_index(metrics->metrics, i));
+        gchar *field;
+
+        switch (metric->type) {
+        case METRIC_COUNTER:
+            field = gst_zed_metric_field(metric->name, "");
+            gst_structure_set(structure, field, G_TYPE_UINT64,
+                              gst_zed_counter_read(static_cast<GstZedCounter *>(metric->metric)),
+                              NULL);
+            g_free(field);
+            break;
+        case METRIC_GAUGE:
+            field = gst_zed_metric_field(metric->name, "");
+            gst_structure_set(structure, field, G_TYPE_DOUBLE,
+                              gst_zed_gauge_read(static_cast<GstZedGauge *>(metric->metric)),
+                              NULL);
+            g_free(field);
+            break;
+        case METRIC_HISTOGRAM: {
+            GstZedHistogramSnapshot snapshot;
+            gst_zed_histogram_snapshot(static_cast<GstZedHistogram *>(metric->metric), &snapshot);
+
+            field = gst_zed_metric_field(metric->name, "-count");
+            gst_structure_set(structure, field, G_TYPE_UINT64, snapshot.count, NULL);
+            g_free(field);
+            for (guint q = 0; q < N_QUANTILES; q++) {
+                field = gst_zed_metric_field(metric->name, gst_zed_quantile_fields[q]);
+                gst_structure_set(structure, field, G_TYPE_UINT64, snapshot.quantiles[q], NULL);
+                g_free(field);
+            }
+            field = gst_zed_metric_field(metric->name, "-max");
+            gst_structure_set(structure, field, G_TYPE_UINT64, snapshot.max, NULL);
+            g_free(field);
+            break;
+        }
+        }
+    }
+
+    return structure;
+}
+
+/* One sample line: `name` `suffix`{`labels`,`extra`} `value` */
+static void gst_zed_prometheus_sample(GString *out, const gchar *name, const gchar *suffix,
+                                      const gchar *labels, const gchar *extra, gdouble value) {
+    gchar number[G_ASCII_DTOSTR_BUF_SIZE];
+    gboolean has_labels = labels && *labels;
+
+    g_string_append_printf(out, "%s%s", name, suffix);
+    if (has_labels || extra) {
+        g_string_append_printf(out, "{%s%s%s}", has_labels ? labels : "",
+                               has_labels && extra ? "," : "", extra ? extra : "");
+    }
+    g_string_append_printf(out, " %s\n", g_ascii_dtostr(number, sizeof(number), value));
+}
+
+gchar *gst_zed_metrics_to_prometheus(GstZedMetrics *metrics, const gchar *labels) {
+    GString *out = g_string_new(NULL);
+
+    for (guint i = 0; i < metrics->metrics->len; i++) {
+        GstZedMetric *metric = static_cast<GstZedMetric *>(g_ptr_array_index(metrics->metrics, i));
+
+        switch (metric->type) {
+        case METRIC_COUNTER:
+            g_string_append_printf(out, "# HELP %s %s\n# TYPE %s counter\n", metric->name,
+                                   metric->help, metric->name);
+            gst_zed_prometheus_sample(
+                out, metric->name, "", labels, NULL,
+                gst_zed_counter_read(static_cast<GstZedCounter *>(metric->metric)));
+            break;
+        case METRIC_GAUGE: {
+            gdouble value = gst_zed_gauge_read(static_cast<GstZedGauge *>(metric->metric));
+            if (isnan(value)) {
+                break;   // Unknown
+            }
+            g_string_append_printf(out, "# HELP %s %s\n# TYPE %s gauge\n", metric->name,
+                                   metric->help, metric->name);
+            gst_zed_prometheus_sample(out, metric->name, "", labels, NULL, value);
+            break;
+        }
+        case METRIC_HISTOGRAM: {
+            GstZedHistogramSnapshot snapshot;
+            gst_zed_histogram_snapshot(static_cast<GstZedHistogram *>(metric->metric), &snapshot);
+
+            g_string_append_printf(out, "# HELP %s_seconds %s\n# TYPE %s_seconds summary\n",
+                                   metric->name, metric->help, metric->name);
+            for (guint q = 0; q < N_QUANTILES; q++) {
+                gchar extra[32];
+                g_snprintf(extra, sizeof(extra), "quantile=\"%g\"", gst_zed_quantiles[q]);
+                gst_zed_prometheus_sample(out, metric->name, "_seconds", labels, extra,
+                                          snapshot.quantiles[q] / 1e9);
+            }
+            gst_zed_prometheus_sample(out, metric->name, "_seconds_sum", labels, NULL,
+                                      snapshot.sum / 1e9);
+            gst_zed_prometheus_sample(out, metric->name, "_seconds_count", labels, NULL,
+                                      static_cast<gdouble>(snapshot.count));
+
+            g_string_append_printf(out, "# HELP %s_seconds_max %s, longest\n"
+                                        "# TYPE %s_seconds_max gauge\n",
+                                   metric->name, metric->help, metric->name);
+            gst_zed_prometheus_sample(out, metric->name, "_seconds_max", labels, NULL,
+                                      snapshot.max / 1e9);
+            break;
+        }
+        }
+    }
+
+    return g_string_free(out, FALSE);
+}
+
+// <---- Snapshots
+
+// ----> Export
+
+#ifdef __linux__
+/* Replace the file at once: the collectors never read a partial file */
+static gboolean gst_zed_metrics_write_file(GstZedMetrics *metrics) {
+    gchar *text = gst_zed_metrics_to_prometheus(metrics, metrics->labels);
+    GError *error = NULL;
+
+    gboolean ret = g_file_set_contents(metrics->location, text, -1, &error);
+    if (!ret) {
+        GST_WARNING("Metrics not written to '%s': %s", metrics->location, error->message);
+        g_error_free(error);
+    }
+    g_free(text);
+
+    return ret;
+}
+
+/* Send the metrics to the next client and close its connection */
+static void gst_zed_metrics_serve(GstZedMetrics *metrics) {
+    gint fd = accept4(metrics->listen_fd, NULL, NULL, SOCK_CLOEXEC);
+    if (fd < 0) {
+        return;   // Client gone
+    }
+
+    // A stalled client does not stop the file updates for long
+    struct timeval timeout = {1, 0};
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    gchar *text = gst_zed_metrics_to_prometheus(metrics, metrics->labels);
+    gsize size = strlen(text);
+    gsize sent = 0;
+    while (sent < size) {
+        ssize_t n = send(fd, text + sent, size - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        sent += n;
+    }
+    g_free(text);
+    close(fd);
+}
+
+static gpointer gst_zed_metrics_export_thread(gpointer data) {
+    GstZedMetrics *metrics = static_cast<GstZedMetrics *>(data);
+    gint64 next_write = g_get_monotonic_time();
+    gboolean written = TRUE;   // Warn once per failure streak
+
+    while (TRUE) {
+        gint timeout = -1;
+
+        if (metrics->location) {
+            gint64 now = g_get_monotonic_time();
+            if (now >= next_write) {
+                gboolean ret = gst_zed_metrics_write_file(metrics);
+                if (ret && !written) {
+                    GST_INFO("Metrics written to '%s' again", metrics->location);
+                }
+                written = ret;
+                next_write = MAX(next_write + metrics->interval * G_TIME_SPAN_MILLISECOND, now);
+            }
+            timeout = static_cast<gint>((next_write - now + 999) / 1000);
+        }
+
+        struct pollfd fds[2] = {{metrics->wake_fd[0], POLLIN, 0},
+                                {metrics->listen_fd, POLLIN, 0}};
+        gint n = poll(fds, metrics->listen_fd >= 0 ? 2 : 1, timeout);
+        if (n < 0 && errno != EINTR) {
+            break;
+        }
+        if (fds[0].revents) {
+            break;   // Stopped
+        }
+        if (n > 0 && (fds[1].revents & POLLIN)) {
+            gst_zed_metrics_serve(metrics);
+        }
+    }
+
+    // Last values of the stream
+    if (metrics->location) {
+        gst_zed_metrics_write_file(metrics);
+    }
+
+    return NULL;
+}
+
+/* Bind a listening socket to `path`, replacing the socket of a previous run */
+static gint gst_zed_metrics_listen(const gchar *path) {
+    struct sockaddr_un addr;
+    struct stat st;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(path);
+    }
+
+    gint fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        listen(fd, 8) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+#endif
+
+gboolean gst_zed_metrics_start_export(GstZedMetrics *metrics, const gchar *labels,
+                                      const gchar *location, const gchar *socket_path,
+                                      guint interval) {
+    g_return_val_if_fail(metrics->thread == NULL, FALSE);
+
+    if (!location && !socket_path) {
+        return TRUE;
+    }
+
+#ifdef __linux__
+    gint listen_fd = -1;
+    if (socket_path && (listen_fd = gst_zed_metrics_listen(socket_path)) < 0) {
+        return FALSE;
+    }
+    if (pipe2(metrics->wake_fd, O_CLOEXEC) != 0) {
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            unlink(socket_path);
+        }
+        return FALSE;
+    }
+
+    metrics->labels = g_strdup(labels);
+    metrics->location = g_strdup(location);
+    metrics->socket_path = g_strdup(socket_path);
+    metrics->listen_fd = listen_fd;
+    metrics->interval = MAX(interval, 1);
+    metrics->thread = g_thread_new("zed-metrics", gst_zed_metrics_export_thread, metrics);
+
+    return TRUE;
+#else
+    (void) labels;
+    (void) interval;
+    return FALSE;
+#endif
+}
+
+void gst_zed_metrics_stop_export(GstZedMetrics *metrics) {
+    if (!metrics->thread) {
+        return;
+    }
+
+#ifdef __linux__
+    gchar wake = 0;
+    if (write(metrics->wake_fd[1], &wake, 1) < 0) {
+        GST_WARNING("Metrics export thread not woken up");
+    }
+    g_thread_join(metrics->thread);
+    metrics->thread = NULL;
+
+    close(metrics->wake_fd[0]);
+    close(metrics->wake_fd[1]);
+    if (metrics->listen_fd >= 0) {
+        close(metrics->listen_fd);
+        unlink(metrics->socket_path);
+        metrics->listen_fd = -1;
+    }
+#endif
+
+    g_clear_pointer(&metrics->labels, g_free);
+    g_clear_pointer(&metrics->location, g_free);
+    g_clear_pointer(&metrics->socket_path, g_free);
+}
+
+// <---- Export
+
+// ----> Capture metrics
+
+void gst_zed_capture_metrics_init(GstZedCaptureMetrics *metrics) {
+    GstZedMetrics *registry = gst_zed_metrics_new();
+
+    metrics->registry = registry;
+    metrics->frames = gst_zed_metrics_add_counter(registry, "zed_frames_total",
+                                                  "Frames pushed downstream");
+    metrics->bytes = gst_zed_metrics_add_counter(registry, "zed_bytes_total",
+                                                 "Bytes pushed downstream");
+    metrics->grabs = gst_zed_metrics_add_counter(registry, "zed_grabs_total",
+                                                 "Frames grabbed, decimated ones included");
+    metrics->camera_drops = gst_zed_metrics_add_counter(registry, "zed_camera_drops_total",
+                                                        "Frames dropped by the camera");
+    metrics->sharpness_drops = gst_zed_metrics_add_counter(
+        registry, "zed_sharpness_drops_total", "Frames dropped below the minimum sharpness");
+    metrics->motion_drops = gst_zed_metrics_add_counter(registry, "zed_motion_drops_total",
+                                                        "Frames dropped by the motion gate");
+    metrics->repeated = gst_zed_metrics_add_counter(
+        registry, "zed_repeated_frames_total", "Frames repeated while the camera is lost");
+    metrics->reconnects = gst_zed_metrics_add_counter(registry, "zed_reconnects_total",
+                                                      "Camera recoveries started");
+
+    metrics->fps = gst_zed_metrics_add_gauge(registry, "zed_fps", "Output frame rate");
+    metrics->temperature = gst_zed_metrics_add_gauge(registry, "zed_temperature_celsius",
+                                                     "Camera temperature");
+    gst_zed_gauge_set(metrics->temperature, NAN);
+
+    metrics->grab = gst_zed_metrics_add_histogram(registry, "zed_grab",
+                                                  "Wait for a camera frame, retrieval included");
+    metrics->copy = gst_zed_metrics_add_histogram(registry, "zed_copy",
+                                                  "Frame copy and analysis");
+
+    gst_zed_capture_metrics_reset(metrics);
+}
+
+void gst_zed_capture_metrics_clear(GstZedCaptureMetrics *metrics) {
+    g_clear_pointer(&metrics->registry, gst_zed_metrics_free);
+}
+
+void gst_zed_capture_metrics_reset(GstZedCaptureMetrics *metrics) {
+    metrics->period_start = GST_CLOCK_TIME_NONE;
+    metrics->period_frames = 0;
+    gst_zed_gauge_set(metrics->fps, 0.0);
+}
+
+gboolean gst_zed_capture_metrics_frame(GstZedCaptureMetrics *metrics, gsize size,
+                                       GstClockTime clock_time) {
+    gst_zed_counter_add(metrics->frames, 1);
+    gst_zed_counter_add(metrics->bytes, size);
+
+    if (!GST_CLOCK_TIME_IS_VALID(metrics->period_start) || clock_time < metrics->period_start) {
+        metrics->period_start = clock_time;
+        metrics->period_frames = 0;
+        return FALSE;
+    }
+
+    metrics->period_frames++;
+    GstClockTime elapsed = clock_time - metrics->period_start;
+    if (elapsed < GST_SECOND) {
+        return FALSE;
+    }
+
+    gst_zed_gauge_set(metrics->fps, static_cast<gdouble>(metrics->period_frames) * GST_SECOND /
+                                        elapsed);
+    metrics->period_start = clock_time;
+    metrics->period_frames = 0;
+
+    return TRUE;
+}
+
+// <---- Capture metrics
@@ -0,0 +1,126 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_METRICS_H_
+#define _GST_ZED_METRICS_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Capture statistics of the ZED source elements, read through their `stats` property
+ * and exported periodically in the Prometheus text format.
+ *
+ * Updating a metric from the streaming thread takes a few relaxed atomic operations and
+ * never locks: counters are split in cache line sized shards picked by the updating
+ * thread, histograms count their samples in log-linear buckets (about 3% wide) from
+ * which the percentiles are computed when read. Metrics are added to the registry
+ * before any update or export, the registry itself is not locked. */
+
+typedef struct _GstZedMetrics GstZedMetrics;
+typedef struct _GstZedCounter GstZedCounter;
+typedef struct _GstZedGauge GstZedGauge;
+typedef struct _GstZedHistogram GstZedHistogram;
+
+GstZedMetrics *gst_zed_metrics_new(void);
+
+/* Stops the export first */
+void gst_zed_metrics_free(GstZedMetrics *metrics);
+
+/* `name` is the Prometheus name of the metric, e.g. "zed_frames_total". Histograms record
+ * durations [nsec] and are exported in seconds, as `name` followed by "_seconds". */
+GstZedCounter *gst_zed_metrics_add_counter(GstZedMetrics *metrics, const gchar *name,
+                                           const gchar *help);
+GstZedGauge *gst_zed_metrics_add_gauge(GstZedMetrics *metrics, const gchar *name,
+                                       const gchar *help);
+GstZedHistogram *gst_zed_metrics_add_histogram(GstZedMetrics *metrics, const gchar *name,
+                                               const gchar *help);
+
+void gst_zed_counter_add(GstZedCounter *counter, guint64 n);
+
+/* NaN for an unknown value, not exported */
+void gst_zed_gauge_set(GstZedGauge *gauge, gdouble value);
+
+void gst_zed_histogram_record(GstZedHistogram *histogram, GstClockTime duration);
+
+/* Snapshot of the metrics named `name`. The fields are the metric names without the "zed_"
+ * prefix, with dashes: counters as guint64, gauges as gdouble, histograms as the
+ * GstClockTime fields "<name>-count", "-p50", "-p90", "-p99", "-p999" and "-max" */
+GstStructure *gst_zed_metrics_get_structure(GstZedMetrics *metrics, const gchar *name);
+
+/* Prometheus text exposition of the metrics, `labels` (e.g. "element=\"zedsrc0\"") being
+ * added to each sample. Free with g_free */
+gchar *gst_zed_metrics_to_prometheus(GstZedMetrics *metrics, const gchar *labels);
+
+/* Start a thread exporting the metrics: every `interval` [msec] to the file `location`,
+ * replaced atomically (for the node exporter textfile collector), and to each client
+ * connecting to the Unix domain socket `socket_path`. Either can be NULL. Returns FALSE,
+ * exporting nothing, if the socket cannot be bound. */
+gboolean gst_zed_metrics_start_export(GstZedMetrics *metrics, const gchar *labels,
+                                      const gchar *location, const gchar *socket_path,
+                                      guint interval);
+
+void gst_zed_metrics_stop_export(GstZedMetrics *metrics);
+
+// ----> Capture metrics
+
+/* Metrics shared by the ZED source elements */
+typedef struct {
+    GstZedMetrics *registry;
+
+    GstZedCounter *frames;            // Frames pushed
+    GstZedCounter *bytes;             // Bytes pushed
+    GstZedCounter *grabs;             // Frames grabbed, decimated ones included
+    GstZedCounter *camera_drops;      // Frames dropped by the camera
+    GstZedCounter *sharpness_drops;   // Frames dropped by the sharpness filter
+    GstZedCounter *motion_drops;      // Frames dropped by the motion gate
+    GstZedCounter *repeated;          // Frames repeated while the camera is lost
+    GstZedCounter *reconnects;        // Camera recoveries started
+
+    GstZedGauge *fps;           // Output frame rate
+    GstZedGauge *temperature;   // Camera temperature [Celsius]
+
+    GstZedHistogram *grab;   // Wait for a camera frame, retrieval included
+    GstZedHistogram *copy;   // Frame copy and analysis
+
+    // Output frame rate measure, in the streaming thread
+    GstClockTime period_start;   // Clock time of the last gauge update
+    guint64 period_frames;       // Frames pushed since `period_start`
+} GstZedCaptureMetrics;
+
+void gst_zed_capture_metrics_init(GstZedCaptureMetrics *metrics);
+
+void gst_zed_capture_metrics_clear(GstZedCaptureMetrics *metrics);
+
+/* Streaming stopped: the output frame rate drops to 0 */
+void gst_zed_capture_metrics_reset(GstZedCaptureMetrics *metrics);
+
+/* Count a frame of `size` bytes pushed at `clock_time`. Returns TRUE once per second,
+ * after the output frame rate gauge was updated: the caller then updates the slow
+ * gauges and counters read from the camera. */
+gboolean gst_zed_capture_metrics_frame(GstZedCaptureMetrics *metrics, gsize size,
+                                       GstClockTime clock_time);
+
+// <---- Capture metrics
+
+G_END_DECLS
+
+#endif   // _GST_ZED_METRICS_H_
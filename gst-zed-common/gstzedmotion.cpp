@@ -0,0 +1,154 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+#include "gstzedmotion.h"
+
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GST_ZED_MOTION_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GST_ZED_MOTION_SSE2
+#endif
+
+// Side of the blocks in the thumbnail [pixels]
+#define THUMB_BLOCK (GST_ZED_MOTION_BLOCK_SIZE / GST_ZED_IMAGE_STATS_LOWRES_SCALE)
+
+struct _GstZedMotionGate {
+    guint width;    // Frame size
+    guint height;
+    guint blocks_x;
+    guint blocks_y;
+    gsize stride;              // Thumbnail row bytes, an even number of blocks
+    guint8 *thumbs[2];         // Current and reference thumbnails
+    guint cur;                 // Index of the current thumbnail
+    gboolean has_reference;
+};
+
+/* Sums of absolute differences of two horizontally adjacent blocks */
+static void gst_zed_motion_sad_pair(const guint8 *a, const guint8 *b, gsize stride,
+                                    guint sad[2]) {
+#if defined(GST_ZED_MOTION_NEON)
+    uint16x8_t acc = vdupq_n_u16(0);
+    for (guint v = 0; v < THUMB_BLOCK; v++, a += stride, b += stride) {
+        acc = vpadalq_u8(acc, vabdq_u8(vld1q_u8(a), vld1q_u8(b)));
+    }
+    uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(acc));
+    sad[0] = static_cast<guint>(vgetq_lane_u64(sums, 0));
+    sad[1] = static_cast<guint>(vgetq_lane_u64(sums, 1));
+#elif defined(GST_ZED_MOTION_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (guint v = 0; v < THUMB_BLOCK; v++, a += stride, b += stride) {
+        __m128i pa = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+        __m128i pb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(pa, pb));
+    }
+    sad[0] = static_cast<guint>(_mm_cvtsi128_si32(acc));
+    sad[1] = static_cast<guint>(_mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#else
+    sad[0] = sad[1] = 0;
+    for (guint v = 0; v < THUMB_BLOCK; v++, a += stride, b += stride) {
+        for (guint u = 0; u < 2 * THUMB_BLOCK; u++) {
+            sad[u / THUMB_BLOCK] += a[u] > b[u] ? a[u] - b[u] : b[u] - a[u];
+        }
+    }
+#endif
+}
+
+GstZedMotionGate *gst_zed_motion_gate_new(void) {
+    return g_new0(GstZedMotionGate, 1);
+}
+
+void gst_zed_motion_gate_free(GstZedMotionGate *gate) {
+    if (!gate) {
+        return;
+    }
+
+    g_free(gate->thumbs[0]);
+    g_free(gate->thumbs[1]);
+    g_free(gate);
+}
+
+void gst_zed_motion_gate_begin(GstZedMotionGate *gate, GstZedImageStatsAccumulator *acc,
+                               const guint8 *frame, gsize stride, guint width, guint height) {
+    if (width != gate->width || height != gate->height) {
+        gate->width = width;
+        gate->height = height;
+        gate->blocks_x = (width + GST_ZED_MOTION_BLOCK_SIZE - 1) / GST_ZED_MOTION_BLOCK_SIZE;
+        gate->blocks_y = (height + GST_ZED_MOTION_BLOCK_SIZE - 1) / GST_ZED_MOTION_BLOCK_SIZE;
+        gate->blocks_x = MIN(gate->blocks_x, GST_ZED_MOTION_MASK_MAX_BYTES * 8);
+        gate->blocks_y = MIN(gate->blocks_y, GST_ZED_MOTION_MASK_MAX_BYTES /
+                                                 ((gate->blocks_x + 7) / 8));
+        gate->stride = ((gate->blocks_x + 1) / 2) * 2 * THUMB_BLOCK;
+
+        // Zeroed: the padding past the frame edges never differs
+        gsize size = gate->stride * gate->blocks_y * THUMB_BLOCK;
+        for (guint i = 0; i < 2; i++) {
+            g_free(gate->thumbs[i]);
+            gate->thumbs[i] = static_cast<guint8 *>(g_malloc0(size));
+        }
+        gate->cur = 0;
+        gate->has_reference = FALSE;
+    }
+
+    gst_zed_image_stats_set_lowres(acc, frame, stride, gate->thumbs[gate->cur], gate->stride,
+                                   gate->blocks_x * THUMB_BLOCK, gate->blocks_y * THUMB_BLOCK);
+}
+
+guint gst_zed_motion_gate_compare(GstZedMotionGate *gate, guint threshold,
+                                  GstZedMotionMask *mask) {
+    const guint limit = threshold * THUMB_BLOCK * THUMB_BLOCK;
+    const guint8 *cur = gate->thumbs[gate->cur];
+    const guint8 *ref = gate->thumbs[gate->cur ^ 1];
+
+    mask->block_size = GST_ZED_MOTION_BLOCK_SIZE;
+    mask->blocks_x = gate->blocks_x;
+    mask->blocks_y = gate->blocks_y;
+    mask->row_bytes = (gate->blocks_x + 7) / 8;
+    mask->n_changed = 0;
+
+    memset(mask->bits, 0, mask->row_bytes * mask->blocks_y);
+    for (guint by = 0; by < gate->blocks_y; by++) {
+        gsize offset = by * THUMB_BLOCK * gate->stride;
+        guint8 *bits = mask->bits + by * mask->row_bytes;
+
+        for (guint bx = 0; bx < gate->blocks_x; bx += 2) {
+            guint sad[2];
+            gst_zed_motion_sad_pair(cur + offset + bx * THUMB_BLOCK,
+                                    ref + offset + bx * THUMB_BLOCK, gate->stride, sad);
+
+            for (guint k = 0; k < 2 && bx + k < gate->blocks_x; k++) {
+                if (!gate->has_reference || sad[k] > limit) {
+                    bits[(bx + k) / 8] |= 1 << ((bx + k) % 8);
+                    mask->n_changed++;
+                }
+            }
+        }
+    }
+
+    return mask->n_changed;
+}
+
+void gst_zed_motion_gate_commit(GstZedMotionGate *gate) {
+    gate->cur ^= 1;
+    gate->has_reference = TRUE;
+}
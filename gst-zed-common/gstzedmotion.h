@@ -0,0 +1,76 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+#ifndef _GST_ZED_MOTION_H_
+#define _GST_ZED_MOTION_H_
+
+#include <glib.h>
+
+#include "gstzedimagestats.h"
+
+G_BEGIN_DECLS
+
+/* Motion detection of the ZED source elements, telling the frames of a static scene.
+ *
+ * The copy engine writes a luma thumbnail of each frame while copying it (see
+ * `gst_zed_image_stats_set_lowres`). The thumbnail is then compared to the one of the
+ * reference frame, block by block: a block changes when the mean absolute difference of
+ * its pixels exceeds a threshold. The reference frame is the last one committed, so that
+ * slow changes add up until they are detected. */
+
+// Side of the blocks [output pixels]
+#define GST_ZED_MOTION_BLOCK_SIZE 32
+
+// Largest mask, enough for 32768 blocks (33 Mpixels frames) [bytes]
+#define GST_ZED_MOTION_MASK_MAX_BYTES 4096
+
+/* Changed blocks, one bit each: row major, each row of blocks starting on a new byte,
+ * block `u` of a row is bit `u % 8` of its byte `u / 8` */
+typedef struct {
+    guint block_size;   // Side of the blocks [pixels]
+    guint blocks_x;
+    guint blocks_y;
+    guint row_bytes;    // Bytes per row of blocks
+    guint n_changed;    // Changed blocks
+    guint8 bits[GST_ZED_MOTION_MASK_MAX_BYTES];
+} GstZedMotionMask;
+
+typedef struct _GstZedMotionGate GstZedMotionGate;
+
+GstZedMotionGate *gst_zed_motion_gate_new(void);
+
+void gst_zed_motion_gate_free(GstZedMotionGate *gate);
+
+/* Have the copies adding rows to `acc` write the thumbnail of the `width`x`height` frame
+ * starting at `frame`. A new frame size drops the reference frame */
+void gst_zed_motion_gate_begin(GstZedMotionGate *gate, GstZedImageStatsAccumulator *acc,
+                               const guint8 *frame, gsize stride, guint width, guint height);
+
+/* Compare the frame to the reference one, `threshold` being the mean absolute luma
+ * difference over which a block changes. Without reference frame every block changes.
+ * Returns the number of changed blocks */
+guint gst_zed_motion_gate_compare(GstZedMotionGate *gate, guint threshold, GstZedMotionMask *mask);
+
+/* Make the frame the reference one */
+void gst_zed_motion_gate_commit(GstZedMotionGate *gate);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_MOTION_H_
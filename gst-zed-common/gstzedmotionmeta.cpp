@@ -0,0 +1,103 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+#include "gstzedmotionmeta.h"
+
+#include <string.h>
+
+GType gst_zed_motion_meta_api_get_type(void) {
+    static gsize type_id = 0;
+    static const gchar *tags[] = {"video", NULL};
+
+    if (g_once_init_enter(&type_id)) {
+        // The static library is linked in each ZED plugin: the first one loaded registers
+        // the type, the others reuse it
+        GType type = g_type_from_name(GST_ZED_MOTION_META_API_NAME);
+        if (type == 0) {
+            type = gst_meta_api_type_register(GST_ZED_MOTION_META_API_NAME, tags);
+        }
+        g_once_init_leave(&type_id, type);
+    }
+
+    return type_id;
+}
+
+static gboolean gst_zed_motion_meta_init(GstMeta *meta, gpointer params, GstBuffer *buffer) {
+    GstZedMotionMeta *mmeta = reinterpret_cast<GstZedMotionMeta *>(meta);
+
+    (void) params;
+    (void) buffer;
+    mmeta->mask.block_size = GST_ZED_MOTION_BLOCK_SIZE;
+    mmeta->mask.blocks_x = 0;
+    mmeta->mask.blocks_y = 0;
+    mmeta->mask.row_bytes = 0;
+    mmeta->mask.n_changed = 0;
+
+    return TRUE;
+}
+
+static gboolean gst_zed_motion_meta_transform(GstBuffer *transbuf, GstMeta *meta,
+                                              GstBuffer *buffer, GQuark type, gpointer data) {
+    GstZedMotionMeta *mmeta = reinterpret_cast<GstZedMotionMeta *>(meta);
+
+    (void) buffer;
+    (void) data;
+
+    // Blocks located in the frame: only valid for its copies
+    if (!GST_META_TRANSFORM_IS_COPY(type)) {
+        return FALSE;
+    }
+
+    return gst_buffer_add_zed_motion_meta(transbuf, &mmeta->mask) != NULL;
+}
+
+const GstMetaInfo *gst_zed_motion_meta_get_info(void) {
+    static const GstMetaInfo *meta_info = NULL;
+
+    if (g_once_init_enter((GstMetaInfo **) &meta_info)) {
+        const GstMetaInfo *info = gst_meta_get_info(GST_ZED_MOTION_META_IMPL_NAME);
+        if (!info) {
+            info = gst_meta_register(GST_ZED_MOTION_META_API_TYPE, GST_ZED_MOTION_META_IMPL_NAME,
+                                     sizeof(GstZedMotionMeta), gst_zed_motion_meta_init, NULL,
+                                     gst_zed_motion_meta_transform);
+        }
+        g_once_init_leave((GstMetaInfo **) &meta_info, (GstMetaInfo *) info);
+    }
+
+    return meta_info;
+}
+
+GstZedMotionMeta *gst_buffer_add_zed_motion_meta(GstBuffer *buffer,
+                                                 const GstZedMotionMask *mask) {
+    GstZedMotionMeta *meta = reinterpret_cast<GstZedMotionMeta *>(
+        gst_buffer_add_meta(buffer, GST_ZED_MOTION_META_INFO, NULL));
+
+    if (meta) {
+        // Only the bytes of the mask in use
+        meta->mask.block_size = mask->block_size;
+        meta->mask.blocks_x = mask->blocks_x;
+        meta->mask.blocks_y = mask->blocks_y;
+        meta->mask.row_bytes = mask->row_bytes;
+        meta->mask.n_changed = mask->n_changed;
+        memcpy(meta->mask.bits, mask->bits, mask->row_bytes * mask->blocks_y);
+    }
+
+    return meta;
+}
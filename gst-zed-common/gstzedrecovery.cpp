@@ -0,0 +1,190 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedrecovery.h"
+
+typedef enum {
+    RECOVERY_RUNNING,   // Waiting for the next attempt, or in the SDK
+    RECOVERY_OPENED,
+    RECOVERY_FAILED,
+} GstZedRecoveryState;
+
+struct _GstZedRecovery {
+    GThread *thread;
+    GstZedOpenFunc open;
+    GstZedCloseFunc close;
+    gpointer camera;
+    GDestroyNotify camera_free;
+    gint min_delay;
+    gint max_delay;
+    gint max_attempts;
+
+    GMutex lock;
+    GCond cond;   // Any change of the fields below
+
+    // ----> Under the lock
+    GstZedRecoveryState state;
+    gint attempts;
+    gboolean busy;       // In the open or close function
+    gboolean flushing;   // Waits of the streaming thread interrupted
+    gboolean quit;
+    gboolean abandoned;   // Stop timed out: the recovery frees itself
+    // <---- Under the lock
+};
+
+static void gst_zed_recovery_destroy(GstZedRecovery *recovery) {
+    if (recovery->camera_free) {
+        recovery->camera_free(recovery->camera);
+    }
+    g_mutex_clear(&recovery->lock);
+    g_cond_clear(&recovery->cond);
+    g_free(recovery);
+}
+
+static gpointer gst_zed_recovery_thread(gpointer data) {
+    GstZedRecovery *recovery = static_cast<GstZedRecovery *>(data);
+    gint delay = recovery->min_delay;
+
+    recovery->close(recovery->camera);
+
+    g_mutex_lock(&recovery->lock);
+    recovery->busy = FALSE;
+    g_cond_broadcast(&recovery->cond);
+
+    gint64 end_time = g_get_monotonic_time() + delay * G_TIME_SPAN_MILLISECOND;
+    while (!recovery->quit) {
+        if (g_cond_wait_until(&recovery->cond, &recovery->lock, end_time)) {
+            continue;   // Woken up: check for quit and wait again
+        }
+        gint attempt = ++recovery->attempts;
+        recovery->busy = TRUE;
+        g_mutex_unlock(&recovery->lock);
+
+        gboolean opened = recovery->open(recovery->camera, attempt);
+        if (!opened) {
+            recovery->close(recovery->camera);
+        }
+
+        g_mutex_lock(&recovery->lock);
+        recovery->busy = FALSE;
+        if (opened) {
+            recovery->state = RECOVERY_OPENED;
+        } else if (recovery->max_attempts > 0 && attempt >= recovery->max_attempts) {
+            recovery->state = RECOVERY_FAILED;
+        }
+        g_cond_broadcast(&recovery->cond);
+        if (recovery->state != RECOVERY_RUNNING) {
+            break;
+        }
+
+        delay = MIN(delay * 2, recovery->max_delay);
+        end_time = g_get_monotonic_time() + delay * G_TIME_SPAN_MILLISECOND;
+    }
+    gboolean abandoned = recovery->abandoned;
+    g_mutex_unlock(&recovery->lock);
+
+    if (abandoned) {
+        gst_zed_recovery_destroy(recovery);
+    }
+
+    return NULL;
+}
+
+GstZedRecovery *gst_zed_recovery_new(const gchar *name, GstZedOpenFunc open,
+                                     GstZedCloseFunc close, gpointer camera,
+                                     GDestroyNotify camera_free, gint min_delay, gint max_delay,
+                                     gint max_attempts) {
+    GstZedRecovery *recovery = g_new0(GstZedRecovery, 1);
+
+    recovery->open = open;
+    recovery->close = close;
+    recovery->camera = camera;
+    recovery->camera_free = camera_free;
+    recovery->min_delay = min_delay;
+    recovery->max_delay = MAX(max_delay, min_delay);
+    recovery->max_attempts = max_attempts;
+    recovery->state = RECOVERY_RUNNING;
+    recovery->busy = TRUE;   // Closing the lost camera
+    g_mutex_init(&recovery->lock);
+    g_cond_init(&recovery->cond);
+
+    recovery->thread = g_thread_new(name, gst_zed_recovery_thread, recovery);
+
+    return recovery;
+}
+
+gboolean gst_zed_recovery_free(GstZedRecovery *recovery, gint64 timeout) {
+    gint64 end_time = g_get_monotonic_time() + timeout;
+
+    g_mutex_lock(&recovery->lock);
+    recovery->quit = TRUE;
+    g_cond_broadcast(&recovery->cond);
+
+    while (recovery->busy) {
+        if (!g_cond_wait_until(&recovery->cond, &recovery->lock, end_time)) {
+            break;
+        }
+    }
+    recovery->abandoned = recovery->busy;
+    gboolean abandoned = recovery->abandoned;
+    GThread *thread = recovery->thread;   // `recovery` may be freed once unlocked
+    g_mutex_unlock(&recovery->lock);
+
+    if (abandoned) {
+        g_thread_unref(thread);
+        return FALSE;
+    }
+
+    g_thread_join(thread);
+    gst_zed_recovery_destroy(recovery);
+
+    return TRUE;
+}
+
+GstZedRecoveryResult gst_zed_recovery_wait(GstZedRecovery *recovery, gint64 end_time,
+                                           gint *attempts) {
+    GstZedRecoveryResult result = GST_ZED_RECOVERY_PENDING;
+
+    g_mutex_lock(&recovery->lock);
+    while (!recovery->flushing && recovery->state == RECOVERY_RUNNING) {
+        if (!g_cond_wait_until(&recovery->cond, &recovery->lock, end_time)) {
+            break;
+        }
+    }
+    if (recovery->flushing) {
+        result = GST_ZED_RECOVERY_FLUSHING;
+    } else if (recovery->state == RECOVERY_OPENED) {
+        result = GST_ZED_RECOVERY_DONE;
+    } else if (recovery->state == RECOVERY_FAILED) {
+        result = GST_ZED_RECOVERY_FAILED;
+    }
+    *attempts = recovery->attempts;
+    g_mutex_unlock(&recovery->lock);
+
+    return result;
+}
+
+void gst_zed_recovery_set_flushing(GstZedRecovery *recovery, gboolean flushing) {
+    g_mutex_lock(&recovery->lock);
+    recovery->flushing = flushing;
+    g_cond_broadcast(&recovery->cond);
+    g_mutex_unlock(&recovery->lock);
+}
@@ -0,0 +1,71 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_RECOVERY_H_
+#define _GST_ZED_RECOVERY_H_
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Thread re-opening a camera lost by a ZED source element, with an exponential
+ * backoff between the attempts. The thread only works on the camera handed to
+ * `gst_zed_recovery_new`, never on the element: a recovery blocked in the SDK open
+ * call is abandoned by `gst_zed_recovery_free`, so that a state change never waits
+ * for a camera that takes seconds to answer. */
+
+typedef struct _GstZedRecovery GstZedRecovery;
+
+/* Open the camera, called from the recovery thread. Returns TRUE on success. */
+typedef gboolean (*GstZedOpenFunc)(gpointer camera, gint attempt);
+
+/* Close the camera, called before the first attempt and after each failed one */
+typedef void (*GstZedCloseFunc)(gpointer camera);
+
+typedef enum {
+    GST_ZED_RECOVERY_PENDING,    // Camera not opened yet
+    GST_ZED_RECOVERY_DONE,       // Camera opened
+    GST_ZED_RECOVERY_FAILED,     // Maximum number of attempts reached
+    GST_ZED_RECOVERY_FLUSHING,   // Interrupted by `gst_zed_recovery_set_flushing`
+} GstZedRecoveryResult;
+
+/* Start re-opening `camera`, first after `min_delay` [msec], then doubling the
+ * delay up to `max_delay` [msec]. `max_attempts` is 0 for unlimited attempts. */
+GstZedRecovery *gst_zed_recovery_new(const gchar *name, GstZedOpenFunc open,
+                                     GstZedCloseFunc close, gpointer camera,
+                                     GDestroyNotify camera_free, gint min_delay, gint max_delay,
+                                     gint max_attempts);
+
+/* Stop the recovery, waiting at most `timeout` [usec] for the attempt in progress.
+ * `camera_free(camera)` is called right away when TRUE is returned, otherwise from
+ * the recovery thread when the blocked attempt returns. */
+gboolean gst_zed_recovery_free(GstZedRecovery *recovery, gint64 timeout);
+
+/* Wait for the end of the recovery until `end_time` [monotonic usec], the number
+ * of attempts made so far is returned in `attempts` */
+GstZedRecoveryResult gst_zed_recovery_wait(GstZedRecovery *recovery, gint64 end_time,
+                                           gint *attempts);
+
+void gst_zed_recovery_set_flushing(GstZedRecovery *recovery, gboolean flushing);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_RECOVERY_H_
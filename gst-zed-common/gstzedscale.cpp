@@ -0,0 +1,224 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedscale.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GST_ZED_SCALE_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GST_ZED_SCALE_SSE2
+#endif
+
+// Area filter limits: the vertical sums of a chunk must fit the 16 bits accumulator
+#define AREA_MAX_FACTOR  16
+#define AREA_CHUNK_BYTES (64 * AREA_MAX_FACTOR * 4)
+
+gboolean gst_zed_parse_size(const gchar *str, guint *width, guint *height) {
+    guint w = 0, h = 0;
+    gchar end;
+
+    if (str && *str && (sscanf(str, "%ux%u%c", &w, &h, &end) != 2 || w == 0 || h == 0)) {
+        return FALSE;
+    }
+
+    *width = w;
+    *height = h;
+    return TRUE;
+}
+
+/* Sum `rows` rows of `bytes` bytes, one accumulator per byte */
+static void gst_zed_scale_sum_rows(guint16 *acc, const guint8 *in, gsize stride, guint bytes,
+                                   guint rows) {
+    guint i = 0;
+
+#if defined(GST_ZED_SCALE_NEON)
+    for (; i + 16 <= bytes; i += 16) {
+        uint8x16_t px = vld1q_u8(in + i);
+        uint16x8_t lo = vmovl_u8(vget_low_u8(px));
+        uint16x8_t hi = vmovl_u8(vget_high_u8(px));
+        for (guint r = 1; r < rows; r++) {
+            px = vld1q_u8(in + r * stride + i);
+            lo = vaddw_u8(lo, vget_low_u8(px));
+            hi = vaddw_u8(hi, vget_high_u8(px));
+        }
+        vst1q_u16(acc + i, lo);
+        vst1q_u16(acc + i + 8, hi);
+    }
+#elif defined(GST_ZED_SCALE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= bytes; i += 16) {
+        __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        __m128i lo = _mm_unpacklo_epi8(px, zero);
+        __m128i hi = _mm_unpackhi_epi8(px, zero);
+        for (guint r = 1; r < rows; r++) {
+            px = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + r * stride + i));
+            lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(px, zero));
+            hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(px, zero));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(acc + i + 8), hi);
+    }
+#endif
+
+    for (; i < bytes; i++) {
+        guint16 sum = 0;
+        for (guint r = 0; r < rows; r++) {
+            sum += in[r * stride + i];
+        }
+        acc[i] = sum;
+    }
+}
+
+/* Average `fx`x`fy` blocks into one output row */
+static void gst_zed_scale_area_row(const guint8 *in, gsize stride, guint channels, guint8 *out,
+                                   guint dst_w, guint fx, guint fy) {
+    guint16 acc[AREA_CHUNK_BYTES];
+    const guint16 half = (fx * fy) / 2;
+    const guint16 recip = ((1u << 16) + half) / (fx * fy);   // 1/area, 16 bits fixed point
+    const guint chunk = AREA_CHUNK_BYTES / (fx * channels);  // Output pixels per chunk
+
+    for (guint u0 = 0; u0 < dst_w; u0 += chunk) {
+        guint n = MIN(chunk, dst_w - u0);
+        guint8 *res = out + u0 * channels;
+        guint u = 0;
+
+        gst_zed_scale_sum_rows(acc, in + u0 * fx * channels, stride, n * fx * channels, fy);
+
+        // The block sums fit 16 bits: at most 16x16 pixels
+        if (channels == 4) {
+#if defined(GST_ZED_SCALE_NEON)
+            for (; u < n; u++) {
+                const guint16 *block = acc + u * fx * 4;
+                uint16x4_t sum = vdup_n_u16(half);
+                for (guint k = 0; k < fx; k++) {
+                    sum = vadd_u16(sum, vld1_u16(block + 4 * k));
+                }
+                uint16x4_t avg = vshrn_n_u32(vmull_n_u16(sum, recip), 16);
+                uint8x8_t px = vmovn_u16(vcombine_u16(avg, avg));
+                vst1_lane_u32(reinterpret_cast<uint32_t *>(res + 4 * u), vreinterpret_u32_u8(px),
+                              0);
+            }
+#elif defined(GST_ZED_SCALE_SSE2)
+            const __m128i vhalf = _mm_set1_epi16(half);
+            const __m128i vrecip = _mm_set1_epi16(static_cast<short>(recip));
+            for (; u < n; u++) {
+                const guint16 *block = acc + u * fx * 4;
+                __m128i sum = vhalf;
+                for (guint k = 0; k < fx; k++) {
+                    sum = _mm_add_epi16(
+                        sum, _mm_loadl_epi64(reinterpret_cast<const __m128i *>(block + 4 * k)));
+                }
+                __m128i avg = _mm_mulhi_epu16(sum, vrecip);
+                gint32 px = _mm_cvtsi128_si32(_mm_packus_epi16(avg, avg));
+                memcpy(res + 4 * u, &px, 4);
+            }
+#endif
+        }
+
+        for (; u < n; u++) {
+            const guint16 *block = acc + u * fx * channels;
+            for (guint c = 0; c < channels; c++) {
+                guint32 sum = half;
+                for (guint k = 0; k < fx; k++) {
+                    sum += block[k * channels + c];
+                }
+                res[u * channels + c] = static_cast<guint8>((sum * recip) >> 16);
+            }
+        }
+    }
+}
+
+/* Bilinear interpolation of one output row, source position in 16 bits fixed point */
+static void gst_zed_scale_bilinear_row(const guint8 *top, const guint8 *bottom, guint wy,
+                                       guint channels, guint src_w, guint8 *out, guint dst_w,
+                                       gint32 x_start, gint32 x_step) {
+    gint32 x = x_start;
+
+    for (guint u = 0; u < dst_w; u++, x += x_step) {
+        gint32 xc = MAX(x, 0);
+        guint x0 = xc >> 16;
+        guint x1 = MIN(x0 + 1, src_w - 1);
+        guint wx = (xc >> 8) & 0xFF;
+
+        for (guint c = 0; c < channels; c++) {
+            guint t = top[x0 * channels + c] * (256 - wx) + top[x1 * channels + c] * wx;
+            guint b = bottom[x0 * channels + c] * (256 - wx) + bottom[x1 * channels + c] * wx;
+            out[u * channels + c] = static_cast<guint8>((t * (256 - wy) + b * wy + 0x8000) >> 16);
+        }
+    }
+}
+
+void gst_zed_scale_image(const guint8 *src, gsize src_stride, guint src_w, guint src_h,
+                         guint channels, guint8 *dst, gsize dst_stride, guint dst_w, guint dst_h,
+                         GstZedConvertFunc convert) {
+    gst_zed_scale_image_rows(src, src_stride, src_w, src_h, channels, dst, dst_stride, dst_w, dst_h,
+                             convert, 0, dst_h);
+}
+
+void gst_zed_scale_image_rows(const guint8 *src, gsize src_stride, guint src_w, guint src_h,
+                              guint channels, guint8 *dst, gsize dst_stride, guint dst_w,
+                              guint dst_h, GstZedConvertFunc convert, guint first_row,
+                              guint n_rows) {
+    guint8 row[GST_ZED_SCALE_MAX_WIDTH * 4];   // Scaled row waiting for conversion
+
+    g_return_if_fail(channels == 1 || channels == 4);
+    g_return_if_fail(dst_w > 0 && dst_w <= GST_ZED_SCALE_MAX_WIDTH && dst_h > 0);
+    g_return_if_fail(first_row + n_rows <= dst_h);
+
+    if (channels != 4) {
+        convert = NULL;
+    }
+
+    // Pixel centers are aligned: the first output pixel covers [0, step)
+    const gint32 x_step = static_cast<gint32>((static_cast<guint64>(src_w) << 16) / dst_w);
+    const gint32 y_step = static_cast<gint32>((static_cast<guint64>(src_h) << 16) / dst_h);
+    const gboolean area = (src_w % dst_w == 0 && src_h % dst_h == 0 &&
+                           src_w / dst_w <= AREA_MAX_FACTOR && src_h / dst_h <= AREA_MAX_FACTOR &&
+                           src_w * src_h > dst_w * dst_h);
+    gint32 y = y_step / 2 - 0x8000 + static_cast<gint32>(first_row) * y_step;
+
+    for (guint v = first_row; v < first_row + n_rows; v++, y += y_step) {
+        guint8 *out = dst + v * dst_stride;
+        guint8 *res = convert ? row : out;
+
+        if (area) {
+            guint fy = src_h / dst_h;
+            gst_zed_scale_area_row(src + v * fy * src_stride, src_stride, channels, res, dst_w,
+                                   src_w / dst_w, fy);
+        } else {
+            gint32 yc = MAX(y, 0);
+            guint y0 = yc >> 16;
+            guint y1 = MIN(y0 + 1, src_h - 1);
+            gst_zed_scale_bilinear_row(src + y0 * src_stride, src + y1 * src_stride,
+                                       (yc >> 8) & 0xFF, channels, src_w, res, dst_w,
+                                       x_step / 2 - 0x8000, x_step);
+        }
+
+        if (convert) {
+            convert(row, dst_w * 4, out, dst_stride, dst_w, 1);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_SCALE_H_
+#define _GST_ZED_SCALE_H_
+
+#include <glib.h>
+
+#include "gstzedconvert.h"
+
+G_BEGIN_DECLS
+
+/* Largest output width supported by `gst_zed_scale_image` [pixels] */
+#define GST_ZED_SCALE_MAX_WIDTH 4096
+
+/* Parse a "WxH" size. An empty or NULL string is valid and gives 0x0 (no scaling) */
+gboolean gst_zed_parse_size(const gchar *str, guint *width, guint *height);
+
+/* Downscale the `src_w`x`src_h` image `src`, with `channels` bytes per pixel (1 or 4),
+ * to `dst_w`x`dst_h`. Integer factors use an area filter, other ratios a bilinear filter.
+ *
+ * With a 4 channels source, `convert` (may be NULL) is applied to each scaled row before
+ * it is stored, so the output is written once, directly in the negotiated format. */
+void gst_zed_scale_image(const guint8 *src, gsize src_stride, guint src_w, guint src_h,
+                         guint channels, guint8 *dst, gsize dst_stride, guint dst_w, guint dst_h,
+                         GstZedConvertFunc convert);
+
+/* Same as `gst_zed_scale_image`, producing only the `n_rows` output rows starting at
+ * `first_row`: `dst` still points to the first row of the whole output image */
+void gst_zed_scale_image_rows(const guint8 *src, gsize src_stride, guint src_w, guint src_h,
+                              guint channels, guint8 *dst, gsize dst_stride, guint dst_w,
+                              guint dst_h, GstZedConvertFunc convert, guint first_row,
+                              guint n_rows);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_SCALE_H_
@@ -0,0 +1,140 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedthread.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+#ifdef __linux__
+typedef struct {
+    gpointer data;
+    gsize size;
+} GstZedLockedRange;
+
+static void gst_zed_unlock_range(gpointer data) {
+    GstZedLockedRange *range = static_cast<GstZedLockedRange *>(data);
+
+    munlock(range->data, range->size);
+    g_free(range);
+}
+
+static GQuark gst_zed_locked_quark(void) {
+    static GQuark quark = 0;
+
+    if (g_once_init_enter(&quark)) {
+        g_once_init_leave(&quark, g_quark_from_static_string("GstZedLockedMemory"));
+    }
+    return quark;
+}
+#endif
+
+gboolean gst_zed_thread_setup(gint priority, guint64 cpu_mask, GstZedThreadStatus *status) {
+    gboolean ret = TRUE;
+
+    status->realtime = FALSE;
+    status->priority = 0;
+    status->cpu_mask = 0;
+
+#ifdef __linux__
+    pthread_t self = pthread_self();
+    struct sched_param param;
+    int policy;
+
+    if (priority > 0) {
+        param.sched_priority = CLAMP(priority, sched_get_priority_min(SCHED_FIFO),
+                                     sched_get_priority_max(SCHED_FIFO));
+        ret &= (pthread_setschedparam(self, SCHED_FIFO, &param) == 0);
+    }
+
+    if (cpu_mask != 0) {
+        cpu_set_t cpus;
+
+        CPU_ZERO(&cpus);
+        for (guint cpu = 0; cpu < 64; cpu++) {
+            if (cpu_mask & (G_GUINT64_CONSTANT(1) << cpu)) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        ret &= (pthread_setaffinity_np(self, sizeof(cpus), &cpus) == 0);
+    }
+
+    // ----> Scheduling in place
+    if (pthread_getschedparam(self, &policy, &param) == 0 && policy == SCHED_FIFO) {
+        status->realtime = TRUE;
+        status->priority = param.sched_priority;
+    }
+
+    cpu_set_t cpus;
+    if (pthread_getaffinity_np(self, sizeof(cpus), &cpus) == 0) {
+        for (guint cpu = 0; cpu < 64; cpu++) {
+            if (CPU_ISSET(cpu, &cpus)) {
+                status->cpu_mask |= G_GUINT64_CONSTANT(1) << cpu;
+            }
+        }
+    }
+    // <---- Scheduling in place
+#else
+    ret = (priority <= 0 && cpu_mask == 0);
+#endif
+
+    return ret;
+}
+
+gboolean gst_zed_buffer_lock_memory(GstBuffer *buffer) {
+#ifdef __linux__
+    GQuark quark = gst_zed_locked_quark();
+
+    for (guint i = 0; i < gst_buffer_n_memory(buffer); i++) {
+        GstMemory *mem = gst_buffer_peek_memory(buffer, i);
+        GstMapInfo info;
+
+        if (gst_mini_object_get_qdata(GST_MINI_OBJECT_CAST(mem), quark)) {
+            continue;   // Already locked
+        }
+        if (!gst_memory_map(mem, &info, GST_MAP_READ)) {
+            return FALSE;
+        }
+
+        // System memory maps to its own storage: the range stays valid until it is freed
+        gboolean locked = (mlock(info.data, info.size) == 0);
+        if (locked) {
+            GstZedLockedRange *range = g_new(GstZedLockedRange, 1);
+            range->data = info.data;
+            range->size = info.size;
+            gst_mini_object_set_qdata(GST_MINI_OBJECT_CAST(mem), quark, range,
+                                      gst_zed_unlock_range);
+        }
+        gst_memory_unmap(mem, &info);
+
+        if (!locked) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+#else
+    (void) buffer;
+    return FALSE;
+#endif
+}
@@ -0,0 +1,53 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_THREAD_H_
+#define _GST_ZED_THREAD_H_
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+/* Real-time settings of the capture path shared by the ZED source elements.
+ * Real-time scheduling and memory locking are only available on Linux, where they
+ * require the CAP_SYS_NICE and CAP_IPC_LOCK capabilities (or matching rlimits). */
+
+/* Scheduling achieved by `gst_zed_thread_setup` */
+typedef struct {
+    gboolean realtime;   // SCHED_FIFO policy applied
+    gint priority;       // Real-time priority, 0 for the normal policy
+    guint64 cpu_mask;    // CPUs the thread can run on, 0 if unknown
+} GstZedThreadStatus;
+
+/* Move the calling thread to the SCHED_FIFO policy with `priority` (1-99, 0 to
+ * keep the current policy) and restrict it to the CPUs of `cpu_mask` (bit N for
+ * CPU N, 0 to keep the current affinity). `status` receives the scheduling
+ * actually in place afterwards. Returns FALSE if a setting was refused. */
+gboolean gst_zed_thread_setup(gint priority, guint64 cpu_mask, GstZedThreadStatus *status);
+
+/* Lock the memories of `buffer` in RAM so that writing them never page faults.
+ * Pooled memories are locked once and unlocked when freed. Returns FALSE if the
+ * memory could not be locked. */
+gboolean gst_zed_buffer_lock_memory(GstBuffer *buffer);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_THREAD_H_
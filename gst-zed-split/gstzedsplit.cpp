@@ -0,0 +1,532 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+#include "gstzedsplit.h"
+#include "gst-zed-common/gstzedconvert.h"
+
+GST_DEBUG_CATEGORY(gst_zedsplit_debug);
+#define GST_CAT_DEFAULT gst_zedsplit_debug
+
+/* prototypes */
+static void gst_zedsplit_set_property(GObject *object, guint property_id, const GValue *value,
+                                      GParamSpec *pspec);
+static void gst_zedsplit_get_property(GObject *object, guint property_id, GValue *value,
+                                      GParamSpec *pspec);
+static void gst_zedsplit_finalize(GObject *object);
+
+static GstStateChangeReturn gst_zedsplit_change_state(GstElement *element,
+                                                      GstStateChange transition);
+
+static gboolean gst_zedsplit_sink_event(GstPad *pad, GstObject *parent, GstEvent *event);
+static gboolean gst_zedsplit_sink_query(GstPad *pad, GstObject *parent, GstQuery *query);
+static GstFlowReturn gst_zedsplit_chain(GstPad *pad, GstObject *parent, GstBuffer *buf);
+
+enum {
+    PROP_0,
+    PROP_LAYOUT,
+    N_PROPERTIES
+};
+
+typedef enum {
+    GST_ZEDSPLIT_SIDE_BY_SIDE = 0,
+    GST_ZEDSPLIT_TOP_BOTTOM = 1
+} GstZedSplitLayout;
+
+#define DEFAULT_PROP_LAYOUT GST_ZEDSPLIT_SIDE_BY_SIDE
+
+#define GST_TYPE_ZED_SPLIT_LAYOUT (gst_zedsplit_layout_get_type())
+static GType gst_zedsplit_layout_get_type(void) {
+    static GType zedsplit_layout_type = 0;
+
+    if (!zedsplit_layout_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDSPLIT_SIDE_BY_SIDE, "Views side by side (double width)", "Side-by-side"},
+            {GST_ZEDSPLIT_TOP_BOTTOM, "Views stacked (double height)", "Top-bottom"},
+            {0, NULL, NULL},
+        };
+
+        zedsplit_layout_type = g_enum_register_static("GstZedSplitLayout", pattern_types);
+    }
+
+    return zedsplit_layout_type;
+}
+
+#define GST_ZEDSPLIT_FORMATS "{ BGRA, BGR, RGB, GRAY8, GRAY16_LE }"
+
+/* pad templates */
+static GstStaticPadTemplate sink_template =
+    GST_STATIC_PAD_TEMPLATE("sink", GST_PAD_SINK, GST_PAD_ALWAYS,
+                            GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(GST_ZEDSPLIT_FORMATS)));
+
+static GstStaticPadTemplate src_left_template =
+    GST_STATIC_PAD_TEMPLATE("src_left", GST_PAD_SRC, GST_PAD_ALWAYS,
+                            GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(GST_ZEDSPLIT_FORMATS)));
+
+static GstStaticPadTemplate src_right_template =
+    GST_STATIC_PAD_TEMPLATE("src_right", GST_PAD_SRC, GST_PAD_ALWAYS,
+                            GST_STATIC_CAPS(GST_VIDEO_CAPS_MAKE(GST_ZEDSPLIT_FORMATS)));
+
+/* class initialization */
+G_DEFINE_TYPE(GstZedSplit, gst_zedsplit, GST_TYPE_ELEMENT);
+
+static void gst_zedsplit_class_init(GstZedSplitClass *klass) {
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+    GstElementClass *gstelement_class = GST_ELEMENT_CLASS(klass);
+
+    gobject_class->set_property = gst_zedsplit_set_property;
+    gobject_class->get_property = gst_zedsplit_get_property;
+    gobject_class->finalize = gst_zedsplit_finalize;
+
+    gstelement_class->change_state = GST_DEBUG_FUNCPTR(gst_zedsplit_change_state);
+
+    gst_element_class_add_pad_template(gstelement_class,
+                                       gst_static_pad_template_get(&sink_template));
+    gst_element_class_add_pad_template(gstelement_class,
+                                       gst_static_pad_template_get(&src_left_template));
+    gst_element_class_add_pad_template(gstelement_class,
+                                       gst_static_pad_template_get(&src_right_template));
+
+    gst_element_class_set_static_metadata(
+        gstelement_class, "ZED Composite Frame Splitter", "Demuxer/Video",
+        "Splits a ZED side-by-side or stacked frame in two streams without copying the pixels",
+        "Stereolabs <support@stereolabs.com>");
+
+    /* Install GObject properties */
+    g_object_class_install_property(
+        gobject_class, PROP_LAYOUT,
+        g_param_spec_enum("layout", "Frame layout", "Layout of the two views in the input frame",
+                          GST_TYPE_ZED_SPLIT_LAYOUT, DEFAULT_PROP_LAYOUT,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+}
+
+static void gst_zedsplit_init(GstZedSplit *filter) {
+    filter->sinkpad = gst_pad_new_from_static_template(&sink_template, "sink");
+    gst_pad_set_event_function(filter->sinkpad, GST_DEBUG_FUNCPTR(gst_zedsplit_sink_event));
+    gst_pad_set_query_function(filter->sinkpad, GST_DEBUG_FUNCPTR(gst_zedsplit_sink_query));
+    gst_pad_set_chain_function(filter->sinkpad, GST_DEBUG_FUNCPTR(gst_zedsplit_chain));
+    gst_element_add_pad(GST_ELEMENT(filter), filter->sinkpad);
+
+    filter->srcpad_left = gst_pad_new_from_static_template(&src_left_template, "src_left");
+    gst_pad_use_fixed_caps(filter->srcpad_left);
+    gst_element_add_pad(GST_ELEMENT(filter), filter->srcpad_left);
+
+    filter->srcpad_right = gst_pad_new_from_static_template(&src_right_template, "src_right");
+    gst_pad_use_fixed_caps(filter->srcpad_right);
+    gst_element_add_pad(GST_ELEMENT(filter), filter->srcpad_right);
+
+    filter->flow_combiner = gst_flow_combiner_new();
+    gst_flow_combiner_add_pad(filter->flow_combiner, filter->srcpad_left);
+    gst_flow_combiner_add_pad(filter->flow_combiner, filter->srcpad_right);
+
+    filter->layout = DEFAULT_PROP_LAYOUT;
+
+    gst_video_info_init(&filter->in_info);
+    gst_video_info_init(&filter->out_info);
+}
+
+void gst_zedsplit_set_property(GObject *object, guint property_id, const GValue *value,
+                               GParamSpec *pspec) {
+    GstZedSplit *filter = GST_ZED_SPLIT(object);
+
+    GST_DEBUG_OBJECT(filter, "Set property");
+
+    switch (property_id) {
+    case PROP_LAYOUT:
+        filter->layout = g_value_get_enum(value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+        break;
+    }
+}
+
+void gst_zedsplit_get_property(GObject *object, guint property_id, GValue *value,
+                               GParamSpec *pspec) {
+    GstZedSplit *filter = GST_ZED_SPLIT(object);
+
+    GST_DEBUG_OBJECT(filter, "Get property");
+
+    switch (property_id) {
+    case PROP_LAYOUT:
+        g_value_set_enum(value, filter->layout);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
+        break;
+    }
+}
+
+void gst_zedsplit_finalize(GObject *object) {
+    GstZedSplit *filter = GST_ZED_SPLIT(object);
+
+    GST_DEBUG_OBJECT(filter, "finalize");
+
+    gst_flow_combiner_free(filter->flow_combiner);
+
+    G_OBJECT_CLASS(gst_zedsplit_parent_class)->finalize(object);
+}
+
+static GstStateChangeReturn gst_zedsplit_change_state(GstElement *element,
+                                                      GstStateChange transition) {
+    GstZedSplit *filter = GST_ZED_SPLIT(element);
+    GstStateChangeReturn ret =
+        GST_ELEMENT_CLASS(gst_zedsplit_parent_class)->change_state(element, transition);
+
+    if (transition == GST_STATE_CHANGE_PAUSED_TO_READY) {
+        gst_flow_combiner_reset(filter->flow_combiner);
+        gst_video_info_init(&filter->in_info);
+        gst_video_info_init(&filter->out_info);
+    }
+
+    return ret;
+}
+
+/* Compute the caps of each half of the composite frame and push them downstream */
+static gboolean gst_zedsplit_set_caps(GstZedSplit *filter, GstCaps *caps) {
+    GstVideoInfo in_info;
+    GstVideoInfo out_info;
+    guint width, height;
+
+    if (!gst_video_info_from_caps(&in_info, caps)) {
+        GST_ERROR_OBJECT(filter, "Unsupported caps: %" GST_PTR_FORMAT, caps);
+        return FALSE;
+    }
+
+    width = GST_VIDEO_INFO_WIDTH(&in_info);
+    height = GST_VIDEO_INFO_HEIGHT(&in_info);
+    if (filter->layout == GST_ZEDSPLIT_SIDE_BY_SIDE) {
+        width /= 2;
+    } else {
+        height /= 2;
+    }
+
+    if (width == 0 || height == 0) {
+        GST_ERROR_OBJECT(filter, "Frame too small to be split: %" GST_PTR_FORMAT, caps);
+        return FALSE;
+    }
+
+    gst_video_info_set_format(&out_info, GST_VIDEO_INFO_FORMAT(&in_info), width, height);
+    GST_VIDEO_INFO_FPS_N(&out_info) = GST_VIDEO_INFO_FPS_N(&in_info);
+    GST_VIDEO_INFO_FPS_D(&out_info) = GST_VIDEO_INFO_FPS_D(&in_info);
+    GST_VIDEO_INFO_PAR_N(&out_info) = GST_VIDEO_INFO_PAR_N(&in_info);
+    GST_VIDEO_INFO_PAR_D(&out_info) = GST_VIDEO_INFO_PAR_D(&in_info);
+
+    filter->in_info = in_info;
+    filter->out_info = out_info;
+    filter->need_allocation = TRUE;
+
+    GstCaps *out_caps = gst_video_info_to_caps(&out_info);
+    GST_DEBUG_OBJECT(filter, "Output caps %" GST_PTR_FORMAT, out_caps);
+
+    gboolean ret = gst_pad_push_event(filter->srcpad_left, gst_event_new_caps(out_caps));
+    ret &= gst_pad_push_event(filter->srcpad_right, gst_event_new_caps(out_caps));
+    gst_caps_unref(out_caps);
+
+    return ret;
+}
+
+/* Give each source pad its own stream, in the group of the input stream */
+static gboolean gst_zedsplit_push_stream_start(GstZedSplit *filter, GstEvent *event) {
+    gboolean ret = TRUE;
+    guint group_id;
+    gboolean has_group = gst_event_parse_group_id(event, &group_id);
+    GstPad *srcpads[] = {filter->srcpad_left, filter->srcpad_right};
+    const gchar *names[] = {"left", "right"};
+
+    for (guint i = 0; i < G_N_ELEMENTS(srcpads); i++) {
+        gchar *stream_id = gst_pad_create_stream_id(srcpads[i], GST_ELEMENT(filter), names[i]);
+        GstEvent *start = gst_event_new_stream_start(stream_id);
+        if (has_group) {
+            gst_event_set_group_id(start, group_id);
+        }
+        ret &= gst_pad_push_event(srcpads[i], start);
+        g_free(stream_id);
+    }
+
+    gst_event_unref(event);
+    return ret;
+}
+
+static gboolean gst_zedsplit_sink_event(GstPad *pad, GstObject *parent, GstEvent *event) {
+    GstZedSplit *filter = GST_ZED_SPLIT(parent);
+    gboolean ret;
+
+    GST_LOG_OBJECT(filter, "Received %s event: %" GST_PTR_FORMAT, GST_EVENT_TYPE_NAME(event),
+                   event);
+
+    switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_STREAM_START:
+        ret = gst_zedsplit_push_stream_start(filter, event);
+        break;
+    case GST_EVENT_CAPS: {
+        GstCaps *caps;
+        gst_event_parse_caps(event, &caps);
+        ret = gst_zedsplit_set_caps(filter, caps);
+        gst_event_unref(event);
+        break;
+    }
+    case GST_EVENT_FLUSH_STOP:
+        gst_flow_combiner_reset(filter->flow_combiner);
+        ret = gst_pad_event_default(pad, parent, event);
+        break;
+    default:
+        ret = gst_pad_event_default(pad, parent, event);
+        break;
+    }
+
+    return ret;
+}
+
+/* Double the `field` dimension of `s`. Values without a double, lists included, leave the
+ * dimension unconstrained. */
+static void gst_zedsplit_double_field(GstStructure *s, const gchar *field) {
+    const GValue *val = gst_structure_get_value(s, field);
+
+    if (!val) {
+        return;
+    }
+
+    if (G_VALUE_HOLDS_INT(val) && g_value_get_int(val) <= G_MAXINT / 2) {
+        gst_structure_set(s, field, G_TYPE_INT, 2 * g_value_get_int(val), NULL);
+    } else if (GST_VALUE_HOLDS_INT_RANGE(val)) {
+        gint step = gst_value_get_int_range_step(val);
+        gint min = gst_value_get_int_range_min(val);
+        gint max = MIN(gst_value_get_int_range_max(val), G_MAXINT / 2 / step * step);
+
+        if (min < max) {
+            GValue range = G_VALUE_INIT;
+            g_value_init(&range, GST_TYPE_INT_RANGE);
+            gst_value_set_int_range_step(&range, 2 * min, 2 * max, 2 * step);
+            gst_structure_take_value(s, field, &range);
+        } else if (min == max) {
+            gst_structure_set(s, field, G_TYPE_INT, 2 * min, NULL);
+        } else {
+            gst_structure_remove_field(s, field);
+        }
+    } else {
+        gst_structure_remove_field(s, field);
+    }
+}
+
+/* Input caps accepted downstream of both source pads: the caps of a view with the width,
+ * or the height, doubled by the layout */
+static GstCaps *gst_zedsplit_peer_caps(GstZedSplit *filter) {
+    GstCaps *left = gst_pad_peer_query_caps(filter->srcpad_left, NULL);
+    GstCaps *right = gst_pad_peer_query_caps(filter->srcpad_right, NULL);
+    GstCaps *caps = gst_caps_intersect(left, right);
+    gst_caps_unref(left);
+    gst_caps_unref(right);
+
+    if (gst_caps_is_any(caps) || gst_caps_is_empty(caps)) {
+        return caps;
+    }
+
+    const gchar *field = (filter->layout == GST_ZEDSPLIT_SIDE_BY_SIDE) ? "width" : "height";
+    caps = gst_caps_make_writable(caps);
+    for (guint i = 0; i < gst_caps_get_size(caps); i++) {
+        gst_zedsplit_double_field(gst_caps_get_structure(caps, i), field);
+    }
+
+    return caps;
+}
+
+static gboolean gst_zedsplit_sink_query(GstPad *pad, GstObject *parent, GstQuery *query) {
+    GstZedSplit *filter = GST_ZED_SPLIT(parent);
+
+    GST_LOG_OBJECT(filter, "Received %s query", GST_QUERY_TYPE_NAME(query));
+
+    switch (GST_QUERY_TYPE(query)) {
+    case GST_QUERY_CAPS: {
+        // Downstream caps describe the views, in the order preferred downstream
+        GstCaps *filt;
+        GstCaps *templ = gst_pad_get_pad_template_caps(pad);
+        GstCaps *peer = gst_zedsplit_peer_caps(filter);
+        GstCaps *caps = gst_caps_intersect_full(peer, templ, GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref(peer);
+        gst_caps_unref(templ);
+
+        gst_query_parse_caps(query, &filt);
+        if (filt) {
+            GstCaps *tmp = gst_caps_intersect_full(filt, caps, GST_CAPS_INTERSECT_FIRST);
+            gst_caps_unref(caps);
+            caps = tmp;
+        }
+        gst_query_set_caps_result(query, caps);
+        gst_caps_unref(caps);
+        return TRUE;
+    }
+    case GST_QUERY_ALLOCATION:
+        // Input strides are read from the video meta of the incoming buffers
+        gst_query_add_allocation_meta(query, GST_VIDEO_META_API_TYPE, NULL);
+        return TRUE;
+    default:
+        return gst_pad_query_default(pad, parent, query);
+    }
+}
+
+/* Check with an allocation query if downstream of `srcpad` handles GstVideoMeta strides */
+static gboolean gst_zedsplit_peer_video_meta(GstZedSplit *filter, GstPad *srcpad) {
+    GstCaps *caps = gst_pad_get_current_caps(srcpad);
+    gboolean video_meta = FALSE;
+
+    if (caps) {
+        GstQuery *query = gst_query_new_allocation(caps, FALSE);
+        if (gst_pad_peer_query(srcpad, query)) {
+            video_meta = gst_query_find_allocation_meta(query, GST_VIDEO_META_API_TYPE, NULL);
+        }
+        gst_query_unref(query);
+        gst_caps_unref(caps);
+    }
+
+    GST_INFO_OBJECT(filter, "'%s' output: %s", GST_PAD_NAME(srcpad),
+                    video_meta ? "zero copy" : "downstream refuses video meta, copying");
+    return video_meta;
+}
+
+/* Build the buffer of one half of `inbuf`: a sub-buffer sharing its memory, described by a
+ * GstVideoMeta when the rows are not contiguous, or a copy when downstream does not
+ * accept the meta */
+static GstBuffer *gst_zedsplit_make_half(GstZedSplit *filter, GstBuffer *inbuf,
+                                         gboolean second, gboolean video_meta) {
+    const GstVideoInfo *out_info = &filter->out_info;
+    GstVideoMeta *in_meta = gst_buffer_get_video_meta(inbuf);
+    gsize in_stride =
+        in_meta ? in_meta->stride[0] : GST_VIDEO_INFO_PLANE_STRIDE(&filter->in_info, 0);
+    gsize offset =
+        in_meta ? in_meta->offset[0] : GST_VIDEO_INFO_PLANE_OFFSET(&filter->in_info, 0);
+    guint width = GST_VIDEO_INFO_WIDTH(out_info);
+    guint height = GST_VIDEO_INFO_HEIGHT(out_info);
+    gsize out_stride = GST_VIDEO_INFO_PLANE_STRIDE(out_info, 0);
+    gsize row_bytes = width * GST_VIDEO_INFO_COMP_PSTRIDE(out_info, 0);
+    gsize in_size = gst_buffer_get_size(inbuf);
+    const GstBufferCopyFlags copy_flags =
+        (GstBufferCopyFlags) (GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS);
+    GstBuffer *outbuf;
+
+    if (second) {
+        offset += (filter->layout == GST_ZEDSPLIT_SIDE_BY_SIDE) ? row_bytes : in_stride * height;
+    }
+
+    if (offset + in_stride * (height - 1) + row_bytes > in_size) {
+        GST_ELEMENT_ERROR(filter, STREAM, FORMAT, ("Input buffer smaller than its caps"),
+                          ("%" G_GSIZE_FORMAT " bytes received", in_size));
+        return NULL;
+    }
+
+    // ----> Zero copy
+    if (video_meta || in_stride == out_stride) {
+        gsize size = MIN(in_stride * height, in_size - offset);
+
+        outbuf = gst_buffer_copy_region(
+            inbuf, (GstBufferCopyFlags) (copy_flags | GST_BUFFER_COPY_MEMORY), offset, size);
+        if (outbuf && in_stride != out_stride) {
+            gsize offsets[GST_VIDEO_MAX_PLANES] = {0};
+            gint strides[GST_VIDEO_MAX_PLANES] = {static_cast<gint>(in_stride)};
+            gst_buffer_add_video_meta_full(outbuf, GST_VIDEO_FRAME_FLAG_NONE,
+                                           GST_VIDEO_INFO_FORMAT(out_info), width, height, 1,
+                                           offsets, strides);
+        }
+        return outbuf;
+    }
+    // <---- Zero copy
+
+    // ----> Copy fallback
+    GstMapInfo in_map, out_map;
+
+    outbuf = gst_buffer_new_allocate(NULL, GST_VIDEO_INFO_SIZE(out_info), NULL);
+    gst_buffer_copy_into(outbuf, inbuf, copy_flags, 0, -1);
+
+    if (!gst_buffer_map(inbuf, &in_map, GST_MAP_READ)) {
+        GST_ELEMENT_ERROR(filter, RESOURCE, FAILED, ("Failed to map buffer for reading"), (NULL));
+        gst_buffer_unref(outbuf);
+        return NULL;
+    }
+    gst_buffer_map(outbuf, &out_map, GST_MAP_WRITE);
+
+    gst_zed_copy_plane(in_map.data + offset, in_stride, out_map.data, out_stride, row_bytes,
+                       height);
+
+    gst_buffer_unmap(outbuf, &out_map);
+    gst_buffer_unmap(inbuf, &in_map);
+    // <---- Copy fallback
+
+    return outbuf;
+}
+
+static GstFlowReturn gst_zedsplit_chain(GstPad *pad, GstObject *parent, GstBuffer *buf) {
+    GstZedSplit *filter = GST_ZED_SPLIT(parent);
+    GstFlowReturn ret = GST_FLOW_OK;
+
+    GST_TRACE_OBJECT(filter, "Chain");
+
+    if (GST_VIDEO_INFO_FORMAT(&filter->in_info) == GST_VIDEO_FORMAT_UNKNOWN) {
+        GST_ELEMENT_ERROR(filter, CORE, NEGOTIATION, ("No caps received before the first buffer"),
+                          (NULL));
+        gst_buffer_unref(buf);
+        return GST_FLOW_NOT_NEGOTIATED;
+    }
+
+    // ----> Downstream video meta support
+    gboolean reconfigure = gst_pad_check_reconfigure(filter->srcpad_left);
+    reconfigure |= gst_pad_check_reconfigure(filter->srcpad_right);
+    if (filter->need_allocation || reconfigure) {
+        filter->left_video_meta = gst_zedsplit_peer_video_meta(filter, filter->srcpad_left);
+        filter->right_video_meta = gst_zedsplit_peer_video_meta(filter, filter->srcpad_right);
+        filter->need_allocation = FALSE;
+    }
+    // <---- Downstream video meta support
+
+    GstPad *srcpads[] = {filter->srcpad_left, filter->srcpad_right};
+    gboolean video_meta[] = {filter->left_video_meta, filter->right_video_meta};
+
+    for (guint i = 0; i < G_N_ELEMENTS(srcpads); i++) {
+        GstBuffer *outbuf = gst_zedsplit_make_half(filter, buf, i == 1, video_meta[i]);
+
+        if (!outbuf) {
+            ret = GST_FLOW_ERROR;
+            break;
+        }
+
+        ret = gst_flow_combiner_update_pad_flow(filter->flow_combiner, srcpads[i],
+                                                gst_pad_push(srcpads[i], outbuf));
+        if (ret != GST_FLOW_OK) {
+            break;
+        }
+    }
+
+    gst_buffer_unref(buf);
+    return ret;
+}
+
+static gboolean plugin_init(GstPlugin *plugin) {
+    GST_DEBUG_CATEGORY_INIT(gst_zedsplit_debug, "zedsplit", 0,
+                            "debug category for zedsplit element");
+    gst_element_register(plugin, "zedsplit", GST_RANK_NONE, gst_zedsplit_get_type());
+
+    return TRUE;
+}
+
+GST_PLUGIN_DEFINE(GST_VERSION_MAJOR, GST_VERSION_MINOR, zedsplit,
+                  "ZED composite frame splitter", plugin_init, GST_PACKAGE_VERSION,
+                  GST_PACKAGE_LICENSE, GST_PACKAGE_NAME, GST_PACKAGE_ORIGIN)
@@ -0,0 +1,69 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_SPLIT_H_
+#define _GST_ZED_SPLIT_H_
+
+#include <gst/base/gstflowcombiner.h>
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_ZED_SPLIT (gst_zedsplit_get_type())
+#define GST_ZED_SPLIT(obj) (G_TYPE_CHECK_INSTANCE_CAST((obj), GST_TYPE_ZED_SPLIT, GstZedSplit))
+#define GST_ZED_SPLIT_CLASS(klass)                                                                 \
+    (G_TYPE_CHECK_CLASS_CAST((klass), GST_TYPE_ZED_SPLIT, GstZedSplitClass))
+#define GST_IS_ZED_SPLIT(obj)       (G_TYPE_CHECK_INSTANCE_TYPE((obj), GST_TYPE_ZED_SPLIT))
+#define GST_IS_ZED_SPLIT_CLASS(obj) (G_TYPE_CHECK_CLASS_TYPE((klass), GST_TYPE_ZED_SPLIT))
+
+typedef struct _GstZedSplit GstZedSplit;
+typedef struct _GstZedSplitClass GstZedSplitClass;
+
+struct _GstZedSplit {
+    GstElement base_zedsplit;
+
+    GstPad *sinkpad;
+    GstPad *srcpad_left;
+    GstPad *srcpad_right;
+
+    GstFlowCombiner *flow_combiner;
+
+    // ----> Properties
+    gint layout;   // Composite frame layout [enum]
+    // <---- Properties
+
+    GstVideoInfo in_info;       // Negotiated composite frame
+    GstVideoInfo out_info;      // Each half of the composite frame
+    gboolean need_allocation;   // Downstream video meta support to be queried
+    gboolean left_video_meta;   // Downstream of `src_left` handles GstVideoMeta strides
+    gboolean right_video_meta;  // Downstream of `src_right` handles GstVideoMeta strides
+};
+
+struct _GstZedSplitClass {
+    GstElementClass base_zedsplit_class;
+};
+
+G_GNUC_INTERNAL GType gst_zedsplit_get_type(void);
+
+G_END_DECLS
+
+#endif   // _GST_ZED_SPLIT_H_
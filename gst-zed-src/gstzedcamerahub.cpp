@@ -0,0 +1,285 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedcamerahub.h"
+
+#include <gst/gst.h>
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+GST_DEBUG_CATEGORY_EXTERN(gst_zedsrc_debug);
+#define GST_CAT_DEFAULT gst_zedsrc_debug
+
+// Delay before grabbing again after a grab failure [msec]
+#define HUB_GRAB_RETRY_DELAY 100
+
+struct _GstZedCameraHub {
+    std::string input_key;
+    std::shared_ptr<sl::Camera> camera;
+    std::list<GstZedHubConsumer *> consumers;
+    std::vector<GstZedHubConsumer *> serving;   // Consumers retrieving the last frame
+
+    GThread *thread;
+    GMutex lock;
+    GCond cond;
+    gboolean started;       // Camera opened by the first consumer [hubs lock]
+    gboolean running;
+    gboolean exited;        // Grab loop stopped
+    gboolean abandoned;     // Detached with the grab blocked: the grab thread frees the hub
+    gint64 frame_period;    // Camera frame period [usec]
+    guint64 frame_count;
+};
+
+static GMutex hubs_lock;
+static GCond hubs_cond;   // Hub started, or dropped by its opener
+static std::map<std::string, GstZedCameraHub *> hubs;
+
+static void gst_zed_camera_hub_free(GstZedCameraHub *hub) {
+    g_mutex_clear(&hub->lock);
+    g_cond_clear(&hub->cond);
+    delete hub;   // Closes the camera if the hub holds its last reference
+}
+
+static gpointer gst_zed_camera_hub_thread(gpointer data) {
+    GstZedCameraHub *hub = static_cast<GstZedCameraHub *>(data);
+
+    GST_DEBUG("Camera hub [%s]: grab loop started", hub->input_key.c_str());
+
+    cuCtxPushCurrent_v2(hub->camera->getCUDAContext());
+
+    g_mutex_lock(&hub->lock);
+    while (hub->running) {
+        g_mutex_unlock(&hub->lock);
+        sl::ERROR_CODE ret = hub->camera->grab();
+        g_mutex_lock(&hub->lock);
+
+        if (!hub->running) {
+            break;
+        }
+
+        if (ret <= sl::ERROR_CODE::SUCCESS) {
+            hub->frame_count++;
+        }
+
+        // ----> Serve the waiting consumers
+        // Retrieved out of the lock: only the consumers served wait for each other
+        hub->serving.clear();
+        for (GstZedHubConsumer *consumer : hub->consumers) {
+            if (consumer->waiting) {
+                consumer->waiting = FALSE;
+                consumer->busy = TRUE;
+                hub->serving.push_back(consumer);
+            }
+        }
+        g_mutex_unlock(&hub->lock);
+
+        for (GstZedHubConsumer *consumer : hub->serving) {
+            consumer->ret = (ret <= sl::ERROR_CODE::SUCCESS)
+                                ? consumer->retrieve(*hub->camera, consumer->user_data)
+                                : ret;
+        }
+
+        g_mutex_lock(&hub->lock);
+        for (GstZedHubConsumer *consumer : hub->serving) {
+            consumer->busy = FALSE;
+            consumer->ready = TRUE;
+        }
+        g_cond_broadcast(&hub->cond);
+        // <---- Serve the waiting consumers
+
+        if (ret > sl::ERROR_CODE::SUCCESS) {
+            GST_DEBUG("Camera hub [%s]: grab failed, '%s'", hub->input_key.c_str(),
+                      sl::toString(ret).c_str());
+            gint64 end_time = g_get_monotonic_time() + HUB_GRAB_RETRY_DELAY * G_TIME_SPAN_MILLISECOND;
+            while (hub->running && g_cond_wait_until(&hub->cond, &hub->lock, end_time)) {
+            }
+        }
+    }
+    GST_DEBUG("Camera hub [%s]: grab loop stopped after %" G_GUINT64_FORMAT " frames",
+              hub->input_key.c_str(), hub->frame_count);
+    hub->exited = TRUE;
+    g_cond_broadcast(&hub->cond);
+    gboolean abandoned = hub->abandoned;
+    g_mutex_unlock(&hub->lock);
+
+    cuCtxPopCurrent_v2(NULL);
+
+    if (abandoned) {
+        gst_zed_camera_hub_free(hub);
+    }
+
+    return NULL;
+}
+
+GstZedCameraHub *gst_zed_camera_hub_attach(const gchar *input_key, GstZedHubConsumer *consumer,
+                                           gboolean *opener) {
+    GstZedCameraHub *hub;
+
+    consumer->waiting = FALSE;
+    consumer->ready = FALSE;
+    consumer->busy = FALSE;
+
+    g_mutex_lock(&hubs_lock);
+    auto it = hubs.find(input_key);
+    while (it != hubs.end() && !it->second->started) {
+        // Camera being opened by another element
+        g_cond_wait(&hubs_cond, &hubs_lock);
+        it = hubs.find(input_key);
+    }
+
+    if (it != hubs.end()) {
+        hub = it->second;
+        g_mutex_lock(&hub->lock);
+        hub->consumers.push_back(consumer);
+        GST_INFO("Camera hub [%s]: consumer attached, %zu consumers", input_key,
+                 hub->consumers.size());
+        g_mutex_unlock(&hub->lock);
+        *opener = FALSE;
+    } else {
+        hub = new GstZedCameraHub();
+        hub->input_key = input_key;
+        hub->started = FALSE;
+        hub->running = FALSE;
+        hub->exited = FALSE;
+        hub->abandoned = FALSE;
+        hub->frame_count = 0;
+        g_mutex_init(&hub->lock);
+        g_cond_init(&hub->cond);
+        hub->consumers.push_back(consumer);
+        hubs[hub->input_key] = hub;
+        GST_INFO("Camera hub [%s]: created", input_key);
+        *opener = TRUE;
+    }
+    g_mutex_unlock(&hubs_lock);
+
+    return hub;
+}
+
+void gst_zed_camera_hub_start(GstZedCameraHub *hub, const std::shared_ptr<sl::Camera> &camera) {
+    gint fps = static_cast<gint>(camera->getCameraInformation().camera_configuration.fps);
+
+    hub->camera = camera;
+    hub->frame_period = G_USEC_PER_SEC / MAX(fps, 1);
+    hub->running = TRUE;
+    hub->thread = g_thread_new("zedsrc-hub", gst_zed_camera_hub_thread, hub);
+
+    g_mutex_lock(&hubs_lock);
+    hub->started = TRUE;
+    g_cond_broadcast(&hubs_cond);
+    g_mutex_unlock(&hubs_lock);
+
+    GST_INFO("Camera hub [%s]: started", hub->input_key.c_str());
+}
+
+gboolean gst_zed_camera_hub_detach(GstZedCameraHub *hub, GstZedHubConsumer *consumer) {
+    g_mutex_lock(&hubs_lock);
+    g_mutex_lock(&hub->lock);
+    while (consumer->busy) {
+        g_cond_wait(&hub->cond, &hub->lock);   // `retrieve` still using the element
+    }
+    hub->consumers.remove(consumer);
+    gboolean last = hub->consumers.empty();
+    gboolean started = hub->started;
+    if (last) {
+        hubs.erase(hub->input_key);
+        hub->running = FALSE;
+        g_cond_broadcast(&hub->cond);
+    }
+    GST_INFO("Camera hub [%s]: consumer detached, %zu consumers", hub->input_key.c_str(),
+             hub->consumers.size());
+    g_mutex_unlock(&hub->lock);
+    if (!started) {
+        g_cond_broadcast(&hubs_cond);   // The waiting elements open the camera themselves
+    }
+    g_mutex_unlock(&hubs_lock);
+
+    if (!last) {
+        return FALSE;
+    }
+    if (!started) {
+        gst_zed_camera_hub_free(hub);   // No grab loop
+        return TRUE;
+    }
+
+    // A blocked grab must not delay the state change by more than a few frames
+    gint64 end_time = g_get_monotonic_time() + 2 * hub->frame_period;
+    g_mutex_lock(&hub->lock);
+    while (!hub->exited && g_cond_wait_until(&hub->cond, &hub->lock, end_time)) {
+    }
+    hub->abandoned = !hub->exited;
+    gboolean abandoned = hub->abandoned;
+    GThread *thread = hub->thread;
+    if (abandoned) {
+        GST_WARNING("Camera hub [%s]: grab still blocked, the camera is closed when it returns",
+                    hub->input_key.c_str());
+    }
+    g_mutex_unlock(&hub->lock);   // `hub` may be freed by the grab thread once unlocked
+
+    if (abandoned) {
+        g_thread_unref(thread);
+        return FALSE;
+    }
+
+    g_thread_join(thread);
+    gst_zed_camera_hub_free(hub);
+
+    return TRUE;
+}
+
+std::shared_ptr<sl::Camera> gst_zed_camera_hub_get_camera(GstZedCameraHub *hub) {
+    return hub->camera;
+}
+
+GstZedHubWaitResult gst_zed_camera_hub_wait_frame(GstZedCameraHub *hub,
+                                                  GstZedHubConsumer *consumer, gint64 end_time) {
+    GstZedHubWaitResult result;
+
+    g_mutex_lock(&hub->lock);
+    consumer->ready = FALSE;
+    consumer->waiting = TRUE;
+    while (!consumer->ready && !consumer->flushing) {
+        if (!g_cond_wait_until(&hub->cond, &hub->lock, end_time)) {
+            break;
+        }
+    }
+    if (consumer->flushing) {
+        result = GST_ZED_HUB_FLUSHING;
+    } else if (consumer->ready) {
+        result = GST_ZED_HUB_FRAME;
+    } else {
+        result = GST_ZED_HUB_TIMEOUT;
+    }
+    consumer->waiting = FALSE;
+    g_mutex_unlock(&hub->lock);
+
+    return result;
+}
+
+void gst_zed_camera_hub_set_flushing(GstZedCameraHub *hub, GstZedHubConsumer *consumer,
+                                     gboolean flushing) {
+    g_mutex_lock(&hub->lock);
+    consumer->flushing = flushing;
+    g_cond_broadcast(&hub->cond);
+    g_mutex_unlock(&hub->lock);
+}
@@ -0,0 +1,88 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_CAMERA_HUB_H_
+#define _GST_ZED_CAMERA_HUB_H_
+
+#include <glib.h>
+
+#include <memory>
+
+#include "sl/Camera.hpp"
+
+/* Process-wide hub sharing one opened camera between several `zedsrc` elements
+ * of the same process. The hub owns the grab loop: each grabbed frame is handed
+ * to every attached consumer waiting for it, by calling its `retrieve` function
+ * from the grab thread, so that each element only retrieves the views it
+ * outputs while the grab (and the depth processing) is done once. The hub lock
+ * is not held by `retrieve`: a slow consumer never blocks the waits of the others.
+ *
+ * Consumers not waiting when a frame is grabbed simply skip it: elements running
+ * at a lower rate than the camera do not slow down the others. */
+
+typedef struct _GstZedCameraHub GstZedCameraHub;
+
+typedef sl::ERROR_CODE (*GstZedHubRetrieveFunc)(sl::Camera &zed, gpointer user_data);
+
+typedef struct {
+    GstZedHubRetrieveFunc retrieve;   // Called from the grab thread for each new frame
+    gpointer user_data;
+
+    gboolean waiting;     // Waiting for the next frame
+    gboolean ready;       // A frame has been retrieved, or the grab failed
+    gboolean flushing;    // Waiting interrupted
+    gboolean busy;        // In `retrieve` on the grab thread
+    sl::ERROR_CODE ret;   // Grab or retrieve result for the last frame
+} GstZedHubConsumer;
+
+typedef enum {
+    GST_ZED_HUB_FRAME,      // `consumer->ret` holds the grab/retrieve result
+    GST_ZED_HUB_TIMEOUT,    // No frame before `end_time`
+    GST_ZED_HUB_FLUSHING,   // Interrupted by `gst_zed_camera_hub_set_flushing`
+} GstZedHubWaitResult;
+
+/* Attach `consumer` to the hub sharing the camera identified by `input_key`.
+ * When no hub exists yet for this input, it is created and `*opener` is set: the
+ * caller must open the camera and hand it to `gst_zed_camera_hub_start`, or detach
+ * on failure. Elements attaching meanwhile wait for the camera to be started, or
+ * become the opener when it could not be opened. */
+GstZedCameraHub *gst_zed_camera_hub_attach(const gchar *input_key, GstZedHubConsumer *consumer,
+                                           gboolean *opener);
+
+/* Share the camera opened for the hub and start the grab loop */
+void gst_zed_camera_hub_start(GstZedCameraHub *hub, const std::shared_ptr<sl::Camera> &camera);
+
+/* Detach `consumer` from the hub. Returns TRUE if it was the last consumer:
+ * the grab loop is then stopped, the hub destroyed and the caller is again the
+ * only user of the camera. When the grab loop stays blocked for two frame periods
+ * FALSE is returned too: the hub then closes the camera once the grab returns. */
+gboolean gst_zed_camera_hub_detach(GstZedCameraHub *hub, GstZedHubConsumer *consumer);
+
+std::shared_ptr<sl::Camera> gst_zed_camera_hub_get_camera(GstZedCameraHub *hub);
+
+/* Wait for the next frame until the `end_time` monotonic time [usec] */
+GstZedHubWaitResult gst_zed_camera_hub_wait_frame(GstZedCameraHub *hub,
+                                                  GstZedHubConsumer *consumer, gint64 end_time);
+
+void gst_zed_camera_hub_set_flushing(GstZedCameraHub *hub, GstZedHubConsumer *consumer,
+                                     gboolean flushing);
+
+#endif   // _GST_ZED_CAMERA_HUB_H_
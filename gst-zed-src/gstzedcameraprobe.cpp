@@ -0,0 +1,111 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedcameraprobe.h"
+
+#include <gst/gst.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+GST_DEBUG_CATEGORY_EXTERN(gst_zedsrc_debug);
+#define GST_CAT_DEFAULT gst_zedsrc_debug
+
+static const gint fps_15[] = {15, 0};
+static const gint fps_15_30[] = {15, 30, 0};
+static const gint fps_15_60[] = {15, 30, 60, 0};
+static const gint fps_15_100[] = {15, 30, 60, 100, 0};
+static const gint fps_15_120[] = {15, 30, 60, 120, 0};
+
+// ZED, ZED Mini, ZED 2 and ZED 2i
+static const GstZedCameraMode usb_modes[] = {
+    {sl::RESOLUTION::HD2K, 2208, 1242, fps_15},
+    {sl::RESOLUTION::HD1080, 1920, 1080, fps_15_30},
+    {sl::RESOLUTION::HD720, 1280, 720, fps_15_60},
+    {sl::RESOLUTION::VGA, 672, 376, fps_15_100},
+};
+
+// ZED X and ZED X Mini
+static const GstZedCameraMode gmsl_modes[] = {
+    {sl::RESOLUTION::HD1200, 1920, 1200, fps_15_60},
+    {sl::RESOLUTION::HD1080, 1920, 1080, fps_15_60},
+    {sl::RESOLUTION::SVGA, 960, 600, fps_15_120},
+};
+
+// Minimum delay between two enumerations of the device list [usec]
+#define PROBE_REFRESH_DELAY G_USEC_PER_SEC
+
+static std::mutex probe_mutex;
+static std::map<unsigned int, sl::DeviceProperties> devices;   // By serial number
+static gint64 last_refresh = 0;
+
+static void gst_zed_camera_probe_refresh() {
+    gint64 now = g_get_monotonic_time();
+
+    // A missing camera is not enumerated again for each caps query
+    if (last_refresh != 0 && now - last_refresh < PROBE_REFRESH_DELAY) {
+        return;
+    }
+    last_refresh = now;
+
+    std::vector<sl::DeviceProperties> list = sl::Camera::getDeviceList();
+
+    for (const sl::DeviceProperties &dev : list) {
+        devices[dev.serial_number] = dev;
+    }
+    GST_DEBUG("Camera probe: %zu cameras connected", list.size());
+}
+
+static const sl::DeviceProperties *gst_zed_camera_probe_find(guint serial_number,
+                                                             gint camera_id) {
+    if (serial_number != 0) {
+        auto it = devices.find(serial_number);
+        return (it != devices.end()) ? &it->second : NULL;
+    }
+
+    for (const auto &it : devices) {
+        if (it.second.id == camera_id) {
+            return &it.second;
+        }
+    }
+    return NULL;
+}
+
+guint gst_zed_camera_probe(guint serial_number, gint camera_id, const GstZedCameraMode **modes) {
+    std::lock_guard<std::mutex> lock(probe_mutex);
+
+    const sl::DeviceProperties *dev = gst_zed_camera_probe_find(serial_number, camera_id);
+    if (!dev) {
+        gst_zed_camera_probe_refresh();
+        dev = gst_zed_camera_probe_find(serial_number, camera_id);
+    }
+    if (!dev) {
+        return 0;
+    }
+
+    if (dev->input_type == sl::INPUT_TYPE::GMSL) {
+        *modes = gmsl_modes;
+        return G_N_ELEMENTS(gmsl_modes);
+    }
+    *modes = usb_modes;
+    return G_N_ELEMENTS(usb_modes);
+}
@@ -0,0 +1,45 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_CAMERA_PROBE_H_
+#define _GST_ZED_CAMERA_PROBE_H_
+
+#include <glib.h>
+
+#include "sl/Camera.hpp"
+
+/* Capture modes of the connected cameras, known without opening them. The ZED SDK
+ * device list is enumerated once and cached per serial number: it is enumerated
+ * again only when a camera not seen yet is probed. */
+
+typedef struct {
+    sl::RESOLUTION resolution;
+    guint width;       // Single view width [pixels]
+    guint height;      // Single view height [pixels]
+    const gint *fps;   // Supported frame rates, 0 terminated
+} GstZedCameraMode;
+
+/* Modes supported by the camera with serial number `serial_number`, or by the
+ * camera `camera_id` if `serial_number` is 0. Returns the number of modes stored
+ * in `*modes`, 0 if the camera is not connected. */
+guint gst_zed_camera_probe(guint serial_number, gint camera_id, const GstZedCameraMode **modes);
+
+#endif   // _GST_ZED_CAMERA_PROBE_H_
@@ -0,0 +1,110 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedcameraregistry.h"
+
+#include <gst/gst.h>
+
+#include <list>
+#include <mutex>
+#include <string>
+
+GST_DEBUG_CATEGORY_EXTERN(gst_zedsrc_debug);
+#define GST_CAT_DEFAULT gst_zedsrc_debug
+
+struct ParkedCamera {
+    std::shared_ptr<sl::Camera> camera;
+    std::string input_key;
+    std::string params_key;
+    guint serial_number;
+    gpointer owner;
+};
+
+static std::mutex registry_mutex;
+static std::list<ParkedCamera> registry;
+
+std::shared_ptr<sl::Camera> gst_zed_camera_registry_adopt(const gchar *input_key,
+                                                          guint serial_number,
+                                                          const gchar *params_key) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    for (auto it = registry.begin(); it != registry.end(); ++it) {
+        bool same_input = (serial_number != 0) ? (it->serial_number == serial_number)
+                                               : (it->input_key == input_key);
+        if (!same_input) {
+            continue;
+        }
+
+        std::shared_ptr<sl::Camera> camera = it->camera;
+        bool same_params = (it->params_key == params_key);
+        registry.erase(it);
+
+        if (same_params && camera->isOpened()) {
+            GST_INFO("Adopting opened camera SN%u [%s]", serial_number, input_key);
+            return camera;
+        }
+
+        // The device must be released before being opened with the new parameters
+        GST_INFO("Closing parked camera [%s]: opening parameters changed", input_key);
+        camera->close();
+        break;
+    }
+
+    return std::shared_ptr<sl::Camera>();
+}
+
+void gst_zed_camera_registry_park(const std::shared_ptr<sl::Camera> &camera,
+                                  const gchar *input_key, const gchar *params_key,
+                                  gpointer owner) {
+    ParkedCamera parked;
+    parked.camera = camera;
+    parked.input_key = input_key;
+    parked.params_key = params_key;
+    parked.serial_number = camera->getCameraInformation().serial_number;
+    parked.owner = owner;
+
+    GST_INFO("Parking opened camera SN%u [%s]", parked.serial_number, input_key);
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(parked);
+}
+
+void gst_zed_camera_registry_release(gpointer owner) {
+    std::list<ParkedCamera> released;
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (auto it = registry.begin(); it != registry.end();) {
+            if (it->owner == owner) {
+                released.splice(released.end(), registry, it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Close outside the lock: it can take a while
+    for (auto &parked : released) {
+        GST_INFO("Closing parked camera SN%u [%s]", parked.serial_number,
+                 parked.input_key.c_str());
+        parked.camera->close();
+    }
+}
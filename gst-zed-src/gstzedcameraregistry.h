@@ -0,0 +1,55 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_CAMERA_REGISTRY_H_
+#define _GST_ZED_CAMERA_REGISTRY_H_
+
+#include <glib.h>
+
+#include <memory>
+
+#include "sl/Camera.hpp"
+
+/* Process-wide registry of cameras left open by `zedsrc` elements with the
+ * `keep-open` property enabled. A stopped element parks its opened camera here
+ * and any `zedsrc` element of the process (the same one restarting or a new one)
+ * can adopt it instead of paying for a new `sl::Camera::open`.
+ *
+ * Cameras are identified by their input (`input_key`, e.g. "id:0", "sn:1234",
+ * "svo:/path/file.svo") or by their serial number. `params_key` summarizes the
+ * initialization parameters used to open the camera: a parked camera is adopted
+ * only if it was opened with the same parameters, otherwise it is closed. */
+
+/* Take an opened camera out of the registry. Returns an empty pointer if no
+ * compatible camera is available. */
+std::shared_ptr<sl::Camera> gst_zed_camera_registry_adopt(const gchar *input_key,
+                                                          guint serial_number,
+                                                          const gchar *params_key);
+
+/* Leave an opened camera in the registry. `owner` is the element parking it. */
+void gst_zed_camera_registry_park(const std::shared_ptr<sl::Camera> &camera,
+                                  const gchar *input_key, const gchar *params_key,
+                                  gpointer owner);
+
+/* Close all the cameras parked by `owner` and not adopted yet */
+void gst_zed_camera_registry_release(gpointer owner);
+
+#endif   // _GST_ZED_CAMERA_REGISTRY_H_
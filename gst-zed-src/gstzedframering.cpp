@@ -0,0 +1,212 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedframering.h"
+
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+
+struct _GstZedFrameRing {
+    gsize frame_size;
+    guint n_slots;
+    guint8 *data;                    // `n_slots` frames
+    GstZedFrameRingRecord *records;  // Metadata of each slot
+    gchar *caps;
+
+    GMutex lock;
+    guint head;           // Next slot to be written
+    guint count;          // Recorded frames, ending at `head`
+    guint pinned_first;   // First slot not yet written by the flush thread
+    guint pinned_count;   // Slots still to be written by the flush thread
+
+    GThread *flush_thread;
+    gboolean flushing;
+    gchar *location;
+    GstZedFrameRingDoneFunc done;
+    gpointer user_data;
+};
+
+GstZedFrameRing *gst_zed_frame_ring_new(gsize frame_size, guint n_slots, const gchar *caps) {
+    guint8 *data = static_cast<guint8 *>(g_try_malloc(frame_size * n_slots));
+    if (!data) {
+        return NULL;
+    }
+    // Touch every page now: no page fault while recording
+    memset(data, 0, frame_size * n_slots);
+
+    GstZedFrameRing *ring = g_new0(GstZedFrameRing, 1);
+    ring->frame_size = frame_size;
+    ring->n_slots = n_slots;
+    ring->data = data;
+    ring->records = g_new0(GstZedFrameRingRecord, n_slots);
+    ring->caps = g_strdup(caps);
+    g_mutex_init(&ring->lock);
+
+    return ring;
+}
+
+void gst_zed_frame_ring_free(GstZedFrameRing *ring) {
+    if (ring->flush_thread) {
+        g_thread_join(ring->flush_thread);
+    }
+
+    g_mutex_clear(&ring->lock);
+    g_free(ring->location);
+    g_free(ring->caps);
+    g_free(ring->records);
+    g_free(ring->data);
+    g_free(ring);
+}
+
+/* TRUE if `slot` waits to be written by the flush thread */
+static gboolean gst_zed_frame_ring_is_pinned(GstZedFrameRing *ring, guint slot) {
+    return (slot + ring->n_slots - ring->pinned_first) % ring->n_slots < ring->pinned_count;
+}
+
+gboolean gst_zed_frame_ring_push(GstZedFrameRing *ring, const guint8 *data,
+                                 const GstZedFrameRingRecord *record) {
+    g_mutex_lock(&ring->lock);
+    guint slot = ring->head;
+    if (gst_zed_frame_ring_is_pinned(ring, slot)) {
+        g_mutex_unlock(&ring->lock);
+        return FALSE;
+    }
+    if (ring->count == ring->n_slots) {
+        ring->count--;   // The oldest frame is overwritten: not part of a flush anymore
+    }
+    g_mutex_unlock(&ring->lock);
+
+    memcpy(ring->data + slot * ring->frame_size, data, ring->frame_size);
+    ring->records[slot] = *record;
+
+    g_mutex_lock(&ring->lock);
+    ring->head = (slot + 1) % ring->n_slots;
+    ring->count++;
+    g_mutex_unlock(&ring->lock);
+
+    return TRUE;
+}
+
+/* Write `size` zero bytes */
+static gboolean gst_zed_frame_ring_write_padding(FILE *file, gsize size) {
+    static const guint8 zeros[GST_ZED_FRAME_RING_PAGE_SIZE] = {0};
+
+    while (size > 0) {
+        gsize chunk = MIN(size, sizeof(zeros));
+        if (fwrite(zeros, 1, chunk, file) != chunk) {
+            return FALSE;
+        }
+        size -= chunk;
+    }
+    return TRUE;
+}
+
+static gpointer gst_zed_frame_ring_flush_thread(gpointer data) {
+    GstZedFrameRing *ring = static_cast<GstZedFrameRing *>(data);
+    const gsize record_size =
+        GST_ROUND_UP_N(GST_ZED_FRAME_RING_DATA_OFFSET + ring->frame_size,
+                       GST_ZED_FRAME_RING_PAGE_SIZE);
+    const gsize caps_size = strlen(ring->caps) + 1;
+
+    g_mutex_lock(&ring->lock);
+    guint frames = ring->pinned_count;
+    g_mutex_unlock(&ring->lock);
+
+    GstZedFrameRingFileHeader header = {};
+    memcpy(header.magic, GST_ZED_FRAME_RING_MAGIC, sizeof(GST_ZED_FRAME_RING_MAGIC));
+    header.version = GST_ZED_FRAME_RING_VERSION;
+    header.header_size = GST_ZED_FRAME_RING_PAGE_SIZE;
+    header.frame_size = ring->frame_size;
+    header.record_size = record_size;
+    header.frame_count = frames;
+    header.caps_size = static_cast<guint32>(
+        MIN(caps_size, GST_ZED_FRAME_RING_PAGE_SIZE - sizeof(header)));
+
+    FILE *file = g_fopen(ring->location, "wb");
+    gboolean success = (file != NULL);
+
+    success = success && fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(ring->caps, 1, header.caps_size - 1, file) == header.caps_size - 1 &&
+              gst_zed_frame_ring_write_padding(
+                  file, GST_ZED_FRAME_RING_PAGE_SIZE - sizeof(header) - header.caps_size + 1);
+
+    for (guint i = 0; i < frames; i++) {
+        g_mutex_lock(&ring->lock);
+        guint slot = ring->pinned_first;
+        g_mutex_unlock(&ring->lock);
+
+        // Keep releasing the slots on error: the recorder must not stay blocked
+        success = success &&
+                  fwrite(&ring->records[slot], sizeof(GstZedFrameRingRecord), 1, file) == 1 &&
+                  gst_zed_frame_ring_write_padding(
+                      file, GST_ZED_FRAME_RING_DATA_OFFSET - sizeof(GstZedFrameRingRecord)) &&
+                  fwrite(ring->data + slot * ring->frame_size, 1, ring->frame_size, file) ==
+                      ring->frame_size &&
+                  gst_zed_frame_ring_write_padding(
+                      file, record_size - GST_ZED_FRAME_RING_DATA_OFFSET - ring->frame_size);
+
+        g_mutex_lock(&ring->lock);
+        ring->pinned_first = (slot + 1) % ring->n_slots;
+        ring->pinned_count--;
+        g_mutex_unlock(&ring->lock);
+    }
+
+    if (file && fclose(file) != 0) {
+        success = FALSE;
+    }
+
+    ring->done(ring->location, frames, success, ring->user_data);
+
+    g_mutex_lock(&ring->lock);
+    ring->flushing = FALSE;
+    g_mutex_unlock(&ring->lock);
+
+    return NULL;
+}
+
+gboolean gst_zed_frame_ring_flush(GstZedFrameRing *ring, const gchar *location,
+                                  GstZedFrameRingDoneFunc done, gpointer user_data) {
+    g_mutex_lock(&ring->lock);
+    if (ring->flushing || ring->count == 0) {
+        g_mutex_unlock(&ring->lock);
+        return FALSE;
+    }
+
+    // Pin the recorded frames, from the oldest one
+    ring->pinned_first = (ring->head + ring->n_slots - ring->count) % ring->n_slots;
+    ring->pinned_count = ring->count;
+    ring->count = 0;
+    ring->flushing = TRUE;
+    g_mutex_unlock(&ring->lock);
+
+    if (ring->flush_thread) {
+        g_thread_join(ring->flush_thread);   // Previous flush, already done
+    }
+
+    g_free(ring->location);
+    ring->location = g_strdup(location);
+    ring->done = done;
+    ring->user_data = user_data;
+    ring->flush_thread = g_thread_new("zedsrc-ring-flush", gst_zed_frame_ring_flush_thread, ring);
+
+    return TRUE;
+}
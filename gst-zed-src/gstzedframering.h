@@ -0,0 +1,85 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_FRAME_RING_H_
+#define _GST_ZED_FRAME_RING_H_
+
+#include <gst/gst.h>
+
+/* Preallocated ring of the most recent output frames of a `zedsrc` element, flushed to
+ * disk in background on request (`trigger-capture` signal) to keep the seconds preceding
+ * an event. All the memory is allocated and touched when the ring is created: recording a
+ * frame is a copy into the next slot and never allocates.
+ *
+ * Frames being flushed are pinned: the recorder skips them instead of waiting, so that the
+ * grab loop is never stalled by the disk, and each slot is released as soon as written.
+ *
+ * File layout, little endian, mmap-friendly:
+ *  - 4096 bytes header: `GstZedFrameRingFileHeader` followed by the caps string (NUL
+ *    terminated), zero padded
+ *  - `frame_count` records of `record_size` bytes (multiple of 4096): a
+ *    `GstZedFrameRingRecord` then the frame data at offset 64 */
+
+#define GST_ZED_FRAME_RING_MAGIC       "ZEDRING"
+#define GST_ZED_FRAME_RING_VERSION     1
+#define GST_ZED_FRAME_RING_PAGE_SIZE   4096
+#define GST_ZED_FRAME_RING_DATA_OFFSET 64
+
+typedef struct {
+    gchar magic[8];        // GST_ZED_FRAME_RING_MAGIC
+    guint32 version;       // GST_ZED_FRAME_RING_VERSION
+    guint32 header_size;   // Offset of the first record [bytes]
+    guint64 frame_size;    // Frame data size [bytes]
+    guint64 record_size;   // Record size [bytes]
+    guint32 frame_count;   // Records in the file
+    guint32 caps_size;     // Caps string size, NUL included [bytes]
+} GstZedFrameRingFileHeader;
+
+typedef struct {
+    guint64 pts;          // Buffer timestamp [nsec]
+    guint64 clock_time;   // Element clock time at capture [nsec]
+    guint64 offset;       // Buffer offset (frame number)
+} GstZedFrameRingRecord;
+
+typedef struct _GstZedFrameRing GstZedFrameRing;
+
+/* Called from the flush thread once the file is closed */
+typedef void (*GstZedFrameRingDoneFunc)(const gchar *location, guint frames, gboolean success,
+                                        gpointer user_data);
+
+/* Allocate a ring of `n_slots` frames of `frame_size` bytes, described by `caps`.
+ * Returns NULL if the memory is not available. */
+GstZedFrameRing *gst_zed_frame_ring_new(gsize frame_size, guint n_slots, const gchar *caps);
+
+/* Wait for a running flush and free the ring */
+void gst_zed_frame_ring_free(GstZedFrameRing *ring);
+
+/* Record a frame. Returns FALSE if the next slot is still being flushed: the frame is
+ * not recorded. */
+gboolean gst_zed_frame_ring_push(GstZedFrameRing *ring, const guint8 *data,
+                                 const GstZedFrameRingRecord *record);
+
+/* Move the recorded frames to a background thread writing them to `location`, the ring
+ * restarting empty. Returns FALSE if a flush is already running or no frame is recorded. */
+gboolean gst_zed_frame_ring_flush(GstZedFrameRing *ring, const gchar *location,
+                                  GstZedFrameRingDoneFunc done, gpointer user_data);
+
+#endif   // _GST_ZED_FRAME_RING_H_
@@ -0,0 +1,174 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#include "gstzedroimask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/* Parse a comma separated list of integers */
+static gboolean gst_zed_roi_parse_coords(const gchar *str, std::vector<gint> &coords) {
+    gchar **tokens = g_strsplit(str, ",", -1);
+    gboolean ok = TRUE;
+
+    for (gchar **tok = tokens; *tok && ok; tok++) {
+        gchar *end = NULL;
+        gint64 val = g_ascii_strtoll(g_strstrip(*tok), &end, 10);
+        ok = (end != *tok && *end == '\0' && val >= 0 && val <= G_MAXINT);
+        coords.push_back(static_cast<gint>(val));
+    }
+    g_strfreev(tokens);
+
+    return ok;
+}
+
+gboolean gst_zed_roi_parse(const gchar *desc, std::vector<GstZedRoiShape> &shapes) {
+    std::vector<GstZedRoiShape> parsed;
+    gboolean ok = TRUE;
+
+    if (desc == NULL) {
+        shapes.clear();
+        return TRUE;
+    }
+
+    gchar **items = g_strsplit(desc, ";", -1);
+    for (gchar **item = items; *item && ok; item++) {
+        gchar *str = g_strstrip(*item);
+        GstZedRoiShape shape;
+
+        if (*str == '\0') {
+            continue;
+        }
+
+        if (g_str_has_prefix(str, "rect:")) {
+            shape.polygon = FALSE;
+            ok = gst_zed_roi_parse_coords(str + strlen("rect:"), shape.coords) &&
+                 shape.coords.size() == 4;
+        } else if (g_str_has_prefix(str, "poly:")) {
+            shape.polygon = TRUE;
+            ok = gst_zed_roi_parse_coords(str + strlen("poly:"), shape.coords) &&
+                 shape.coords.size() >= 6 && shape.coords.size() % 2 == 0;
+        } else {
+            ok = FALSE;
+        }
+
+        if (ok) {
+            parsed.push_back(shape);
+        }
+    }
+    g_strfreev(items);
+
+    if (ok) {
+        shapes.swap(parsed);
+    }
+
+    return ok;
+}
+
+guint64 gst_zed_roi_hash(const std::vector<GstZedRoiShape> &shapes,
+                         const sl::Resolution &resolution) {
+    // FNV-1a
+    guint64 hash = G_GUINT64_CONSTANT(14695981039346656037);
+    auto mix = [&hash](guint64 val) {
+        hash ^= val;
+        hash *= G_GUINT64_CONSTANT(1099511628211);
+    };
+
+    mix(resolution.width);
+    mix(resolution.height);
+    for (const GstZedRoiShape &shape : shapes) {
+        mix(shape.polygon ? 1 : 0);
+        mix(shape.coords.size());
+        for (gint c : shape.coords) {
+            mix(static_cast<guint64>(c));
+        }
+    }
+
+    return hash;
+}
+
+/* Fill the pixels [`u0`, `u1`) of the mask row, clipped to `width` */
+static inline void gst_zed_roi_fill_span(guint8 *row, gint u0, gint u1, gint width) {
+    u0 = MAX(u0, 0);
+    u1 = MIN(u1, width);
+    if (u1 > u0) {
+        memset(row + u0, 255, u1 - u0);
+    }
+}
+
+static void gst_zed_roi_fill_polygon(guint8 *data, gsize step, gint width, gint height,
+                                     const std::vector<gint> &coords) {
+    const size_t n_vertices = coords.size() / 2;
+    gint y_min = G_MAXINT;
+    gint y_max = 0;
+    std::vector<double> crossings;
+
+    for (size_t i = 0; i < n_vertices; i++) {
+        y_min = MIN(y_min, coords[2 * i + 1]);
+        y_max = MAX(y_max, coords[2 * i + 1]);
+    }
+    y_max = MIN(y_max, height);
+
+    // Scanline fill, sampling the pixel centers
+    for (gint v = MAX(y_min, 0); v < y_max; v++) {
+        double yc = v + 0.5;
+
+        crossings.clear();
+        for (size_t i = 0, j = n_vertices - 1; i < n_vertices; j = i++) {
+            double xi = coords[2 * i], yi = coords[2 * i + 1];
+            double xj = coords[2 * j], yj = coords[2 * j + 1];
+            if ((yi <= yc) != (yj <= yc)) {
+                crossings.push_back(xi + (yc - yi) * (xj - xi) / (yj - yi));
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        guint8 *row = data + v * step;
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+            gint u0 = static_cast<gint>(std::ceil(crossings[k] - 0.5));
+            gint u1 = static_cast<gint>(std::ceil(crossings[k + 1] - 0.5));
+            gst_zed_roi_fill_span(row, u0, u1, width);
+        }
+    }
+}
+
+void gst_zed_roi_fill_mask(sl::Mat &mask, const std::vector<GstZedRoiShape> &shapes) {
+    guint8 *data = mask.getPtr<sl::uchar1>(sl::MEM::CPU);
+    gsize step = mask.getStepBytes(sl::MEM::CPU);
+    gint width = static_cast<gint>(mask.getWidth());
+    gint height = static_cast<gint>(mask.getHeight());
+
+    memset(data, 0, step * height);
+
+    for (const GstZedRoiShape &shape : shapes) {
+        if (shape.polygon) {
+            gst_zed_roi_fill_polygon(data, step, width, height, shape.coords);
+            continue;
+        }
+
+        gint x = shape.coords[0], y = shape.coords[1];
+        gint y_end = MIN(y + shape.coords[3], height);
+        for (gint v = y; v < y_end; v++) {
+            gst_zed_roi_fill_span(data + v * step, x, x + shape.coords[2], width);
+        }
+    }
+}
@@ -0,0 +1,59 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+#ifndef _GST_ZED_ROI_MASK_H_
+#define _GST_ZED_ROI_MASK_H_
+
+#include <glib.h>
+
+#include <vector>
+
+#include "sl/Camera.hpp"
+
+/* Region of interest mask builder for the `roi-list` property of `zedsrc`.
+ *
+ * The region of interest is described by a list of shapes separated by ';':
+ *   - "rect:x,y,w,h" for a rectangle
+ *   - "poly:x1,y1,x2,y2,x3,y3[,...]" for a polygon of at least 3 vertices
+ * e.g. "rect:0,400,1280,320;poly:100,0,600,0,350,300". Coordinates are in
+ * pixels of the camera resolution, shapes are clipped to the image.
+ *
+ * Masks are built span by span: each row covered by a shape is filled with a
+ * `memset` between its left and right borders (even-odd rule for polygons). */
+
+typedef struct {
+    gboolean polygon;         // FALSE: rectangle {x, y, w, h}, TRUE: polygon vertices {x, y, ...}
+    std::vector<gint> coords;
+} GstZedRoiShape;
+
+/* Parse `desc` into `shapes`. Returns FALSE if `desc` is malformed, in this case
+ * `shapes` is left untouched. A NULL or empty description is valid. */
+gboolean gst_zed_roi_parse(const gchar *desc, std::vector<GstZedRoiShape> &shapes);
+
+/* Geometry hash of `shapes` for a `resolution` mask, used to skip rebuilding an
+ * unchanged mask */
+guint64 gst_zed_roi_hash(const std::vector<GstZedRoiShape> &shapes,
+                         const sl::Resolution &resolution);
+
+/* Fill `mask` (U8_C1, CPU) with 255 inside the shapes and 0 elsewhere */
+void gst_zed_roi_fill_mask(sl::Mat &mask, const std::vector<GstZedRoiShape> &shapes);
+
+#endif   // _GST_ZED_ROI_MASK_H_
@@ -22,10 +22,21 @@
 #include <gst/base/gstpushsrc.h>
 #include <gst/gst.h>
 #include <gst/video/video.h>
+#include <math.h>
 
 #include "gstzedsrc.h"
-
-GST_DEBUG_CATEGORY_STATIC(gst_zedsrc_debug);
+#include "gstzedcameraregistry.h"
+#include "gstzedcameraprobe.h"
+#include "gstzedroimask.h"
+#include "gstzedframering.h"
+#include "gst-zed-common/gstzedallocator.h"
+#include "gst-zed-common/gstzedconvert.h"
+#include "gst-zed-common/gstzedcopyengine.h"
+#include "gst-zed-common/gstzedimagestatsmeta.h"
+#include "gst-zed-common/gstzedmotionmeta.h"
+#include "gst-zed-common/gstzedscale.h"
+
+GST_DEBUG_CATEGORY(gst_zedsrc_debug);
 #define GST_CAT_DEFAULT gst_zedsrc_debug
 
 /* prototypes */
@@ -40,11 +51,29 @@ static gboolean gst_zedsrc_start(GstBaseSrc *src);
 static gboolean gst_zedsrc_stop(GstBaseSrc *src);
 static GstCaps *gst_zedsrc_get_caps(GstBaseSrc *src, GstCaps *filter);
 static gboolean gst_zedsrc_set_caps(GstBaseSrc *src, GstCaps *caps);
+static gboolean gst_zedsrc_negotiate(GstBaseSrc *src);
 static gboolean gst_zedsrc_unlock(GstBaseSrc *src);
 static gboolean gst_zedsrc_unlock_stop(GstBaseSrc *src);
+static gboolean gst_zedsrc_event(GstBaseSrc *src, GstEvent *event);
+static gboolean gst_zedsrc_decide_allocation(GstBaseSrc *src, GstQuery *query);
 
 static GstFlowReturn gst_zedsrc_fill(GstPushSrc *src, GstBuffer *buf);
 
+static void gst_zedsrc_stop_reconnection(GstZedSrc *src);
+
+static gboolean gst_zedsrc_trigger_capture(GstZedSrc *src);
+static void gst_zedsrc_setup_ring(GstZedSrc *src, GstCaps *caps);
+
+static gboolean gst_zedsrc_parse_qos_ladder(const gchar *str, guint *steps, guint *n_steps);
+static void gst_zedsrc_qos_setup(GstZedSrc *src);
+
+enum {
+    SIGNAL_TRIGGER_CAPTURE,
+    LAST_SIGNAL
+};
+
+static guint gst_zedsrc_signals[LAST_SIGNAL] = {0};
+
 enum {
     PROP_0,
     PROP_CAM_RES,
@@ -67,6 +96,31 @@ enum {
     PROP_ROI_Y,
     PROP_ROI_W,
     PROP_ROI_H,
+    PROP_ROI_OUTPUT_CROP,
+    PROP_ROI_LIST,
+    PROP_POINTCLOUD_STRIDE,
+    PROP_SCALE_OUTPUT,
+    PROP_OUTPUT_FRAMERATE,
+    PROP_RING_DURATION,
+    PROP_RING_MAX_SIZE,
+    PROP_RING_LOCATION,
+    PROP_QOS,
+    PROP_QOS_LADDER,
+    PROP_THREAD_PRIORITY,
+    PROP_CPU_AFFINITY,
+    PROP_MLOCK_BUFFERS,
+    PROP_N_THREADS,
+    PROP_ALLOCATOR,
+    PROP_IMAGE_STATS,
+    PROP_MIN_SHARPNESS,
+    PROP_MOTION_GATE,
+    PROP_MOTION_THRESHOLD,
+    PROP_MOTION_MIN_BLOCKS,
+    PROP_MOTION_KEEP_ALIVE,
+    PROP_STATS,
+    PROP_METRICS_LOCATION,
+    PROP_METRICS_SOCKET,
+    PROP_METRICS_INTERVAL,
     // PROP_RIGHT_DEPTH_ENABLE,
     PROP_DEPTH_STAB,
     PROP_CONFIDENCE_THRESH,
@@ -93,6 +147,12 @@ enum {
     PROP_WHITEBALANCE,
     PROP_WHITEBALANCE_AUTO,
     PROP_LEDSTATUS,
+    PROP_RECONNECT_POLICY,
+    PROP_RECONNECT_MIN_DELAY,
+    PROP_RECONNECT_MAX_DELAY,
+    PROP_RECONNECT_MAX_ATTEMPTS,
+    PROP_KEEP_OPEN,
+    PROP_SHARED_CAMERA,
     N_PROPERTIES
 };
 
@@ -125,9 +185,29 @@ typedef enum {
     GST_ZEDSRC_ONLY_RIGHT = 1,
     GST_ZEDSRC_LEFT_RIGHT = 2,
     GST_ZEDSRC_DEPTH_16 = 3,
-    GST_ZEDSRC_LEFT_DEPTH = 4
+    GST_ZEDSRC_LEFT_DEPTH = 4,
+    GST_ZEDSRC_POINTCLOUD_XYZ = 5,
+    GST_ZEDSRC_POINTCLOUD_XYZRGBA = 6,
+    GST_ZEDSRC_CONFIDENCE_8 = 7,
+    GST_ZEDSRC_DISPARITY_F32 = 8,
+    GST_ZEDSRC_DISPARITY_16 = 9,
+    GST_ZEDSRC_DEPTH_CONFIDENCE = 10
 } GstZedSrcStreamType;
 
+#define GST_ZEDSRC_IS_COLOR(type)                                                                 \
+    ((type) == GST_ZEDSRC_ONLY_LEFT || (type) == GST_ZEDSRC_ONLY_RIGHT ||                         \
+     (type) == GST_ZEDSRC_LEFT_RIGHT)
+#define GST_ZEDSRC_IS_POINTCLOUD(type)                                                            \
+    ((type) == GST_ZEDSRC_POINTCLOUD_XYZ || (type) == GST_ZEDSRC_POINTCLOUD_XYZRGBA)
+#define GST_ZEDSRC_NEEDS_DEPTH(type)                                                              \
+    ((type) == GST_ZEDSRC_DEPTH_16 || (type) == GST_ZEDSRC_LEFT_DEPTH ||                          \
+     GST_ZEDSRC_IS_POINTCLOUD(type) || (type) == GST_ZEDSRC_CONFIDENCE_8 ||                       \
+     (type) == GST_ZEDSRC_DISPARITY_F32 || (type) == GST_ZEDSRC_DISPARITY_16 ||                   \
+     (type) == GST_ZEDSRC_DEPTH_CONFIDENCE)
+
+// Fixed-point scale of the 'Disparity [GRAY16_LE]' stream: 1/16 pixel resolution
+#define DISPARITY_16_SCALE 16.0f
+
 typedef enum {
     GST_ZEDSRC_COORD_IMAGE = 0,
     GST_ZEDSRC_COORD_LEFT_HANDED_Y_UP = 1,
@@ -143,6 +223,37 @@ typedef enum {
     GST_ZEDSRC_SIDE_BOTH = 2
 } GstZedSrcSide;
 
+typedef enum {
+    GST_ZEDSRC_RECONNECT_NONE = 0,
+    GST_ZEDSRC_RECONNECT_GAP = 1,
+    GST_ZEDSRC_RECONNECT_REPEAT = 2
+} GstZedSrcReconnectPolicy;
+
+typedef enum {
+    GST_ZEDSRC_ALLOCATOR_DEFAULT = 0,
+    GST_ZEDSRC_ALLOCATOR_HUGEPAGE = 1,
+    GST_ZEDSRC_ALLOCATOR_MEMFD = 2,
+    GST_ZEDSRC_ALLOCATOR_DMABUF = 3
+} GstZedSrcAllocatorType;
+
+typedef enum {
+    GST_ZEDSRC_MOTION_GATE_NONE = 0,
+    GST_ZEDSRC_MOTION_GATE_DROP = 1,
+    GST_ZEDSRC_MOTION_GATE_GAP = 2
+} GstZedSrcMotionGateMode;
+
+// Steps of the QoS ladder, see `gst_zedsrc_qos_update`
+typedef enum {
+    GST_ZEDSRC_QOS_SKIP_DEPTH = 1 << 0,   // Depth computed on alternate frames only
+    GST_ZEDSRC_QOS_DECIMATE = 1 << 1,     // One grabbed frame out of two output
+    GST_ZEDSRC_QOS_SCALE_HALF = 1 << 2    // Color output scaled to half size
+} GstZedSrcQosStep;
+
+#define GST_ZEDSRC_QOS_DEGRADE_PROPORTION 1.1   // Downstream 10% slower than real time
+#define GST_ZEDSRC_QOS_RECOVER_PROPORTION 0.8   // Downstream 20% faster than real time
+#define GST_ZEDSRC_QOS_DEGRADE_HOLD       (1 * G_USEC_PER_SEC)
+#define GST_ZEDSRC_QOS_RECOVER_HOLD       (5 * G_USEC_PER_SEC)
+
 //////////////// DEFAULT PARAMETERS
 /////////////////////////////////////////////////////////////////////////////
 
@@ -170,6 +281,31 @@ typedef enum {
 #define DEFAULT_PROP_ROI_Y -1
 #define DEFAULT_PROP_ROI_W -1
 #define DEFAULT_PROP_ROI_H -1
+#define DEFAULT_PROP_ROI_OUTPUT_CROP FALSE
+#define DEFAULT_PROP_ROI_LIST ""
+#define DEFAULT_PROP_POINTCLOUD_STRIDE 1
+#define DEFAULT_PROP_SCALE_OUTPUT      ""
+#define DEFAULT_PROP_OUTPUT_FPS_N      0
+#define DEFAULT_PROP_OUTPUT_FPS_D      1
+#define DEFAULT_PROP_RING_DURATION     0.0
+#define DEFAULT_PROP_RING_MAX_SIZE     512
+#define DEFAULT_PROP_RING_LOCATION     "."
+#define DEFAULT_PROP_QOS               FALSE
+#define DEFAULT_PROP_QOS_LADDER        "skip-depth,decimate,scale-half"
+#define DEFAULT_PROP_THREAD_PRIORITY   0
+#define DEFAULT_PROP_CPU_AFFINITY      0
+#define DEFAULT_PROP_MLOCK_BUFFERS     FALSE
+#define DEFAULT_PROP_N_THREADS         0
+#define DEFAULT_PROP_ALLOCATOR         GST_ZEDSRC_ALLOCATOR_DEFAULT
+#define DEFAULT_PROP_IMAGE_STATS       FALSE
+#define DEFAULT_PROP_MIN_SHARPNESS     0.0
+#define DEFAULT_PROP_MOTION_GATE       GST_ZEDSRC_MOTION_GATE_NONE
+#define DEFAULT_PROP_MOTION_THRESHOLD  8
+#define DEFAULT_PROP_MOTION_MIN_BLOCKS 1
+#define DEFAULT_PROP_MOTION_KEEP_ALIVE 1000
+#define DEFAULT_PROP_METRICS_LOCATION  NULL
+#define DEFAULT_PROP_METRICS_SOCKET    NULL
+#define DEFAULT_PROP_METRICS_INTERVAL  10000
 
 // RUNTIME
 #define DEFAULT_PROP_CONFIDENCE_THRESH   50
@@ -197,6 +333,14 @@ typedef enum {
 #define DEFAULT_PROP_WHITEBALANCE      4600
 #define DEFAULT_PROP_WHITEBALANCE_AUTO 1
 #define DEFAULT_PROP_LEDSTATUS         1
+
+// CAMERA RECOVERY
+#define DEFAULT_PROP_RECONNECT_POLICY       GST_ZEDSRC_RECONNECT_NONE
+#define DEFAULT_PROP_RECONNECT_MIN_DELAY    100
+#define DEFAULT_PROP_RECONNECT_MAX_DELAY    5000
+#define DEFAULT_PROP_RECONNECT_MAX_ATTEMPTS 0
+#define DEFAULT_PROP_KEEP_OPEN              FALSE
+#define DEFAULT_PROP_SHARED_CAMERA          FALSE
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define GST_TYPE_ZED_SIDE (gst_zedsrc_side_get_type())
@@ -293,6 +437,18 @@ static GType gst_zedsrc_stream_type_get_type(void) {
             {GST_ZEDSRC_DEPTH_16, "16 bits depth", "Depth image [GRAY16_LE]"},
             {GST_ZEDSRC_LEFT_DEPTH, "8 bits- 4 channels Left and Depth(image)",
              "Left and Depth up/down [BGRA]"},
+            {GST_ZEDSRC_POINTCLOUD_XYZ, "32 bits float X, Y, Z point cloud",
+             "Point cloud [XYZ]"},
+            {GST_ZEDSRC_POINTCLOUD_XYZRGBA, "32 bits float X, Y, Z and packed color point cloud",
+             "Point cloud [XYZRGBA]"},
+            {GST_ZEDSRC_CONFIDENCE_8, "8 bits depth confidence (0-100 scaled to 0-255)",
+             "Confidence map [GRAY8]"},
+            {GST_ZEDSRC_DISPARITY_F32, "32 bits float disparity [pixels]", "Disparity [F32]"},
+            {GST_ZEDSRC_DISPARITY_16, "16 bits fixed-point disparity [1/16 pixels]",
+             "Disparity [GRAY16_LE]"},
+            {GST_ZEDSRC_DEPTH_CONFIDENCE,
+             "16 bits depth, set to 0 where the confidence is above 'confidence-threshold'",
+             "Confidence filtered depth [GRAY16_LE]"},
             {0, NULL, NULL},
         };
 
@@ -390,6 +546,71 @@ static GType gst_zedsrc_3d_meas_ref_frame_get_type(void) {
     return zedsrc_3d_meas_ref_frame_type;
 }
 
+#define GST_TYPE_ZED_RECONNECT_POLICY (gst_zedsrc_reconnect_policy_get_type())
+static GType gst_zedsrc_reconnect_policy_get_type(void) {
+    static GType zedsrc_reconnect_policy_type = 0;
+
+    if (!zedsrc_reconnect_policy_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDSRC_RECONNECT_NONE, "Stop the pipeline with an error when the camera is lost",
+             "NONE"},
+            {GST_ZEDSRC_RECONNECT_GAP,
+             "Re-open the camera in background and push GAP events while it is missing", "GAP"},
+            {GST_ZEDSRC_RECONNECT_REPEAT,
+             "Re-open the camera in background and repeat the last frame while it is missing",
+             "REPEAT"},
+            {0, NULL, NULL},
+        };
+
+        zedsrc_reconnect_policy_type =
+            g_enum_register_static("GstZedsrcReconnectPolicy", pattern_types);
+    }
+
+    return zedsrc_reconnect_policy_type;
+}
+
+#define GST_TYPE_ZED_ALLOCATOR (gst_zedsrc_allocator_get_type())
+static GType gst_zedsrc_allocator_get_type(void) {
+    static GType zedsrc_allocator_type = 0;
+
+    if (!zedsrc_allocator_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDSRC_ALLOCATOR_DEFAULT, "Allocator proposed by downstream or system memory",
+             "default"},
+            {GST_ZEDSRC_ALLOCATOR_HUGEPAGE,
+             "Pre-faulted huge page memory recycled by the element buffer pool", "hugepage"},
+            {GST_ZEDSRC_ALLOCATOR_MEMFD, "memfd file descriptors, shareable with other processes",
+             "memfd"},
+            {GST_ZEDSRC_ALLOCATOR_DMABUF,
+             "udmabuf DMABuf file descriptors, memfd if /dev/udmabuf is not available",
+             "dmabuf"},
+            {0, NULL, NULL},
+        };
+
+        zedsrc_allocator_type = g_enum_register_static("GstZedsrcAllocator", pattern_types);
+    }
+
+    return zedsrc_allocator_type;
+}
+
+#define GST_TYPE_ZED_MOTION_GATE (gst_zedsrc_motion_gate_get_type())
+static GType gst_zedsrc_motion_gate_get_type(void) {
+    static GType zedsrc_motion_gate_type = 0;
+
+    if (!zedsrc_motion_gate_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDSRC_MOTION_GATE_NONE, "Output every frame", "none"},
+            {GST_ZEDSRC_MOTION_GATE_DROP, "Drop the frames without motion", "drop"},
+            {GST_ZEDSRC_MOTION_GATE_GAP, "Flag the frames without motion as GAP buffers", "gap"},
+            {0, NULL, NULL},
+        };
+
+        zedsrc_motion_gate_type = g_enum_register_static("GstZedsrcMotionGate", pattern_types);
+    }
+
+    return zedsrc_motion_gate_type;
+}
+
 /* pad templates */
 static GstStaticPadTemplate gst_zedsrc_src_template =
     GST_STATIC_PAD_TEMPLATE("src", GST_PAD_SRC, GST_PAD_ALWAYS,
@@ -499,7 +720,27 @@ static GstStaticPadTemplate gst_zedsrc_src_template =
                                              "format = (string)GRAY16_LE, "
                                              "width = (int)960, "
                                              "height = (int)600, "
-                                             "framerate = (fraction) { 15, 30, 60, 120 }")));
+                                             "framerate = (fraction) { 15, 30, 60, 120 }"
+                                             ";"
+                                             "application/x-zed-pointcloud, "   // Point cloud
+                                             "format = (string) { XYZ, XYZRGBA }, "
+                                             "width = (int) [ 1, 2208 ], "
+                                             "height = (int) [ 1, 1242 ], "
+                                             "organized = (boolean) true, "
+                                             "framerate = (fraction) [ 0/1, 120/1 ]"
+                                             ";"
+                                             "video/x-raw, "   // Color, confidence, disparity
+                                             "format = (string) "
+                                             "{ BGRA, BGR, RGB, GRAY8, GRAY16_LE }, "
+                                             "width = (int) [ 1, 4416 ], "
+                                             "height = (int) [ 1, 1242 ], "
+                                             "framerate = (fraction) [ 0/1, 120/1 ]"
+                                             ";"
+                                             "application/x-zed-disparity, "   // Disparity
+                                             "format = (string) F32, "
+                                             "width = (int) [ 1, 2208 ], "
+                                             "height = (int) [ 1, 1242 ], "
+                                             "framerate = (fraction) [ 0/1, 120/1 ]")));
 
 /* class initialization */
 G_DEFINE_TYPE(GstZedSrc, gst_zedsrc, GST_TYPE_PUSH_SRC);
@@ -526,23 +767,40 @@ static void gst_zedsrc_class_init(GstZedSrcClass *klass) {
     gstbasesrc_class->stop = GST_DEBUG_FUNCPTR(gst_zedsrc_stop);
     gstbasesrc_class->get_caps = GST_DEBUG_FUNCPTR(gst_zedsrc_get_caps);
     gstbasesrc_class->set_caps = GST_DEBUG_FUNCPTR(gst_zedsrc_set_caps);
+    gstbasesrc_class->negotiate = GST_DEBUG_FUNCPTR(gst_zedsrc_negotiate);
     gstbasesrc_class->unlock = GST_DEBUG_FUNCPTR(gst_zedsrc_unlock);
     gstbasesrc_class->unlock_stop = GST_DEBUG_FUNCPTR(gst_zedsrc_unlock_stop);
+    gstbasesrc_class->event = GST_DEBUG_FUNCPTR(gst_zedsrc_event);
+    gstbasesrc_class->decide_allocation = GST_DEBUG_FUNCPTR(gst_zedsrc_decide_allocation);
 
     gstpushsrc_class->fill = GST_DEBUG_FUNCPTR(gst_zedsrc_fill);
 
+    klass->trigger_capture = gst_zedsrc_trigger_capture;
+
+    /* Install action signals */
+    gst_zedsrc_signals[SIGNAL_TRIGGER_CAPTURE] = g_signal_new(
+        "trigger-capture", G_TYPE_FROM_CLASS(klass),
+        (GSignalFlags) (G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION),
+        G_STRUCT_OFFSET(GstZedSrcClass, trigger_capture), NULL, NULL, NULL, G_TYPE_BOOLEAN, 0);
+
     /* Install GObject properties */
     g_object_class_install_property(
         gobject_class, PROP_CAM_RES,
-        g_param_spec_enum("camera-resolution", "Camera Resolution", "Camera Resolution",
+        g_param_spec_enum("camera-resolution", "Camera Resolution",
+                          "Camera Resolution. Changed while streaming, the camera is re-opened "
+                          "and the caps renegotiated",
                           GST_TYPE_ZED_RESOL, DEFAULT_PROP_CAM_RES,
-                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                                         GST_PARAM_MUTABLE_PLAYING)));
 
     g_object_class_install_property(
         gobject_class, PROP_CAM_FPS,
-        g_param_spec_enum("camera-fps", "Camera frame rate", "Camera frame rate", GST_TYPE_ZED_FPS,
-                          DEFAULT_PROP_CAM_FPS,
-                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+        g_param_spec_enum("camera-fps", "Camera frame rate",
+                          "Camera frame rate. Changed while streaming, the camera is re-opened "
+                          "and the caps renegotiated",
+                          GST_TYPE_ZED_FPS, DEFAULT_PROP_CAM_FPS,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                                         GST_PARAM_MUTABLE_PLAYING)));
 
     g_object_class_install_property(
         gobject_class, PROP_STREAM_TYPE,
@@ -678,6 +936,211 @@ static void gst_zedsrc_class_init(GstZedSrcClass *klass) {
                          DEFAULT_PROP_ROI_H,
                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+    g_object_class_install_property(
+        gobject_class, PROP_ROI_OUTPUT_CROP,
+        g_param_spec_boolean("roi-output-crop", "Crop output to region of interest",
+                             "Output only the region of interest instead of the full frame. "
+                             "With 'Stereo couple' stream type both views are cropped",
+                             DEFAULT_PROP_ROI_OUTPUT_CROP,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_ROI_LIST,
+        g_param_spec_string("roi-list", "Region of interest shapes",
+                            "Region of interest as a list of shapes separated by ';', added to the "
+                            "'roi-x/y/w/h' rectangle: 'rect:x,y,w,h' for a rectangle, "
+                            "'poly:x1,y1,x2,y2,x3,y3,...' for a polygon. Ignored unless 'roi' is "
+                            "enabled. Can be changed while streaming",
+                            DEFAULT_PROP_ROI_LIST,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                                           GST_PARAM_MUTABLE_PLAYING)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_POINTCLOUD_STRIDE,
+        g_param_spec_int("pointcloud-stride", "Point cloud decimation",
+                         "Point cloud stream types: keep one point every N along rows and columns",
+                         1, 16, DEFAULT_PROP_POINTCLOUD_STRIDE,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_SCALE_OUTPUT,
+        g_param_spec_string("scale-output", "Output size",
+                            "Image stream types: downscale the output to 'WxH' while copying the "
+                            "frame, e.g. '640x360'. With 'Stereo couple' W is the width of both "
+                            "views. Empty for the camera resolution",
+                            DEFAULT_PROP_SCALE_OUTPUT,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_OUTPUT_FRAMERATE,
+        gst_param_spec_fraction("output-framerate", "Output frame rate",
+                                "Frame rate of the output stream, lower than 'camera-fps': the "
+                                "frames not output are neither retrieved nor copied. 0/1 for the "
+                                "camera frame rate",
+                                0, 1, 120, 1, DEFAULT_PROP_OUTPUT_FPS_N, DEFAULT_PROP_OUTPUT_FPS_D,
+                                (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RING_DURATION,
+        g_param_spec_double("ring-duration", "Ring recorder duration",
+                            "Keep the last output frames in memory for the 'trigger-capture' "
+                            "signal [sec]. 0 to disable the ring recorder",
+                            0.0, 600.0, DEFAULT_PROP_RING_DURATION,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RING_MAX_SIZE,
+        g_param_spec_uint("ring-max-size", "Ring recorder memory limit",
+                          "Maximum memory preallocated by the ring recorder [MB], limiting "
+                          "'ring-duration'",
+                          1, 65536, DEFAULT_PROP_RING_MAX_SIZE,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RING_LOCATION,
+        g_param_spec_string("ring-location", "Ring recorder directory",
+                            "Directory of the files written by 'trigger-capture'",
+                            DEFAULT_PROP_RING_LOCATION,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_QOS,
+        g_param_spec_boolean("qos", "Adaptive QoS",
+                             "Step down the 'qos-ladder' when downstream QoS events report late "
+                             "buffers, and back up when the load drops",
+                             DEFAULT_PROP_QOS,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+                                            GST_PARAM_MUTABLE_PLAYING)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_QOS_LADDER,
+        g_param_spec_string("qos-ladder", "QoS ladder",
+                            "Comma-separated degradation steps applied in order by 'qos': "
+                            "'skip-depth' (depth on alternate frames), 'decimate' (half frame "
+                            "rate), 'scale-half' (half size color output). The caps follow the "
+                            "frame rate and size changes",
+                            DEFAULT_PROP_QOS_LADDER,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_THREAD_PRIORITY,
+        g_param_spec_int("thread-priority", "Capture thread priority",
+                         "Real-time SCHED_FIFO priority of the capture thread (requires "
+                         "CAP_SYS_NICE). 0 to keep the default scheduling",
+                         0, 99, DEFAULT_PROP_THREAD_PRIORITY,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_CPU_AFFINITY,
+        g_param_spec_uint64("cpu-affinity", "Capture thread CPU affinity",
+                            "Mask of the CPUs the capture thread runs on, bit N for CPU N. 0 to "
+                            "keep the default affinity",
+                            0, G_MAXUINT64, DEFAULT_PROP_CPU_AFFINITY,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MLOCK_BUFFERS,
+        g_param_spec_boolean("mlock-buffers", "Lock buffers in memory",
+                             "Lock the output buffer memory in RAM to avoid page faults while "
+                             "copying the frames (requires CAP_IPC_LOCK or a large enough "
+                             "RLIMIT_MEMLOCK)",
+                             DEFAULT_PROP_MLOCK_BUFFERS,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_N_THREADS,
+        g_param_spec_uint("n-threads", "Copy threads",
+                          "Number of threads copying and converting each frame in row slices, "
+                          "including the capture thread. 0 for automatic",
+                          0, 64, DEFAULT_PROP_N_THREADS,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_ALLOCATOR,
+        g_param_spec_enum("allocator", "Frame allocator",
+                          "Memory of the output frames. 'hugepage', 'memfd' and 'dmabuf' replace "
+                          "the downstream pools. 'dmabuf' also negotiates memory:DMABuf caps",
+                          GST_TYPE_ZED_ALLOCATOR, DEFAULT_PROP_ALLOCATOR,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_IMAGE_STATS,
+        g_param_spec_boolean("image-stats", "Image statistics",
+                             "Attach the luma histogram, mean, variance and sharpness of the "
+                             "color frames as GstZedImageStatsMeta, computed while copying them",
+                             DEFAULT_PROP_IMAGE_STATS,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MIN_SHARPNESS,
+        g_param_spec_double("min-sharpness", "Minimum sharpness",
+                            "Drop the color frames whose sharpness (variance of the luma "
+                            "Laplacian) is below this value. 0 to keep every frame",
+                            0.0, G_MAXDOUBLE, DEFAULT_PROP_MIN_SHARPNESS,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_GATE,
+        g_param_spec_enum("motion-gate", "Motion gate",
+                          "Handling of the color frames without motion since the last frame "
+                          "with motion. The changed blocks are attached as GstZedMotionMeta",
+                          GST_TYPE_ZED_MOTION_GATE, DEFAULT_PROP_MOTION_GATE,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_THRESHOLD,
+        g_param_spec_uint("motion-threshold", "Motion threshold",
+                          "Mean absolute luma difference over which a 32x32 block changed",
+                          0, 255, DEFAULT_PROP_MOTION_THRESHOLD,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_MIN_BLOCKS,
+        g_param_spec_uint("motion-min-blocks", "Motion minimum blocks",
+                          "Changed blocks for a frame to have motion",
+                          1, G_MAXUINT, DEFAULT_PROP_MOTION_MIN_BLOCKS,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_KEEP_ALIVE,
+        g_param_spec_uint("motion-keep-alive", "Motion gate keep-alive",
+                          "A frame is output as with motion when none was for this long [msec]. "
+                          "0 to never force one",
+                          0, 3600000, DEFAULT_PROP_MOTION_KEEP_ALIVE,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_STATS,
+        g_param_spec_boxed("stats", "Capture statistics",
+                           "Frame, byte and drop counters, output frame rate, camera "
+                           "temperature and grab and copy time percentiles [nsec]",
+                           GST_TYPE_STRUCTURE,
+                           (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_LOCATION,
+        g_param_spec_string("metrics-location", "Metrics file",
+                            "Prometheus text file the 'stats' are written to every "
+                            "'metrics-interval', e.g. for the node exporter textfile collector. "
+                            "NULL for none",
+                            DEFAULT_PROP_METRICS_LOCATION,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_SOCKET,
+        g_param_spec_string("metrics-socket", "Metrics socket",
+                            "Unix domain socket sending the 'stats' in the Prometheus text "
+                            "format to each client connecting. NULL for none",
+                            DEFAULT_PROP_METRICS_SOCKET,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_INTERVAL,
+        g_param_spec_uint("metrics-interval", "Metrics interval",
+                          "Period of the 'metrics-location' updates [msec]",
+                          100, 3600000, DEFAULT_PROP_METRICS_INTERVAL,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
     g_object_class_install_property(
         gobject_class, PROP_CONFIDENCE_THRESH,
         g_param_spec_int("confidence-threshold", "Depth Confidence Threshold",
@@ -806,16 +1269,128 @@ static void gst_zedsrc_class_init(GstZedSrcClass *klass) {
         g_param_spec_boolean("ctrl-led-status", "Camera control: led status", "Camera LED on/off",
                              DEFAULT_PROP_LEDSTATUS,
                              (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_POLICY,
+        g_param_spec_enum("reconnect-policy", "Camera recovery policy",
+                          "Behavior when the camera is lost while grabbing. With REPEAT each "
+                          "frame is copied, to output the last one again",
+                          GST_TYPE_ZED_RECONNECT_POLICY, DEFAULT_PROP_RECONNECT_POLICY,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_MIN_DELAY,
+        g_param_spec_int("reconnect-min-delay", "Reconnection minimum delay [msec]",
+                         "Delay before the first reconnection attempt, doubled at each failure",
+                         10, 60000, DEFAULT_PROP_RECONNECT_MIN_DELAY,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_MAX_DELAY,
+        g_param_spec_int("reconnect-max-delay", "Reconnection maximum delay [msec]",
+                         "Maximum delay between two reconnection attempts", 10, 600000,
+                         DEFAULT_PROP_RECONNECT_MAX_DELAY,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_MAX_ATTEMPTS,
+        g_param_spec_int("reconnect-max-attempts", "Reconnection maximum attempts",
+                         "Number of failed reconnection attempts before stopping with an error "
+                         "(0 for unlimited)",
+                         0, G_MAXINT, DEFAULT_PROP_RECONNECT_MAX_ATTEMPTS,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_KEEP_OPEN,
+        g_param_spec_boolean("keep-open", "Keep camera open",
+                             "Keep the camera opened when the element is stopped, so that it can "
+                             "be restarted, or adopted by another zedsrc of the process, without "
+                             "re-opening it if the opening parameters are unchanged",
+                             DEFAULT_PROP_KEEP_OPEN,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_SHARED_CAMERA,
+        g_param_spec_boolean("shared-camera", "Shared camera",
+                             "Share the opened camera with the other zedsrc elements of the process "
+                             "using the same input: the camera is grabbed once and each element "
+                             "retrieves the stream it outputs. The opening parameters and camera "
+                             "controls of the first element started are used",
+                             DEFAULT_PROP_SHARED_CAMERA,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+}
+
+/* Release the reference of the grab worker on its state. A camera abandoned with
+ * a blocked grab is closed by its destructor, from the worker thread. */
+static void gst_zedsrc_release_grab(gpointer data) {
+    delete static_cast<std::shared_ptr<GstZedSrcGrab> *>(data);
 }
 
 static void gst_zedsrc_reset(GstZedSrc *src) {
-    if (src->zed.isOpened()) {
-        src->zed.close();
+    gst_zedsrc_stop_reconnection(src);
+
+    if (src->grab_worker) {
+        // A stalled camera must not delay the state change by more than a few frames
+        if (!gst_zed_grab_worker_free(src->grab_worker, 2 * src->grab_period / GST_USECOND)) {
+            GST_WARNING_OBJECT(src, "Grab still blocked: the camera is closed when it returns");
+            src->zed.reset();
+        }
+        src->grab_worker = NULL;
+    }
+    src->grab_ctx.reset();
+    gst_buffer_replace(&src->last_buffer, NULL);
+    gst_zedsrc_setup_ring(src, NULL);
+
+    if (src->hub) {
+        if (!gst_zed_camera_hub_detach(src->hub, &src->hub_consumer)) {
+            src->zed.reset();   // Still grabbed by the other elements sharing it, or blocked
+        }
+        src->hub = NULL;
+    }
+    src->hub_camera_lost = FALSE;
+
+    if (src->zed) {
+        if (src->keep_open && src->zed->isOpened()) {
+            gst_zed_camera_registry_park(src->zed, src->input_key, src->params_key, src);
+        } else if (src->zed->isOpened()) {
+            src->zed->close();
+        }
+        src->zed.reset();
     }
+    g_free(src->input_key);
+    src->input_key = NULL;
+    g_free(src->params_key);
+    src->params_key = NULL;
+
+    src->cuda_ctx = NULL;
+    gst_object_replace((GstObject **) &src->clock, NULL);
 
     src->out_framesize = 0;
+    src->out_stride = 0;
+    src->out_format = GST_VIDEO_FORMAT_UNKNOWN;
+    src->out_width = 0;
+    src->out_height = 0;
+    src->out_scale = FALSE;
+    src->caps_scale = FALSE;
+    src->out_crop = FALSE;
+    src->decimate_n = 0;
+    src->mode_resolution = -1;
+    src->mode_switch_pending = FALSE;
+    src->mode_switching = FALSE;
     src->is_started = FALSE;
 
+    src->qos_level = 0;
+    src->qos_active = 0;
+
+    src->mlock_failed = FALSE;
+    gst_zed_copy_engine_free(src->copy_engine);
+    src->copy_engine = NULL;
+    src->grab_period = 0;
+    gst_zed_motion_gate_free(src->motion_gate);
+    src->motion_gate = NULL;
+    src->motion_output_time = GST_CLOCK_TIME_NONE;
+
+    // The counters keep adding up over the element life
+    gst_zed_metrics_stop_export(src->metrics.registry);
+    gst_zed_capture_metrics_reset(&src->metrics);
+
     src->last_frame_count = 0;
     src->total_dropped_frames = 0;
 
@@ -861,6 +1436,32 @@ static void gst_zedsrc_init(GstZedSrc *src) {
     src->roi_y = DEFAULT_PROP_ROI_Y;
     src->roi_w = DEFAULT_PROP_ROI_W;
     src->roi_h = DEFAULT_PROP_ROI_H;
+    src->roi_output_crop = DEFAULT_PROP_ROI_OUTPUT_CROP;
+    src->roi_list = g_strdup(DEFAULT_PROP_ROI_LIST);
+    src->pointcloud_stride = DEFAULT_PROP_POINTCLOUD_STRIDE;
+    gst_zed_parse_size(DEFAULT_PROP_SCALE_OUTPUT, &src->scale_width, &src->scale_height);
+    src->mode_resolution = -1;
+    src->output_fps_n = DEFAULT_PROP_OUTPUT_FPS_N;
+    src->output_fps_d = DEFAULT_PROP_OUTPUT_FPS_D;
+    src->ring_duration = DEFAULT_PROP_RING_DURATION;
+    src->ring_max_size = DEFAULT_PROP_RING_MAX_SIZE;
+    src->ring_location = g_strdup(DEFAULT_PROP_RING_LOCATION);
+    src->qos = DEFAULT_PROP_QOS;
+    src->qos_ladder = g_strdup(DEFAULT_PROP_QOS_LADDER);
+    src->thread_priority = DEFAULT_PROP_THREAD_PRIORITY;
+    src->cpu_affinity = DEFAULT_PROP_CPU_AFFINITY;
+    src->mlock_buffers = DEFAULT_PROP_MLOCK_BUFFERS;
+    src->n_threads = DEFAULT_PROP_N_THREADS;
+    src->allocator = DEFAULT_PROP_ALLOCATOR;
+    src->image_stats = DEFAULT_PROP_IMAGE_STATS;
+    src->min_sharpness = DEFAULT_PROP_MIN_SHARPNESS;
+    src->motion_mode = DEFAULT_PROP_MOTION_GATE;
+    src->motion_threshold = DEFAULT_PROP_MOTION_THRESHOLD;
+    src->motion_min_blocks = DEFAULT_PROP_MOTION_MIN_BLOCKS;
+    src->motion_keep_alive = DEFAULT_PROP_MOTION_KEEP_ALIVE;
+    src->metrics_location = g_strdup(DEFAULT_PROP_METRICS_LOCATION);
+    src->metrics_socket = g_strdup(DEFAULT_PROP_METRICS_SOCKET);
+    src->metrics_interval = DEFAULT_PROP_METRICS_INTERVAL;
 
     src->brightness = DEFAULT_PROP_BRIGHTNESS;
     src->contrast = DEFAULT_PROP_CONTRAST;
@@ -881,11 +1482,34 @@ static void gst_zedsrc_init(GstZedSrc *src) {
     src->whitebalance_temperature = DEFAULT_PROP_WHITEBALANCE;
     src->whitebalance_temperature_auto = DEFAULT_PROP_WHITEBALANCE_AUTO;
     src->led_status = DEFAULT_PROP_LEDSTATUS;
+    src->reconnect_policy = DEFAULT_PROP_RECONNECT_POLICY;
+    src->reconnect_min_delay = DEFAULT_PROP_RECONNECT_MIN_DELAY;
+    src->reconnect_max_delay = DEFAULT_PROP_RECONNECT_MAX_DELAY;
+    src->reconnect_max_attempts = DEFAULT_PROP_RECONNECT_MAX_ATTEMPTS;
+    src->keep_open = DEFAULT_PROP_KEEP_OPEN;
+    src->shared_camera = DEFAULT_PROP_SHARED_CAMERA;
     // <---- Parameters initialization
 
     src->stop_requested = FALSE;
     src->caps = NULL;
 
+    g_mutex_init(&src->reconnect_lock);
+    src->recovery = NULL;
+    src->last_buffer = NULL;
+    src->hub = NULL;
+    src->clock = NULL;
+
+    src->roi_updated = FALSE;
+    src->roi_mask = nullptr;
+    src->roi_mask_hash = 0;
+
+    src->left_img = std::make_unique<sl::Mat>();
+    src->depth_data = std::make_unique<sl::Mat>();
+    src->point_cloud = std::make_unique<sl::Mat>();
+    src->confidence_map = std::make_unique<sl::Mat>();
+
+    gst_zed_capture_metrics_init(&src->metrics);
+
     gst_zedsrc_reset(src);
 }
 
@@ -900,10 +1524,19 @@ void gst_zedsrc_set_property(GObject *object, guint property_id, const GValue *v
 
     switch (property_id) {
     case PROP_CAM_RES:
-        src->camera_resolution = g_value_get_enum(value);
-        break;
     case PROP_CAM_FPS:
-        src->camera_fps = g_value_get_enum(value);
+        GST_OBJECT_LOCK(src);
+        if (property_id == PROP_CAM_RES) {
+            src->camera_resolution = g_value_get_enum(value);
+        } else {
+            src->camera_fps = g_value_get_enum(value);
+        }
+        src->mode_update = GST_BASE_SRC_IS_STARTED(src);
+        GST_OBJECT_UNLOCK(src);
+        if (src->mode_update) {
+            // Switched to the new mode by the renegotiation, see `gst_zedsrc_get_caps`
+            gst_pad_mark_reconfigure(GST_BASE_SRC_PAD(src));
+        }
         break;
     case PROP_SDK_VERBOSE:
         src->sdk_verbose = g_value_get_int(value);
@@ -969,19 +1602,139 @@ void gst_zedsrc_set_property(GObject *object, guint property_id, const GValue *v
         src->fill_mode = g_value_get_boolean(value);
         break;
     case PROP_ROI:
+        GST_OBJECT_LOCK(src);   // Read by the streaming thread
         src->roi = g_value_get_boolean(value);
+        src->roi_updated = TRUE;
+        GST_OBJECT_UNLOCK(src);
         break;
     case PROP_ROI_X:
+        GST_OBJECT_LOCK(src);
         src->roi_x = g_value_get_int(value);
+        src->roi_updated = TRUE;
+        GST_OBJECT_UNLOCK(src);
         break;
     case PROP_ROI_Y:
+        GST_OBJECT_LOCK(src);
         src->roi_y = g_value_get_int(value);
+        src->roi_updated = TRUE;
+        GST_OBJECT_UNLOCK(src);
         break;
     case PROP_ROI_W:
+        GST_OBJECT_LOCK(src);
         src->roi_w = g_value_get_int(value);
+        src->roi_updated = TRUE;
+        GST_OBJECT_UNLOCK(src);
         break;
     case PROP_ROI_H:
+        GST_OBJECT_LOCK(src);
         src->roi_h = g_value_get_int(value);
+        src->roi_updated = TRUE;
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_ROI_OUTPUT_CROP:
+        src->roi_output_crop = g_value_get_boolean(value);
+        break;
+    case PROP_ROI_LIST: {
+        std::vector<GstZedRoiShape> shapes;
+        str = g_value_get_string(value);
+        if (!gst_zed_roi_parse(str, shapes)) {
+            GST_WARNING_OBJECT(src, "Invalid 'roi-list' value '%s', ignored", str);
+            break;
+        }
+        GST_OBJECT_LOCK(src);
+        g_free(src->roi_list);
+        src->roi_list = g_strdup(str ? str : "");
+        src->roi_updated = TRUE;
+        GST_OBJECT_UNLOCK(src);
+        break;
+    }
+    case PROP_POINTCLOUD_STRIDE:
+        src->pointcloud_stride = g_value_get_int(value);
+        break;
+    case PROP_SCALE_OUTPUT:
+        str = g_value_get_string(value);
+        if (!gst_zed_parse_size(str, &src->scale_width, &src->scale_height)) {
+            GST_WARNING_OBJECT(src, "Invalid 'scale-output' value '%s', ignored", str);
+        }
+        break;
+    case PROP_OUTPUT_FRAMERATE:
+        src->output_fps_n = gst_value_get_fraction_numerator(value);
+        src->output_fps_d = gst_value_get_fraction_denominator(value);
+        break;
+    case PROP_RING_DURATION:
+        src->ring_duration = g_value_get_double(value);
+        break;
+    case PROP_RING_MAX_SIZE:
+        src->ring_max_size = g_value_get_uint(value);
+        break;
+    case PROP_RING_LOCATION:
+        str = g_value_get_string(value);
+        GST_OBJECT_LOCK(src);
+        g_free(src->ring_location);
+        src->ring_location = g_strdup(str ? str : DEFAULT_PROP_RING_LOCATION);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_QOS:
+        GST_OBJECT_LOCK(src);
+        src->qos = g_value_get_boolean(value);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_QOS_LADDER:
+        str = g_value_get_string(value);
+        if (gst_zedsrc_parse_qos_ladder(str, NULL, NULL)) {
+            g_free(src->qos_ladder);
+            src->qos_ladder = g_strdup(str);
+        } else {
+            GST_WARNING_OBJECT(src, "Invalid 'qos-ladder' value '%s', ignored", str);
+        }
+        break;
+    case PROP_THREAD_PRIORITY:
+        src->thread_priority = g_value_get_int(value);
+        break;
+    case PROP_CPU_AFFINITY:
+        src->cpu_affinity = g_value_get_uint64(value);
+        break;
+    case PROP_MLOCK_BUFFERS:
+        src->mlock_buffers = g_value_get_boolean(value);
+        break;
+    case PROP_N_THREADS:
+        src->n_threads = g_value_get_uint(value);
+        break;
+    case PROP_ALLOCATOR:
+        src->allocator = g_value_get_enum(value);
+        break;
+    case PROP_IMAGE_STATS:
+        src->image_stats = g_value_get_boolean(value);
+        break;
+    case PROP_MIN_SHARPNESS:
+        src->min_sharpness = g_value_get_double(value);
+        break;
+    case PROP_MOTION_GATE:
+        src->motion_mode = g_value_get_enum(value);
+        break;
+    case PROP_MOTION_THRESHOLD:
+        src->motion_threshold = g_value_get_uint(value);
+        break;
+    case PROP_MOTION_MIN_BLOCKS:
+        src->motion_min_blocks = g_value_get_uint(value);
+        break;
+    case PROP_MOTION_KEEP_ALIVE:
+        src->motion_keep_alive = g_value_get_uint(value);
+        break;
+    case PROP_METRICS_LOCATION:
+        GST_OBJECT_LOCK(src);
+        g_free(src->metrics_location);
+        src->metrics_location = g_value_dup_string(value);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_METRICS_SOCKET:
+        GST_OBJECT_LOCK(src);
+        g_free(src->metrics_socket);
+        src->metrics_socket = g_value_dup_string(value);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_METRICS_INTERVAL:
+        src->metrics_interval = g_value_get_uint(value);
         break;
     case PROP_BRIGHTNESS:
         src->brightness = g_value_get_int(value);
@@ -1048,6 +1801,24 @@ void gst_zedsrc_set_property(GObject *object, guint property_id, const GValue *v
     case PROP_LEDSTATUS:
         src->led_status = g_value_get_boolean(value);
         break;
+    case PROP_RECONNECT_POLICY:
+        src->reconnect_policy = g_value_get_enum(value);
+        break;
+    case PROP_RECONNECT_MIN_DELAY:
+        src->reconnect_min_delay = g_value_get_int(value);
+        break;
+    case PROP_RECONNECT_MAX_DELAY:
+        src->reconnect_max_delay = g_value_get_int(value);
+        break;
+    case PROP_RECONNECT_MAX_ATTEMPTS:
+        src->reconnect_max_attempts = g_value_get_int(value);
+        break;
+    case PROP_KEEP_OPEN:
+        src->keep_open = g_value_get_boolean(value);
+        break;
+    case PROP_SHARED_CAMERA:
+        src->shared_camera = g_value_get_boolean(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -1144,6 +1915,97 @@ void gst_zedsrc_get_property(GObject *object, guint property_id, GValue *value,
     case PROP_ROI_H:
         g_value_set_int(value, src->roi_h);
         break;
+    case PROP_ROI_OUTPUT_CROP:
+        g_value_set_boolean(value, src->roi_output_crop);
+        break;
+    case PROP_ROI_LIST:
+        GST_OBJECT_LOCK(src);
+        g_value_set_string(value, src->roi_list);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_POINTCLOUD_STRIDE:
+        g_value_set_int(value, src->pointcloud_stride);
+        break;
+    case PROP_SCALE_OUTPUT:
+        if (src->scale_width != 0) {
+            g_value_take_string(value,
+                                g_strdup_printf("%ux%u", src->scale_width, src->scale_height));
+        } else {
+            g_value_set_string(value, "");
+        }
+        break;
+    case PROP_OUTPUT_FRAMERATE:
+        gst_value_set_fraction(value, src->output_fps_n, src->output_fps_d);
+        break;
+    case PROP_RING_DURATION:
+        g_value_set_double(value, src->ring_duration);
+        break;
+    case PROP_RING_MAX_SIZE:
+        g_value_set_uint(value, src->ring_max_size);
+        break;
+    case PROP_RING_LOCATION:
+        GST_OBJECT_LOCK(src);
+        g_value_set_string(value, src->ring_location);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_QOS:
+        GST_OBJECT_LOCK(src);
+        g_value_set_boolean(value, src->qos);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_QOS_LADDER:
+        g_value_set_string(value, src->qos_ladder);
+        break;
+    case PROP_THREAD_PRIORITY:
+        g_value_set_int(value, src->thread_priority);
+        break;
+    case PROP_CPU_AFFINITY:
+        g_value_set_uint64(value, src->cpu_affinity);
+        break;
+    case PROP_MLOCK_BUFFERS:
+        g_value_set_boolean(value, src->mlock_buffers);
+        break;
+    case PROP_N_THREADS:
+        g_value_set_uint(value, src->n_threads);
+        break;
+    case PROP_ALLOCATOR:
+        g_value_set_enum(value, src->allocator);
+        break;
+    case PROP_IMAGE_STATS:
+        g_value_set_boolean(value, src->image_stats);
+        break;
+    case PROP_MIN_SHARPNESS:
+        g_value_set_double(value, src->min_sharpness);
+        break;
+    case PROP_MOTION_GATE:
+        g_value_set_enum(value, src->motion_mode);
+        break;
+    case PROP_MOTION_THRESHOLD:
+        g_value_set_uint(value, src->motion_threshold);
+        break;
+    case PROP_MOTION_MIN_BLOCKS:
+        g_value_set_uint(value, src->motion_min_blocks);
+        break;
+    case PROP_MOTION_KEEP_ALIVE:
+        g_value_set_uint(value, src->motion_keep_alive);
+        break;
+    case PROP_STATS:
+        g_value_take_boxed(value,
+                           gst_zed_metrics_get_structure(src->metrics.registry, "zed-stats"));
+        break;
+    case PROP_METRICS_LOCATION:
+        GST_OBJECT_LOCK(src);
+        g_value_set_string(value, src->metrics_location);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_METRICS_SOCKET:
+        GST_OBJECT_LOCK(src);
+        g_value_set_string(value, src->metrics_socket);
+        GST_OBJECT_UNLOCK(src);
+        break;
+    case PROP_METRICS_INTERVAL:
+        g_value_set_uint(value, src->metrics_interval);
+        break;
     case PROP_BRIGHTNESS:
         g_value_set_int(value, src->brightness);
         break;
@@ -1201,6 +2063,24 @@ void gst_zedsrc_get_property(GObject *object, guint property_id, GValue *value,
     case PROP_LEDSTATUS:
         g_value_set_boolean(value, src->led_status);
         break;
+    case PROP_RECONNECT_POLICY:
+        g_value_set_enum(value, src->reconnect_policy);
+        break;
+    case PROP_RECONNECT_MIN_DELAY:
+        g_value_set_int(value, src->reconnect_min_delay);
+        break;
+    case PROP_RECONNECT_MAX_DELAY:
+        g_value_set_int(value, src->reconnect_max_delay);
+        break;
+    case PROP_RECONNECT_MAX_ATTEMPTS:
+        g_value_set_int(value, src->reconnect_max_attempts);
+        break;
+    case PROP_KEEP_OPEN:
+        g_value_set_boolean(value, src->keep_open);
+        break;
+    case PROP_SHARED_CAMERA:
+        g_value_set_boolean(value, src->shared_camera);
+        break;
 
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
@@ -1235,97 +2115,554 @@ void gst_zedsrc_finalize(GObject *object) {
         src->caps = NULL;
     }
 
+    g_mutex_clear(&src->reconnect_lock);
+
+    // Cameras left open by this element and not adopted by another one
+    gst_zed_camera_registry_release(src);
+    src->zed.reset();
+
+    src->left_img.reset();
+    src->depth_data.reset();
+    src->point_cloud.reset();
+    src->confidence_map.reset();
+    src->roi_mask.reset();
+    g_free(src->roi_list);
+    src->roi_list = NULL;
+    g_free(src->ring_location);
+    src->ring_location = NULL;
+    g_free(src->qos_ladder);
+    src->qos_ladder = NULL;
+    g_free(src->metrics_location);
+    src->metrics_location = NULL;
+    g_free(src->metrics_socket);
+    src->metrics_socket = NULL;
+    gst_zed_capture_metrics_clear(&src->metrics);
+
     G_OBJECT_CLASS(gst_zedsrc_parent_class)->finalize(object);
 }
 
+/* Formats of the color stream types, the single views are converted while copied */
+static void gst_zedsrc_set_color_formats(GstStructure *structure) {
+    GValue formats = G_VALUE_INIT;
+    GValue fmt = G_VALUE_INIT;
+
+    gst_value_list_init(&formats, 4);
+    g_value_init(&fmt, G_TYPE_STRING);
+    for (const gchar *name : {"BGRA", "BGR", "RGB", "GRAY8"}) {
+        g_value_set_string(&fmt, name);
+        gst_value_list_append_value(&formats, &fmt);
+    }
+    gst_structure_set_value(structure, "format", &formats);
+    g_value_unset(&fmt);
+    g_value_unset(&formats);
+}
+
 static gboolean gst_zedsrc_calculate_caps(GstZedSrc *src) {
     GST_TRACE_OBJECT(src, "gst_zedsrc_calculate_caps");
 
     guint32 width, height;
-    gint fps;
+    gint fps, fps_n, fps_d;
     GstVideoInfo vinfo;
     GstVideoFormat format = GST_VIDEO_FORMAT_BGRA;
 
-    if (src->stream_type == GST_ZEDSRC_DEPTH_16) {
+    if (src->stream_type == GST_ZEDSRC_DEPTH_16 || src->stream_type == GST_ZEDSRC_DISPARITY_16 ||
+        src->stream_type == GST_ZEDSRC_DEPTH_CONFIDENCE) {
         format = GST_VIDEO_FORMAT_GRAY16_LE;
+    } else if (src->stream_type == GST_ZEDSRC_CONFIDENCE_8) {
+        format = GST_VIDEO_FORMAT_GRAY8;
     }
 
-    sl::CameraInformation cam_info = src->zed.getCameraInformation();
+    sl::CameraInformation cam_info = src->zed->getCameraInformation();
 
     width = cam_info.camera_configuration.resolution.width;
     height = cam_info.camera_configuration.resolution.height;
 
+    // ----> Output crop
+    src->out_crop = FALSE;
+    if (src->roi_output_crop) {
+        GST_OBJECT_LOCK(src);   // Region of interest changed while streaming
+        src->out_crop = gst_zedsrc_roi_valid(src, cam_info.camera_configuration.resolution);
+        src->out_crop_rect = sl::Rect(src->roi_x, src->roi_y, src->roi_w, src->roi_h);
+        GST_OBJECT_UNLOCK(src);
+        if (src->out_crop) {
+            width = src->out_crop_rect.width;
+            height = src->out_crop_rect.height;
+            GST_INFO_OBJECT(src, "Output cropped to the region of interest: (%u,%u)-%ux%u",
+                            (guint) src->out_crop_rect.x, (guint) src->out_crop_rect.y, width,
+                            height);
+        } else {
+            GST_WARNING_OBJECT(src, "'roi-output-crop' enabled without a valid region of "
+                                    "interest: full frame output");
+        }
+    }
+    // <---- Output crop
+
      if (src->stream_type == GST_ZEDSRC_LEFT_RIGHT || src->stream_type == GST_ZEDSRC_LEFT_DEPTH) {
         width *= 2; // Double the width for Side-by-Side
     }
 
+    // ----> Output scaling
+    src->caps_scale = FALSE;
+    if (src->scale_width != 0) {
+        if (!GST_ZEDSRC_IS_COLOR(src->stream_type)) {
+            GST_WARNING_OBJECT(src, "'scale-output' only applies to image stream types: "
+                                    "not scaled");
+        } else if (src->scale_width > width || src->scale_height > height ||
+                   (src->stream_type == GST_ZEDSRC_LEFT_RIGHT && src->scale_width % 2 != 0)) {
+            GST_WARNING_OBJECT(src,
+                               "'scale-output' %ux%u is not a downscaling of the %ux%u output "
+                               "(even width required for 'Stereo couple'): not scaled",
+                               src->scale_width, src->scale_height, width, height);
+        } else {
+            src->caps_scale = TRUE;
+            width = src->scale_width;
+            height = src->scale_height;
+            GST_INFO_OBJECT(src, "Output scaled to %ux%u", width, height);
+        }
+    }
+
+    if ((src->qos_active & GST_ZEDSRC_QOS_SCALE_HALF) && GST_ZEDSRC_IS_COLOR(src->stream_type)) {
+        width = (src->stream_type == GST_ZEDSRC_LEFT_RIGHT) ? width / 4 * 2 : width / 2;
+        height /= 2;
+        src->caps_scale = TRUE;
+        GST_INFO_OBJECT(src, "QoS: output scaled to %ux%u", width, height);
+    }
+    // <---- Output scaling
+
     fps = static_cast<gint>(cam_info.camera_configuration.fps);
 
-    if (format != GST_VIDEO_FORMAT_UNKNOWN) {
-        gst_video_info_init(&vinfo);
-        gst_video_info_set_format(&vinfo, format, width, height);
-        if (src->caps) {
-            gst_caps_unref(src->caps);
+    // ----> Output frame rate
+    fps_n = fps;
+    fps_d = 1;
+    src->decimate_n = 0;
+    if (src->output_fps_n > 0) {
+        if (gst_util_fraction_compare(src->output_fps_n, src->output_fps_d, fps, 1) >= 0) {
+            GST_WARNING_OBJECT(src,
+                               "'output-framerate' %d/%d is not lower than the camera frame "
+                               "rate %d: not decimated",
+                               src->output_fps_n, src->output_fps_d, fps);
+        } else {
+            fps_n = src->output_fps_n;
+            fps_d = src->output_fps_d;
+            // A frame is output each time the accumulator reaches a camera frame period
+            src->decimate_n = static_cast<guint64>(fps_n);
+            src->decimate_d = static_cast<guint64>(fps) * fps_d;
+            src->decimate_acc = src->decimate_d - src->decimate_n;   // First frame output
+            GST_INFO_OBJECT(src, "Output frame rate decimated to %d/%d", fps_n, fps_d);
         }
-        src->out_framesize = (guint) GST_VIDEO_INFO_SIZE(&vinfo);
-        vinfo.fps_n = fps;
-        vinfo.fps_d = 1;
-        src->caps = gst_video_info_to_caps(&vinfo);
     }
 
-    gst_base_src_set_blocksize(GST_BASE_SRC(src), src->out_framesize);
-    gst_base_src_set_caps(GST_BASE_SRC(src), src->caps);
-    GST_DEBUG_OBJECT(src, "Created caps %" GST_PTR_FORMAT, src->caps);
+    if (src->qos_active & GST_ZEDSRC_QOS_DECIMATE) {
+        gst_util_fraction_multiply(fps_n, fps_d, 1, 2, &fps_n, &fps_d);
+        GST_INFO_OBJECT(src, "QoS: output frame rate decimated to %d/%d", fps_n, fps_d);
+    }
+    // <---- Output frame rate
 
-    return TRUE;
+    if (GST_ZEDSRC_IS_POINTCLOUD(src->stream_type)) {
+        // ----> Point cloud
+        gboolean xyz = (src->stream_type == GST_ZEDSRC_POINTCLOUD_XYZ);
+        guint point_size = (xyz ? 3 : 4) * sizeof(float);
+
+        width = (width + src->pointcloud_stride - 1) / src->pointcloud_stride;
+        height = (height + src->pointcloud_stride - 1) / src->pointcloud_stride;
+
+        if (src->caps) {
+            gst_caps_unref(src->caps);
+        }
+        src->out_stride = width * point_size;
+        src->out_framesize = src->out_stride * height;
+        src->caps = gst_caps_new_simple("application/x-zed-pointcloud", "format", G_TYPE_STRING,
+                                        xyz ? "XYZ" : "XYZRGBA", "width", G_TYPE_INT, width,
+                                        "height", G_TYPE_INT, height, "organized",
+                                        G_TYPE_BOOLEAN, TRUE, "framerate", GST_TYPE_FRACTION, fps_n,
+                                        fps_d, NULL);
+        // <---- Point cloud
+    } else if (src->stream_type == GST_ZEDSRC_DISPARITY_F32) {
+        if (src->caps) {
+            gst_caps_unref(src->caps);
+        }
+        src->out_stride = width * sizeof(float);
+        src->out_framesize = src->out_stride * height;
+        src->caps = gst_caps_new_simple("application/x-zed-disparity", "format", G_TYPE_STRING,
+                                        "F32", "width", G_TYPE_INT, width, "height", G_TYPE_INT,
+                                        height, "framerate", GST_TYPE_FRACTION, fps_n, fps_d, NULL);
+    } else if (GST_ZEDSRC_IS_COLOR(src->stream_type)) {
+        // ----> Color images
+        // Downstream picks the cheapest format, the frame size is known once negotiated
+        if (src->caps) {
+            gst_caps_unref(src->caps);
+        }
+        src->caps = gst_caps_new_simple("video/x-raw", "width", G_TYPE_INT, width, "height",
+                                        G_TYPE_INT, height, "framerate", GST_TYPE_FRACTION, fps_n,
+                                        fps_d, "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1, NULL);
+        gst_zedsrc_set_color_formats(gst_caps_get_structure(src->caps, 0));
+        // <---- Color images
+    } else if (format != GST_VIDEO_FORMAT_UNKNOWN) {
+        gst_video_info_init(&vinfo);
+        gst_video_info_set_format(&vinfo, format, width, height);
+        if (src->caps) {
+            gst_caps_unref(src->caps);
+        }
+        src->out_framesize = (guint) GST_VIDEO_INFO_SIZE(&vinfo);
+        src->out_stride = (guint) GST_VIDEO_INFO_PLANE_STRIDE(&vinfo, 0);
+        src->out_format = format;
+        vinfo.fps_n = fps_n;
+        vinfo.fps_d = fps_d;
+        src->caps = gst_video_info_to_caps(&vinfo);
+    }
+
+    if (gst_caps_is_fixed(src->caps)) {
+        gst_base_src_set_blocksize(GST_BASE_SRC(src), src->out_framesize);
+        gst_base_src_set_caps(GST_BASE_SRC(src), src->caps);
+    }
+    GST_DEBUG_OBJECT(src, "Created caps %" GST_PTR_FORMAT, src->caps);
+
+    return TRUE;
 }
 
-static gboolean gst_zedsrc_start(GstBaseSrc *bsrc) {
-#if (ZED_SDK_MAJOR_VERSION != 5)
-    GST_ELEMENT_ERROR(src, LIBRARY, FAILED,
-    ("Wrong ZED SDK version. SDK v5.0 EA or newer required "),
-                      (NULL));
-#endif
+static gboolean gst_zedsrc_camera_resolution(gint res, sl::RESOLUTION *resolution) {
+    switch (res) {
+    case GST_ZEDSRC_HD2K:
+        *resolution = sl::RESOLUTION::HD2K;
+        break;
+    case GST_ZEDSRC_HD1080:
+        *resolution = sl::RESOLUTION::HD1080;
+        break;
+    case GST_ZEDSRC_HD1200:
+        *resolution = sl::RESOLUTION::HD1200;
+        break;
+    case GST_ZEDSRC_HD720:
+        *resolution = sl::RESOLUTION::HD720;
+        break;
+    case GST_ZEDSRC_SVGA:
+        *resolution = sl::RESOLUTION::SVGA;
+        break;
+    case GST_ZEDSRC_VGA:
+        *resolution = sl::RESOLUTION::VGA;
+        break;
+    case GST_ZEDSRC_AUTO_RES:
+        *resolution = sl::RESOLUTION::AUTO;
+        break;
+    default:
+        return FALSE;
+    }
+    return TRUE;
+}
 
-    GstZedSrc *src = GST_ZED_SRC(bsrc);
-    sl::ERROR_CODE ret;
+// ----> Camera probe
+/* Setting preventing the camera mode from following the caps, NULL if none */
+static const gchar *gst_zedsrc_fixed_mode_reason(GstZedSrc *src) {
+    // Same input priority as `gst_zedsrc_set_init_params`
+    if (src->svo_file.len != 0 ||
+        (src->camera_id == DEFAULT_PROP_CAM_ID && src->camera_sn == DEFAULT_PROP_CAM_SN &&
+         src->stream_ip.len != 0)) {
+        return "an SVO file or a stream input";
+    }
+    if (src->roi_output_crop) {
+        return "'roi-output-crop'";
+    }
+    if (src->scale_width != 0) {
+        return "'scale-output'";
+    }
+    if (src->output_fps_n != 0) {
+        return "'output-framerate'";
+    }
+    if (src->stream_type == GST_ZEDSRC_LEFT_DEPTH) {
+        return "the 'Left and Depth' stream type";
+    }
+    return NULL;
+}
 
-    GST_TRACE_OBJECT(src, "gst_zedsrc_calculate_caps");
+/* Modes of the live camera selected by the input properties, restricted to
+ * 'camera-resolution' when set. Returns 0 when the input cannot be probed or when
+ * the output size does not follow the camera resolution. */
+static guint gst_zedsrc_probe_modes(GstZedSrc *src, const GstZedCameraMode **modes) {
+    sl::RESOLUTION resolution;
 
-    // ----> Set init parameters
-    sl::InitParameters init_params;
+    if (gst_zedsrc_fixed_mode_reason(src) ||
+        !gst_zedsrc_camera_resolution(src->camera_resolution, &resolution)) {
+        return 0;
+    }
 
-    GST_INFO("CAMERA INITIALIZATION PARAMETERS");
+    guint serial_number =
+        (src->camera_id == DEFAULT_PROP_CAM_ID) ? static_cast<guint>(src->camera_sn) : 0;
+    guint n_modes = gst_zed_camera_probe(serial_number, src->camera_id, modes);
 
-    switch(src->camera_resolution) {
-        case GST_ZEDSRC_HD2K:
-            init_params.camera_resolution = sl::RESOLUTION::HD2K;
-            break;
-        case GST_ZEDSRC_HD1080:
-            init_params.camera_resolution = sl::RESOLUTION::HD1080;
-            break;
-        case GST_ZEDSRC_HD1200:
-            init_params.camera_resolution = sl::RESOLUTION::HD1200;
-            break;
-        case GST_ZEDSRC_HD720:
-            init_params.camera_resolution = sl::RESOLUTION::HD720;
-            break;
-        case GST_ZEDSRC_SVGA:
-            init_params.camera_resolution = sl::RESOLUTION::SVGA;
-            break;
-        case GST_ZEDSRC_VGA:
-            init_params.camera_resolution = sl::RESOLUTION::SVGA;
-            break;
-        case GST_ZEDSRC_AUTO_RES:
-            init_params.camera_resolution = sl::RESOLUTION::AUTO;
+    if (resolution == sl::RESOLUTION::AUTO) {
+        return n_modes;
+    }
+    for (guint i = 0; i < n_modes; i++) {
+        if ((*modes)[i].resolution == resolution) {
+            *modes += i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Caps structure of the stream type for the camera `mode`, with all its frame rates */
+static GstStructure *gst_zedsrc_probe_structure(GstZedSrc *src, const GstZedCameraMode *mode) {
+    gint width = static_cast<gint>(mode->width);
+    gint height = static_cast<gint>(mode->height);
+    GstStructure *structure;
+
+    if (src->stream_type == GST_ZEDSRC_LEFT_RIGHT) {
+        width *= 2;
+    }
+
+    if (GST_ZEDSRC_IS_COLOR(src->stream_type)) {
+        structure =
+            gst_structure_new("video/x-raw", "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1, NULL);
+        gst_zedsrc_set_color_formats(structure);
+    } else if (GST_ZEDSRC_IS_POINTCLOUD(src->stream_type)) {
+        width = (width + src->pointcloud_stride - 1) / src->pointcloud_stride;
+        height = (height + src->pointcloud_stride - 1) / src->pointcloud_stride;
+        structure = gst_structure_new(
+            "application/x-zed-pointcloud", "format", G_TYPE_STRING,
+            src->stream_type == GST_ZEDSRC_POINTCLOUD_XYZ ? "XYZ" : "XYZRGBA", "organized",
+            G_TYPE_BOOLEAN, TRUE, NULL);
+    } else if (src->stream_type == GST_ZEDSRC_DISPARITY_F32) {
+        structure =
+            gst_structure_new("application/x-zed-disparity", "format", G_TYPE_STRING, "F32", NULL);
+    } else {
+        structure = gst_structure_new(
+            "video/x-raw", "format", G_TYPE_STRING,
+            src->stream_type == GST_ZEDSRC_CONFIDENCE_8 ? "GRAY8" : "GRAY16_LE", NULL);
+    }
+
+    GValue rates = G_VALUE_INIT;
+    GValue rate = G_VALUE_INIT;
+
+    gst_value_list_init(&rates, 4);
+    g_value_init(&rate, GST_TYPE_FRACTION);
+    for (const gint *fps = mode->fps; *fps != 0; fps++) {
+        gst_value_set_fraction(&rate, *fps, 1);
+        gst_value_list_append_value(&rates, &rate);
+    }
+    gst_structure_set(structure, "width", G_TYPE_INT, width, "height", G_TYPE_INT, height, NULL);
+    gst_structure_set_value(structure, "framerate", &rates);
+    g_value_unset(&rate);
+    g_value_unset(&rates);
+
+    return structure;
+}
+
+/* Caps of the stream type for each of the `n_modes` camera modes, in the same order */
+static GstCaps *gst_zedsrc_probe_caps(GstZedSrc *src, const GstZedCameraMode *modes,
+                                      guint n_modes) {
+    GstCaps *caps = gst_caps_new_empty();
+
+    for (guint i = 0; i < n_modes; i++) {
+        gst_caps_append_structure(caps, gst_zedsrc_probe_structure(src, &modes[i]));
+    }
+
+    return caps;
+}
+
+/* Pick the camera mode among the probed ones from the caps accepted downstream,
+ * in the downstream order of preference and with the frame rate nearest to
+ * 'camera-fps'. The camera must be opened before the first negotiation, so the
+ * downstream caps are queried here instead of being fixated later. When all the
+ * modes are accepted the properties are kept. */
+static void gst_zedsrc_select_mode(GstZedSrc *src) {
+    const GstZedCameraMode *modes = NULL;
+    guint n_modes = gst_zedsrc_probe_modes(src, &modes);
+
+    src->mode_resolution = -1;
+    if (n_modes == 0) {
+        return;
+    }
+
+    GstCaps *probed = gst_zedsrc_probe_caps(src, modes, n_modes);
+    GstCaps *peer = gst_pad_peer_query_caps(GST_BASE_SRC_PAD(src), NULL);
+
+    if (!gst_caps_is_subset(probed, peer)) {
+        for (guint p = 0; p < gst_caps_get_size(peer) && src->mode_resolution < 0; p++) {
+            GstStructure *accepted = gst_caps_get_structure(peer, p);
+
+            for (guint i = 0; i < n_modes; i++) {
+                GstStructure *mode = gst_structure_intersect(gst_caps_get_structure(probed, i),
+                                                             accepted);
+                if (!mode) {
+                    continue;
+                }
+
+                gint fps_n, fps_d;
+                gst_structure_fixate_field_nearest_fraction(mode, "framerate", src->camera_fps,
+                                                            1);
+                gst_structure_get_fraction(mode, "framerate", &fps_n, &fps_d);
+                gst_structure_free(mode);
+
+                src->mode_resolution = static_cast<gint>(modes[i].resolution);
+                src->mode_fps = fps_n / fps_d;
+                GST_INFO_OBJECT(src, "Camera mode picked from downstream caps: %ux%u@%d",
+                                modes[i].width, modes[i].height, src->mode_fps);
+                break;
+            }
+        }
+    }
+
+    gst_caps_unref(peer);
+    gst_caps_unref(probed);
+}
+// <---- Camera probe
+
+// ----> Camera mode switch
+/* Caps offered while streaming: the current mode first, then the other modes of
+ * the camera, switched to when negotiated. After a change of 'camera-resolution'
+ * or 'camera-fps' the mode requested by the properties is offered first. */
+static GstCaps *gst_zedsrc_streaming_caps(GstZedSrc *src) {
+    GstCaps *caps = gst_caps_copy(src->caps);
+    const GstZedCameraMode *modes = NULL;
+    guint n_modes = src->hub ? 0 : gst_zedsrc_probe_modes(src, &modes);
+
+    if (n_modes == 0) {
+        return caps;
+    }
+
+    GST_OBJECT_LOCK(src);
+    gboolean update = src->mode_update;
+    gint fps = src->camera_fps;
+    GST_OBJECT_UNLOCK(src);
+
+    if (update) {
+        // With 'camera-resolution' AUTO only the frame rate changes
+        sl::Resolution current = src->zed->getCameraInformation().camera_configuration.resolution;
+
+        for (guint i = 0; i < n_modes; i++) {
+            if (n_modes > 1 && (modes[i].width != static_cast<guint>(current.width) ||
+                                modes[i].height != static_cast<guint>(current.height))) {
+                continue;
+            }
+
+            const gint *rate = modes[i].fps;
+            while (*rate != 0 && *rate != fps) {
+                rate++;
+            }
+            if (*rate == 0) {
+                GST_WARNING_OBJECT(src, "%d FPS not supported at %ux%u: mode not switched", fps,
+                                   modes[i].width, modes[i].height);
+                break;
+            }
+
+            GstCaps *requested = gst_caps_new_full(gst_zedsrc_probe_structure(src, &modes[i]),
+                                                   NULL);
+            gst_caps_set_simple(requested, "framerate", GST_TYPE_FRACTION, fps, 1, NULL);
+            caps = gst_caps_merge(requested, caps);
             break;
-        default:
-            GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
-                              ("Failed to set camera resolution"), (NULL));
-            return FALSE;
+        }
+    }
+
+    return gst_caps_merge(caps, gst_zedsrc_probe_caps(src, modes, n_modes));
+}
+
+/* Find the camera mode of `caps` not matching the opened camera mode. The camera is
+ * re-opened in this mode by the streaming thread after the current buffer. */
+static gboolean gst_zedsrc_prepare_mode_switch(GstZedSrc *src, GstCaps *caps) {
+    const GstZedCameraMode *modes = NULL;
+    guint n_modes = src->hub ? 0 : gst_zedsrc_probe_modes(src, &modes);
+    GstStructure *negotiated = gst_caps_get_structure(caps, 0);
+
+    for (guint i = 0; i < n_modes; i++) {
+        GstStructure *mode = gst_zedsrc_probe_structure(src, &modes[i]);
+        gboolean match = gst_structure_can_intersect(mode, negotiated);
+        gst_structure_free(mode);
+        if (!match) {
+            continue;
+        }
+
+        gint fps_n = 0, fps_d = 1;
+        gst_structure_get_fraction(negotiated, "framerate", &fps_n, &fps_d);
+
+        src->mode_resolution = static_cast<gint>(modes[i].resolution);
+        src->mode_fps = fps_n / fps_d;
+        src->mode_switch_pending = TRUE;
+        GST_INFO_OBJECT(src, "Switching to the camera mode %ux%u@%d", modes[i].width,
+                        modes[i].height, src->mode_fps);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* Start a camera mode switch when the caps preferred downstream are of another mode.
+ * A change of mode that cannot be honoured is reported instead of being ignored. */
+static gboolean gst_zedsrc_request_mode_switch(GstZedSrc *src) {
+    GstPad *pad = GST_BASE_SRC_PAD(src);
+    GstCaps *thiscaps = gst_pad_query_caps(pad, NULL);
+    GstCaps *peercaps = gst_pad_peer_query_caps(pad, thiscaps);
+    gboolean pending = FALSE;
+    gboolean rejected = TRUE;
+
+    // Same preference as the negotiation of basesrc: first structure accepted downstream
+    if (peercaps && !gst_caps_is_empty(peercaps)) {
+        rejected = FALSE;
+        if (!gst_caps_is_any(peercaps)) {
+            GstCaps *preferred = gst_caps_copy_nth(peercaps, 0);
+            if (!gst_zed_caps_can_intersect_any_memory(preferred, src->caps)) {
+                pending = gst_zedsrc_prepare_mode_switch(src, preferred);
+            }
+            gst_caps_unref(preferred);
+        }
+    }
+
+    const gchar *reason = src->hub ? "'shared-camera'" : gst_zedsrc_fixed_mode_reason(src);
+
+    GST_OBJECT_LOCK(src);
+    gboolean update = src->mode_update;
+    if (!pending && reason) {
+        src->mode_update = FALSE;   // Reported once
+    }
+    GST_OBJECT_UNLOCK(src);
+
+    if (!pending && (rejected || update) && reason) {
+        GST_ELEMENT_WARNING(src, CORE, NEGOTIATION,
+                            ("Camera mode not switched: not supported with %s", reason), (NULL));
+    }
+
+    if (peercaps) {
+        gst_caps_unref(peercaps);
+    }
+    gst_caps_unref(thiscaps);
+
+    return pending;
+}
+
+/* Called at a buffer boundary once the camera is re-opened in the new mode, before
+ * the new caps are negotiated */
+static void gst_zedsrc_end_mode_switch(GstZedSrc *src) {
+    sl::CameraConfiguration config = src->zed->getCameraInformation().camera_configuration;
+
+    src->mode_switching = FALSE;
+    gst_buffer_replace(&src->last_buffer, NULL);   // Frame of the previous mode
+
+    gst_zedsrc_calculate_caps(src);
+
+    gst_element_post_message(
+        GST_ELEMENT(src),
+        gst_message_new_element(
+            GST_OBJECT(src),
+            gst_structure_new("zed-camera-mode", "width", G_TYPE_INT, config.resolution.width,
+                              "height", G_TYPE_INT, config.resolution.height, "fps",
+                              G_TYPE_DOUBLE, static_cast<gdouble>(config.fps), NULL)));
+}
+// <---- Camera mode switch
+
+static gboolean gst_zedsrc_set_init_params(GstZedSrc *src, sl::InitParameters &init_params) {
+    GST_INFO("CAMERA INITIALIZATION PARAMETERS");
+
+    if (!gst_zedsrc_camera_resolution(src->camera_resolution, &init_params.camera_resolution)) {
+        GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
+                          ("Failed to set camera resolution"), (NULL));
+        return FALSE;
     }
-    GST_INFO(" * Camera resolution: %s", sl::toString(init_params.camera_resolution).c_str());
     init_params.camera_fps = src->camera_fps;
+    if (src->mode_resolution >= 0) {
+        // Mode picked from the caps accepted downstream
+        init_params.camera_resolution = static_cast<sl::RESOLUTION>(src->mode_resolution);
+        init_params.camera_fps = src->mode_fps;
+    }
+    GST_INFO(" * Camera resolution: %s", sl::toString(init_params.camera_resolution).c_str());
     GST_INFO(" * Camera FPS: %d", init_params.camera_fps);
     init_params.sdk_verbose = src->sdk_verbose == TRUE;
     GST_INFO(" * SDK verbose: %s", (init_params.sdk_verbose ? "TRUE" : "FALSE"));
@@ -1334,7 +2671,7 @@ static gboolean gst_zedsrc_start(GstBaseSrc *bsrc) {
              sl::toString(static_cast<sl::FLIP_MODE>(init_params.camera_image_flip)).c_str());
 
     init_params.depth_mode = static_cast<sl::DEPTH_MODE>(src->depth_mode);
-    if ((src->stream_type == GST_ZEDSRC_LEFT_DEPTH || src->stream_type == GST_ZEDSRC_DEPTH_16) &&
+    if (GST_ZEDSRC_NEEDS_DEPTH(src->stream_type) &&
         init_params.depth_mode == sl::DEPTH_MODE::NONE) {
         init_params.depth_mode = sl::DEPTH_MODE::NEURAL;
         src->depth_mode = static_cast<gint>(init_params.depth_mode);
@@ -1386,41 +2723,61 @@ static gboolean gst_zedsrc_start(GstBaseSrc *bsrc) {
     } else {
         GST_INFO(" * Input from default device");
     }
-    // <---- Set init parameters
 
-    // ----> Open camera
-    ret = src->zed.open(init_params);
+    return TRUE;
+}
 
-    if (ret > sl::ERROR_CODE::SUCCESS) {
-        GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
-                          ("Failed to open camera, '%s'", sl::toString(ret).c_str()), (NULL));
-        return FALSE;
+static gchar *gst_zedsrc_input_key(GstZedSrc *src) {
+    // Same priority as `gst_zedsrc_set_init_params`
+    if (src->svo_file.len != 0) {
+        return g_strdup_printf("svo:%s", src->svo_file.str);
+    } else if (src->camera_id != DEFAULT_PROP_CAM_ID) {
+        return g_strdup_printf("id:%d", src->camera_id);
+    } else if (src->camera_sn != DEFAULT_PROP_CAM_SN) {
+        return g_strdup_printf("sn:%" G_GINT64_FORMAT, src->camera_sn);
+    } else if (src->stream_ip.len != 0) {
+        return g_strdup_printf("stream:%s:%d", src->stream_ip.str, src->stream_port);
     }
-    // <---- Open camera
+    return g_strdup_printf("id:%d", DEFAULT_PROP_CAM_ID);
+}
 
-    // ----> Camera Controls
+static gchar *gst_zedsrc_params_key(const sl::InitParameters &init_params) {
+    return g_strdup_printf(
+        "res=%d fps=%d flip=%d depth=%d units=%d coord=%d min=%g max=%g stab=%d selfcalib=%d "
+        "verbose=%d calib=%s",
+        static_cast<int>(init_params.camera_resolution), init_params.camera_fps,
+        static_cast<int>(init_params.camera_image_flip), static_cast<int>(init_params.depth_mode),
+        static_cast<int>(init_params.coordinate_units),
+        static_cast<int>(init_params.coordinate_system), init_params.depth_minimum_distance,
+        init_params.depth_maximum_distance, init_params.depth_stabilization,
+        static_cast<int>(init_params.camera_disable_self_calib),
+        static_cast<int>(init_params.sdk_verbose),
+        init_params.optional_opencv_calibration_file.c_str());
+}
+
+static void gst_zedsrc_apply_camera_controls(GstZedSrc *src) {
     GST_INFO("CAMERA CONTROLS");
-    src->zed.setCameraSettings((sl::VIDEO_SETTINGS::BRIGHTNESS), (src->brightness));
+    src->zed->setCameraSettings((sl::VIDEO_SETTINGS::BRIGHTNESS), (src->brightness));
     GST_INFO(" * BRIGHTNESS: %d", src->brightness);
-    src->zed.setCameraSettings(sl::VIDEO_SETTINGS::CONTRAST, src->contrast);
+    src->zed->setCameraSettings(sl::VIDEO_SETTINGS::CONTRAST, src->contrast);
     GST_INFO(" * CONTRAST: %d", src->contrast);
-    src->zed.setCameraSettings(sl::VIDEO_SETTINGS::HUE, src->hue);
+    src->zed->setCameraSettings(sl::VIDEO_SETTINGS::HUE, src->hue);
     GST_INFO(" * HUE: %d", src->hue);
-    src->zed.setCameraSettings(sl::VIDEO_SETTINGS::SATURATION, src->saturation);
+    src->zed->setCameraSettings(sl::VIDEO_SETTINGS::SATURATION, src->saturation);
     GST_INFO(" * SATURATION: %d", src->saturation);
-    src->zed.setCameraSettings(sl::VIDEO_SETTINGS::SHARPNESS, src->sharpness);
+    src->zed->setCameraSettings(sl::VIDEO_SETTINGS::SHARPNESS, src->sharpness);
     GST_INFO(" * SHARPNESS: %d", src->sharpness);
-    src->zed.setCameraSettings(sl::VIDEO_SETTINGS::GAMMA, src->gamma);
+    src->zed->setCameraSettings(sl::VIDEO_SETTINGS::GAMMA, src->gamma);
     GST_INFO(" * GAMMA: %d", src->gamma);
     if (src->aec_agc == FALSE) {
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::AEC_AGC, src->aec_agc);
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::AEC_AGC, src->aec_agc);
         GST_INFO(" * AEC_AGC: %s", (src->aec_agc ? "TRUE" : "FALSE"));
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::EXPOSURE, src->exposure);
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::EXPOSURE, src->exposure);
         GST_INFO(" * EXPOSURE: %d", src->exposure);
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::GAIN, src->gain);
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::GAIN, src->gain);
         GST_INFO(" * GAIN: %d", src->gain);
     } else {
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::AEC_AGC, src->aec_agc);
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::AEC_AGC, src->aec_agc);
         GST_INFO(" * AEC_AGC: %s", (src->aec_agc ? "TRUE" : "FALSE"));
 
         if (src->aec_agc_roi_x != -1 && src->aec_agc_roi_y != -1 && src->aec_agc_roi_w != -1 &&
@@ -1437,262 +2794,1786 @@ static gboolean gst_zedsrc_start(GstBaseSrc *bsrc) {
                      src->aec_agc_roi_y, src->aec_agc_roi_w, src->aec_agc_roi_h,
                      src->aec_agc_roi_side);
 
-            src->zed.setCameraSettings(sl::VIDEO_SETTINGS::AEC_AGC_ROI, roi, side);
+            src->zed->setCameraSettings(sl::VIDEO_SETTINGS::AEC_AGC_ROI, roi, side);
         }
 
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::AUTO_EXPOSURE_TIME_RANGE, src->exposureRange_min, src->exposureRange_max);
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::AUTO_EXPOSURE_TIME_RANGE, src->exposureRange_min, src->exposureRange_max);
         GST_INFO(" * AUTO EXPOSURE TIME RANGE: [%d,%d]", src->exposureRange_min, src->exposureRange_max);
     }
     if (src->whitebalance_temperature_auto == FALSE) {
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::WHITEBALANCE_AUTO,
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::WHITEBALANCE_AUTO,
                                    src->whitebalance_temperature_auto);
         GST_INFO(" * WHITEBALANCE_AUTO: %s",
                  (src->whitebalance_temperature_auto ? "TRUE" : "FALSE"));
         src->whitebalance_temperature /= 100;
         src->whitebalance_temperature *= 100;
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::WHITEBALANCE_TEMPERATURE,
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::WHITEBALANCE_TEMPERATURE,
                                    src->whitebalance_temperature);
         GST_INFO(" * WHITEBALANCE_TEMPERATURE: %d", src->whitebalance_temperature);
 
     } else {
-        src->zed.setCameraSettings(sl::VIDEO_SETTINGS::WHITEBALANCE_AUTO,
+        src->zed->setCameraSettings(sl::VIDEO_SETTINGS::WHITEBALANCE_AUTO,
                                    src->whitebalance_temperature_auto);
         GST_INFO(" * WHITEBALANCE_AUTO: %s",
                  (src->whitebalance_temperature_auto ? "TRUE" : "FALSE"));
     }
-    src->zed.setCameraSettings(sl::VIDEO_SETTINGS::LED_STATUS, src->led_status);
+    src->zed->setCameraSettings(sl::VIDEO_SETTINGS::LED_STATUS, src->led_status);
     GST_INFO(" * LED_STATUS: %s", (src->led_status ? "ON" : "OFF"));
-    // <---- Camera Controls
+}
 
-    // ----> Runtime parameters
-    GST_TRACE_OBJECT(src, "CAMERA RUNTIME PARAMETERS");
+/* TRUE if the region of interest is enabled and fits in a `resolution` frame */
+static gboolean gst_zedsrc_roi_valid(GstZedSrc *src, const sl::Resolution &resolution) {
+    if (!src->roi || src->roi_x == -1 || src->roi_y == -1 || src->roi_w == -1 ||
+        src->roi_h == -1) {
+        return FALSE;
+    }
 
-    GST_INFO(" * Depth Confidence threshold: %d", src->confidence_threshold);
-    GST_INFO(" * Depth Texture Confidence threshold: %d", src->texture_confidence_threshold);
-    GST_INFO(" * 3D Reference Frame: %s",
-             sl::toString((sl::COORDINATE_SYSTEM) src->measure3D_reference_frame).c_str());
-    GST_INFO(" * Fill Mode: %s", (src->fill_mode ? "TRUE" : "FALSE"));
+    int roi_x_end = src->roi_x + src->roi_w;
+    int roi_y_end = src->roi_y + src->roi_h;
+
+    return src->roi_x >= 0 && src->roi_x < resolution.width && src->roi_y >= 0 &&
+           src->roi_y < resolution.height && roi_x_end <= resolution.width &&
+           roi_y_end <= resolution.height;
+}
 
+/* Build the region of interest mask from `roi-list` and the `roi-x/y/w/h`
+ * rectangle. Returns the mask to set to the camera, empty to disable the region of
+ * interest, NULL when there is nothing to set. The mask is rebuilt only if its
+ * geometry changed since the last call, in a new `sl::Mat`: a mask returned may
+ * still be used by the grab worker. */
+static std::shared_ptr<sl::Mat> gst_zedsrc_build_roi(GstZedSrc *src) {
+    sl::Resolution resolution = src->zed->getCameraInformation().camera_configuration.resolution;
+    std::vector<GstZedRoiShape> shapes;
+
+    GST_OBJECT_LOCK(src);
+    gboolean updated = src->roi_updated;
+    src->roi_updated = FALSE;
     if (src->roi) {
-        if (src->roi_x != -1 &&
-                src->roi_y != -1 &&
-                src->roi_w != -1 &&
-                src->roi_h != -1) {
-            int roi_x_end = src->roi_x + src->roi_w;
-            int roi_y_end = src->roi_y + src->roi_h;
-            sl::Resolution resolution = sl::getResolution(init_params.camera_resolution);
-            if (src->roi_x >= 0 && src->roi_x < resolution.width &&
-                    src->roi_y >= 0 && src->roi_y < resolution.height &&
-                    roi_x_end <= resolution.width && roi_y_end <= resolution.height) {
-
-                sl::Mat roi_mask(resolution, sl::MAT_TYPE::U8_C1, sl::MEM::CPU);
-                roi_mask.setTo<sl::uchar1>(0, sl::MEM::CPU);
-                for (unsigned int v = src->roi_y; v < roi_y_end; v++)
-                  for (unsigned int u = src->roi_x; u < roi_x_end; u++)
-                        roi_mask.setValue<sl::uchar1>(u, v, 255, sl::MEM::CPU);
-
-                GST_INFO(" * ROI mask: (%d,%d)-%dx%d",
-                        src->roi_x, src->roi_y, src->roi_w, src->roi_h);
-
-                ret = src->zed.setRegionOfInterest(roi_mask);
-                if (ret!=sl::ERROR_CODE::SUCCESS) {
-                    GST_ELEMENT_ERROR (src, RESOURCE, NOT_FOUND,
-                                    ("Failed to set region of interest, '%s'", sl::toString(ret).c_str() ), (NULL));
-                    return FALSE;
-                }
-            }
+        gst_zed_roi_parse(src->roi_list, shapes);   // Validated when set
+        if (gst_zedsrc_roi_valid(src, resolution)) {
+            GstZedRoiShape rect;
+            rect.polygon = FALSE;
+            rect.coords = {src->roi_x, src->roi_y, src->roi_w, src->roi_h};
+            shapes.push_back(rect);
+            GST_INFO(" * ROI mask: (%d,%d)-%dx%d",
+                    src->roi_x, src->roi_y, src->roi_w, src->roi_h);
         }
     }
-    // <---- Runtime parameters
+    GST_OBJECT_UNLOCK(src);
 
-    if (!gst_zedsrc_calculate_caps(src)) {
-        return FALSE;
+    if (shapes.empty()) {
+        // Region of interest disabled while streaming
+        return updated ? std::make_shared<sl::Mat>() : nullptr;
     }
 
-    return TRUE;
-}
-
-static gboolean gst_zedsrc_stop(GstBaseSrc *bsrc) {
-    GstZedSrc *src = GST_ZED_SRC(bsrc);
+    guint64 hash = gst_zed_roi_hash(shapes, resolution);
+    if (!src->roi_mask || hash != src->roi_mask_hash) {
+        src->roi_mask = std::make_shared<sl::Mat>(resolution, sl::MAT_TYPE::U8_C1, sl::MEM::CPU);
+        gst_zed_roi_fill_mask(*src->roi_mask, shapes);
+        src->roi_mask_hash = hash;
+        GST_INFO(" * ROI mask: %zu shapes", shapes.size());
+    }
 
-    GST_TRACE_OBJECT(src, "gst_zedsrc_stop");
+    return src->roi_mask;
+}
 
-    gst_zedsrc_reset(src);
+/* Set the region of interest to the camera, when not grabbed by the worker */
+static sl::ERROR_CODE gst_zedsrc_apply_roi(GstZedSrc *src) {
+    std::shared_ptr<sl::Mat> mask = gst_zedsrc_build_roi(src);
 
-    return TRUE;
+    return mask ? src->zed->setRegionOfInterest(*mask) : sl::ERROR_CODE::SUCCESS;
 }
 
-static GstCaps *gst_zedsrc_get_caps(GstBaseSrc *bsrc, GstCaps *filter) {
-    GstZedSrc *src = GST_ZED_SRC(bsrc);
-    GstCaps *caps;
+/* Retrieve the views output by the element for the last grabbed frame. Called by
+ * the streaming thread, or by the camera hub grab thread when the camera is shared,
+ * with the camera CUDA context current. */
+static sl::ERROR_CODE gst_zedsrc_retrieve(sl::Camera &zed, gpointer user_data) {
+    GstZedSrc *src = GST_ZED_SRC(user_data);
+    sl::ERROR_CODE ret = sl::ERROR_CODE::SUCCESS;
 
-    if (src->caps) {
-        caps = gst_caps_copy(src->caps);
-    } else {
-        caps = gst_pad_get_pad_template_caps(GST_BASE_SRC_PAD(src));
+    if (g_atomic_int_get(&src->skip_retrieve)) {
+        return ret;   // Frame not output
+    }
+    if (GST_ZEDSRC_NEEDS_DEPTH(src->stream_type) && g_atomic_int_get(&src->qos_skip_measures)) {
+        return ret;   // QoS: the measures of the previous frame are output again
     }
 
-    GST_DEBUG_OBJECT(src, "The caps before filtering are %" GST_PTR_FORMAT, caps);
+    // The SDK provides the single views in gray directly
+    gboolean gray = (src->out_format == GST_VIDEO_FORMAT_GRAY8);
 
-    if (filter && caps) {
-        GstCaps *tmp = gst_caps_intersect(caps, filter);
-        gst_caps_unref(caps);
-        caps = tmp;
+    if (src->stream_type == GST_ZEDSRC_ONLY_LEFT) {
+        ret = zed.retrieveImage(*src->left_img, gray ? sl::VIEW::LEFT_GRAY : sl::VIEW::LEFT,
+                                sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_ONLY_RIGHT) {
+        ret = zed.retrieveImage(*src->left_img, gray ? sl::VIEW::RIGHT_GRAY : sl::VIEW::RIGHT,
+                                sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_LEFT_RIGHT) {
+        ret = zed.retrieveImage(*src->left_img, sl::VIEW::SIDE_BY_SIDE, sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_DEPTH_16) {
+        ret = zed.retrieveMeasure(*src->depth_data, sl::MEASURE::DEPTH_U16_MM, sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_LEFT_DEPTH) {
+        ret = zed.retrieveImage(*src->left_img, sl::VIEW::LEFT, sl::MEM::CPU);
+        if (ret == sl::ERROR_CODE::SUCCESS) {
+            ret = zed.retrieveMeasure(*src->depth_data, sl::MEASURE::DEPTH, sl::MEM::CPU);
+        }
+    } else if (src->stream_type == GST_ZEDSRC_POINTCLOUD_XYZ) {
+        ret = zed.retrieveMeasure(*src->point_cloud, sl::MEASURE::XYZ, sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_POINTCLOUD_XYZRGBA) {
+        ret = zed.retrieveMeasure(*src->point_cloud, sl::MEASURE::XYZRGBA, sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_CONFIDENCE_8) {
+        ret = zed.retrieveMeasure(*src->confidence_map, sl::MEASURE::CONFIDENCE, sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_DISPARITY_F32 ||
+               src->stream_type == GST_ZEDSRC_DISPARITY_16) {
+        ret = zed.retrieveMeasure(*src->depth_data, sl::MEASURE::DISPARITY, sl::MEM::CPU);
+    } else if (src->stream_type == GST_ZEDSRC_DEPTH_CONFIDENCE) {
+        ret = zed.retrieveMeasure(*src->depth_data, sl::MEASURE::DEPTH_U16_MM, sl::MEM::CPU);
+        if (ret == sl::ERROR_CODE::SUCCESS) {
+            ret = zed.retrieveMeasure(*src->confidence_map, sl::MEASURE::CONFIDENCE, sl::MEM::CPU);
+        }
     }
 
-    GST_DEBUG_OBJECT(src, "The caps after filtering are %" GST_PTR_FORMAT, caps);
-
-    return caps;
+    return ret;
 }
 
-static gboolean gst_zedsrc_set_caps(GstBaseSrc *bsrc, GstCaps *caps) {
-    GstZedSrc *src = GST_ZED_SRC(bsrc);
-    GST_TRACE_OBJECT(src, "gst_zedsrc_set_caps");
+/* Export the metrics while streaming, failures leave the stream going */
+static void gst_zedsrc_start_metrics(GstZedSrc *src) {
+    gchar *name = gst_object_get_name(GST_OBJECT(src));
+    gchar *labels = g_strdup_printf("element=\"%s\"", name);
+    g_free(name);
+
+    GST_OBJECT_LOCK(src);
+    gboolean ret = gst_zed_metrics_start_export(src->metrics.registry, labels,
+                                                src->metrics_location, src->metrics_socket,
+                                                src->metrics_interval);
+    GST_OBJECT_UNLOCK(src);
+    g_free(labels);
+
+    if (!ret) {
+        GST_ELEMENT_WARNING(src, RESOURCE, OPEN_WRITE, ("Metrics not exported"),
+                            ("Cannot listen on 'metrics-socket' %s", src->metrics_socket));
+    }
+}
 
-    GstVideoInfo vinfo;
+/* Open the camera, or attach to the hub sharing it, and compute the output caps */
+static gboolean gst_zedsrc_open_camera(GstZedSrc *src) {
+    sl::ERROR_CODE ret;
 
-    gst_caps_get_structure(caps, 0);
+    GST_TRACE_OBJECT(src, "gst_zedsrc_calculate_caps");
 
-    GST_DEBUG_OBJECT(src, "The caps being set are %" GST_PTR_FORMAT, caps);
+    // ----> Set init parameters
+    sl::InitParameters init_params;
 
-    gst_video_info_from_caps(&vinfo, caps);
+    gst_zedsrc_select_mode(src);
+    if (!gst_zedsrc_set_init_params(src, init_params)) {
+        return FALSE;
+    }
+    // <---- Set init parameters
 
-    if (GST_VIDEO_INFO_FORMAT(&vinfo) == GST_VIDEO_FORMAT_UNKNOWN) {
-        goto unsupported_caps;
+    // ----> Open camera
+    g_free(src->input_key);
+    src->input_key = gst_zedsrc_input_key(src);
+    g_free(src->params_key);
+    src->params_key = gst_zedsrc_params_key(init_params);
+
+    src->hub_consumer.retrieve = gst_zedsrc_retrieve;
+    src->hub_consumer.user_data = src;
+    src->hub_consumer.flushing = FALSE;
+
+    gboolean hub_opener = FALSE;
+    if (src->shared_camera) {
+        src->hub = gst_zed_camera_hub_attach(src->input_key, &src->hub_consumer, &hub_opener);
     }
 
-    return TRUE;
+    if (src->hub && !hub_opener) {
+        src->zed = gst_zed_camera_hub_get_camera(src->hub);
+        GST_INFO_OBJECT(src, "Camera shared with another zedsrc, skipping initialization");
 
-unsupported_caps:
-    GST_ERROR_OBJECT(src, "Unsupported caps: %" GST_PTR_FORMAT, caps);
-    return FALSE;
-}
+        if (GST_ZEDSRC_NEEDS_DEPTH(src->stream_type) &&
+            src->zed->getInitParameters().depth_mode == sl::DEPTH_MODE::NONE) {
+            GST_ELEMENT_ERROR(src, RESOURCE, SETTINGS,
+                              ("The shared camera has been opened without depth processing"),
+                              (NULL));
+            return FALSE;
+        }
+    } else {
+        guint serial_number =
+            g_str_has_prefix(src->input_key, "sn:") ? static_cast<guint>(src->camera_sn) : 0;
+        src->zed = gst_zed_camera_registry_adopt(src->input_key, serial_number, src->params_key);
+
+        if (src->zed) {
+            GST_INFO_OBJECT(src, "Camera already opened, skipping initialization");
+        } else {
+            src->zed = std::make_shared<sl::Camera>();
+            ret = src->zed->open(init_params);
+
+            if (ret > sl::ERROR_CODE::SUCCESS) {
+                GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
+                                  ("Failed to open camera, '%s'", sl::toString(ret).c_str()),
+                                  (NULL));
+                return FALSE;
+            }
+        }
+    }
+    // <---- Open camera
 
-static gboolean gst_zedsrc_unlock(GstBaseSrc *bsrc) {
-    GstZedSrc *src = GST_ZED_SRC(bsrc);
+    src->cuda_ctx = src->zed->getCUDAContext();
 
-    GST_TRACE_OBJECT(src, "gst_zedsrc_unlock");
+    // Checked once: the CUDA errors raised while streaming are returned by the grab
+    // and retrieve calls of the ZED SDK
+    int cu_err = (int) cudaGetLastError();
+    if (cu_err > 0) {
+        GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
+                          ("Cuda ERROR trigger before ZED SDK : %d", cu_err), (NULL));
+        return FALSE;
+    }
 
-    src->stop_requested = TRUE;
+    gst_zedsrc_qos_setup(src);
 
-    return TRUE;
-}
+    if (src->hub && !hub_opener) {
+        // Camera controls and runtime parameters are the ones of the first element
+        if (!gst_zedsrc_calculate_caps(src)) {
+            return FALSE;
+        }
+        src->hub_frame_duration = gst_util_uint64_scale_int(
+            GST_SECOND, 1,
+            static_cast<gint>(src->zed->getCameraInformation().camera_configuration.fps));
+        return TRUE;
+    }
 
-static gboolean gst_zedsrc_unlock_stop(GstBaseSrc *bsrc) {
-    GstZedSrc *src = GST_ZED_SRC(bsrc);
+    // ----> Camera Controls
+    gst_zedsrc_apply_camera_controls(src);
+    // <---- Camera Controls
+
+    // ----> Runtime parameters
+    GST_TRACE_OBJECT(src, "CAMERA RUNTIME PARAMETERS");
+
+    GST_INFO(" * Depth Confidence threshold: %d", src->confidence_threshold);
+    GST_INFO(" * Depth Texture Confidence threshold: %d", src->texture_confidence_threshold);
+    GST_INFO(" * 3D Reference Frame: %s",
+             sl::toString((sl::COORDINATE_SYSTEM) src->measure3D_reference_frame).c_str());
+    GST_INFO(" * Fill Mode: %s", (src->fill_mode ? "TRUE" : "FALSE"));
+
+    ret = gst_zedsrc_apply_roi(src);
+    if (ret != sl::ERROR_CODE::SUCCESS) {
+        GST_ELEMENT_ERROR (src, RESOURCE, NOT_FOUND,
+                        ("Failed to set region of interest, '%s'", sl::toString(ret).c_str() ), (NULL));
+        return FALSE;
+    }
+    // <---- Runtime parameters
+
+    if (!gst_zedsrc_calculate_caps(src)) {
+        return FALSE;
+    }
+
+    // ----> Camera sharing
+    if (src->hub) {
+        // Started last: the grab loop starts right away
+        gst_zed_camera_hub_start(src->hub, src->zed);
+        src->hub_frame_duration = gst_util_uint64_scale_int(
+            GST_SECOND, 1,
+            static_cast<gint>(src->zed->getCameraInformation().camera_configuration.fps));
+    }
+    // <---- Camera sharing
+
+    return TRUE;
+}
+
+static gboolean gst_zedsrc_start(GstBaseSrc *bsrc) {
+#if (ZED_SDK_MAJOR_VERSION != 5)
+    GST_ELEMENT_ERROR(src, LIBRARY, FAILED,
+    ("Wrong ZED SDK version. SDK v5.0 EA or newer required "),
+                      (NULL));
+#endif
+
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+
+    if (!gst_zedsrc_open_camera(src)) {
+        // Not stopped by the base class: the elements waiting for the shared camera
+        // must be released, they open it themselves
+        gst_zedsrc_reset(src);
+        return FALSE;
+    }
+
+    // Also for the elements sharing the camera
+    gst_zedsrc_start_metrics(src);
+
+    return TRUE;
+}
+
+/* Current time of the element clock. The clock reference is kept by the element
+ * and only renewed when the pipeline selects another clock. */
+static GstClockTime gst_zedsrc_clock_time(GstZedSrc *src) {
+    GST_OBJECT_LOCK(src);
+    if (G_UNLIKELY(GST_ELEMENT_CLOCK(src) != src->clock)) {
+        gst_object_replace((GstObject **) &src->clock, (GstObject *) GST_ELEMENT_CLOCK(src));
+    }
+    GST_OBJECT_UNLOCK(src);
+
+    return src->clock ? gst_clock_get_time(src->clock) : GST_CLOCK_TIME_NONE;
+}
+
+/* Camera re-opened by the recovery thread, with the parameters of the element
+ * when the camera was lost */
+struct GstZedSrcReopen {
+    std::shared_ptr<sl::Camera> zed;
+    sl::InitParameters init_params;
+};
+
+static gboolean gst_zedsrc_reopen_camera(gpointer data, gint attempt) {
+    GstZedSrcReopen *reopen = static_cast<GstZedSrcReopen *>(data);
+
+    GST_INFO("Camera reconnection attempt #%d", attempt);
+
+    sl::ERROR_CODE ret = reopen->zed->open(reopen->init_params);
+    if (ret > sl::ERROR_CODE::SUCCESS) {
+        GST_DEBUG("Reconnection attempt #%d failed: '%s'", attempt, sl::toString(ret).c_str());
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void gst_zedsrc_close_camera(gpointer data) {
+    static_cast<GstZedSrcReopen *>(data)->zed->close();
+}
+
+static void gst_zedsrc_free_reopen(gpointer data) {
+    delete static_cast<GstZedSrcReopen *>(data);
+}
+
+static void gst_zedsrc_start_reconnection(GstZedSrc *src) {
+    GstZedSrcReopen *reopen = new GstZedSrcReopen;
+    reopen->zed = src->zed;
+    // Parameters have already been validated by `gst_zedsrc_start`
+    gst_zedsrc_set_init_params(src, reopen->init_params);
+    // A mode switch changes them: the camera is parked under the mode it is re-opened in
+    g_free(src->params_key);
+    src->params_key = gst_zedsrc_params_key(reopen->init_params);
+
+    g_mutex_lock(&src->reconnect_lock);
+    src->recovery = gst_zed_recovery_new(
+        "zedsrc-reconnect", gst_zedsrc_reopen_camera, gst_zedsrc_close_camera, reopen,
+        gst_zedsrc_free_reopen, src->reconnect_min_delay, src->reconnect_max_delay,
+        src->reconnect_max_attempts);
+    gst_zed_recovery_set_flushing(src->recovery, src->stop_requested);
+    g_mutex_unlock(&src->reconnect_lock);
+}
+
+static void gst_zedsrc_stop_reconnection(GstZedSrc *src) {
+    g_mutex_lock(&src->reconnect_lock);
+    GstZedRecovery *recovery = src->recovery;
+    src->recovery = NULL;
+    g_mutex_unlock(&src->reconnect_lock);
+
+    if (!recovery) {
+        return;
+    }
+
+    // A camera slow to open must not delay the state change by more than a few frames
+    GstClockTime timeout = 2 * gst_util_uint64_scale_int(GST_SECOND, 1, MAX(src->camera_fps, 1));
+    if (!gst_zed_recovery_free(recovery, timeout / GST_USECOND)) {
+        GST_WARNING_OBJECT(src, "Camera still opening: it is closed when the open returns");
+        src->zed.reset();
+    }
+}
+
+/* Copy the last valid frame into `buf`, output at the `ts` running time */
+static void gst_zedsrc_repeat_frame(GstZedSrc *src, GstBuffer *buf, GstClockTime ts,
+                                    GstClockTime duration) {
+    GstMapInfo last_info;
+
+    if (gst_buffer_map(src->last_buffer, &last_info, GST_MAP_READ)) {
+        gst_buffer_fill(buf, 0, last_info.data, last_info.size);
+        gst_buffer_unmap(src->last_buffer, &last_info);
+    }
+    GST_BUFFER_TIMESTAMP(buf) = ts;
+    GST_BUFFER_DTS(buf) = ts;
+    GST_BUFFER_DURATION(buf) = duration;
+}
+
+/* Called by the streaming thread while the camera is being re-opened. The
+ * pipeline is kept alive at the nominal frame rate: with the GAP policy a GAP
+ * event is pushed for each missing frame, with the REPEAT policy and during a
+ * camera mode switch the last valid frame is copied into `buf` and `*repeated`
+ * is set. Returns GST_FLOW_OK when a new frame can be grabbed or `buf` has been
+ * filled. */
+static GstFlowReturn gst_zedsrc_wait_reconnection(GstZedSrc *src, GstBuffer *buf,
+                                                  gboolean *repeated) {
+    GstClockTime frame_duration = gst_util_uint64_scale_int(GST_SECOND, 1, src->camera_fps);
+    GstPad *srcpad = GST_BASE_SRC_PAD(src);
+
+    gint attempts = 0;
+
+    *repeated = FALSE;
+
+    while (TRUE) {
+        gint64 end_time = g_get_monotonic_time() + frame_duration / GST_USECOND;
+        GstZedRecoveryResult result = gst_zed_recovery_wait(src->recovery, end_time, &attempts);
+        if (result == GST_ZED_RECOVERY_FLUSHING) {
+            return GST_FLOW_FLUSHING;
+        }
+        if (result == GST_ZED_RECOVERY_FAILED) {
+            GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
+                              ("Camera reconnection failed after %d attempts", attempts), (NULL));
+            return GST_FLOW_ERROR;
+        }
+        if (result == GST_ZED_RECOVERY_DONE) {
+            break;
+        }
+
+        // ----> Frame period elapsed without camera
+        GstClockTime clock_time = gst_zedsrc_clock_time(src);
+        GstClockTime ts = GST_CLOCK_DIFF(gst_element_get_base_time(GST_ELEMENT(src)), clock_time);
+
+        if ((src->reconnect_policy == GST_ZEDSRC_RECONNECT_REPEAT || src->mode_switching) &&
+            src->last_buffer) {
+            gst_zedsrc_repeat_frame(src, buf, ts, frame_duration);
+            *repeated = TRUE;
+            return GST_FLOW_OK;
+        }
+
+        GstEvent *segment = gst_pad_get_sticky_event(srcpad, GST_EVENT_SEGMENT, 0);
+        if (segment) {
+            gst_event_unref(segment);
+            gst_pad_push_event(srcpad, gst_event_new_gap(ts, frame_duration));
+        }
+        // <---- Frame period elapsed without camera
+    }
+
+    // The recovery thread is done: the camera is configured again from here
+    gst_zedsrc_stop_reconnection(src);
+
+    gst_zedsrc_apply_camera_controls(src);
+    sl::ERROR_CODE ret = gst_zedsrc_apply_roi(src);
+    if (ret != sl::ERROR_CODE::SUCCESS) {
+        GST_WARNING_OBJECT(src, "Failed to restore region of interest, '%s'",
+                           sl::toString(ret).c_str());
+    }
+
+    src->cuda_ctx = src->zed->getCUDAContext();
+
+    if (src->mode_switching) {
+        // Last frame of the previous mode, kept when the switch started: the new caps
+        // are negotiated before the next buffer, see `gst_zedsrc_negotiate`
+        GST_INFO_OBJECT(src, "Camera re-opened in the new mode");
+        GstClockTime ts = GST_CLOCK_DIFF(gst_element_get_base_time(GST_ELEMENT(src)),
+                                         gst_zedsrc_clock_time(src));
+        gst_zedsrc_repeat_frame(src, buf, ts, frame_duration);
+        *repeated = TRUE;
+        gst_pad_mark_reconfigure(srcpad);
+    } else {
+        GST_ELEMENT_INFO(src, RESOURCE, OPEN_READ,
+                         ("Camera reconnected after %d attempts", attempts), (NULL));
+    }
+
+    return GST_FLOW_OK;
+}
+
+/* Log the counters of the huge page allocator, shared by all the elements */
+static void gst_zedsrc_log_allocator_stats(GstZedSrc *src) {
+    GstAllocator *allocator;
+    GstZedAllocatorStats stats;
+
+    if (src->allocator != GST_ZEDSRC_ALLOCATOR_HUGEPAGE ||
+        !(allocator = gst_zed_hugepage_allocator_get())) {
+        return;
+    }
+
+    gst_zed_hugepage_allocator_get_stats(allocator, &stats);
+    gst_object_unref(allocator);
+
+    GST_INFO_OBJECT(src,
+                    "Huge page allocator: %" G_GUINT64_FORMAT " memories (%" G_GUINT64_FORMAT
+                    " with reserved huge pages), %" G_GUINT64_FORMAT " MB, %" G_GUINT64_FORMAT
+                    " page faults avoided",
+                    stats.allocations, stats.hugetlb, stats.bytes >> 20, stats.faults_avoided);
+}
+
+static gboolean gst_zedsrc_stop(GstBaseSrc *bsrc) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+
+    GST_TRACE_OBJECT(src, "gst_zedsrc_stop");
+
+    gst_zedsrc_log_allocator_stats(src);
+    gst_zedsrc_reset(src);
+
+    return TRUE;
+}
+
+/* (Re)create the pre-event ring recorder for the negotiated `caps`, NULL to free it */
+static void gst_zedsrc_setup_ring(GstZedSrc *src, GstCaps *caps) {
+    GstZedFrameRing *ring;
+
+    // Release the previous ring first: the memory is preallocated
+    GST_OBJECT_LOCK(src);
+    ring = src->ring;
+    src->ring = NULL;
+    GST_OBJECT_UNLOCK(src);
+    if (ring) {
+        gst_zed_frame_ring_free(ring);
+        ring = NULL;
+    }
+
+    if (!caps || src->ring_duration <= 0.0 || src->out_framesize == 0) {
+        return;
+    }
+
+    gint fps_n = 0, fps_d = 1;
+    gst_structure_get_fraction(gst_caps_get_structure(caps, 0), "framerate", &fps_n, &fps_d);
+
+    guint n_slots = static_cast<guint>(src->ring_duration * fps_n / fps_d + 0.5);
+    guint max_slots =
+        static_cast<guint>((static_cast<guint64>(src->ring_max_size) << 20) / src->out_framesize);
+    if (n_slots > max_slots) {
+        GST_WARNING_OBJECT(src, "Ring recorder limited to %u frames by 'ring-max-size'", max_slots);
+        n_slots = max_slots;
+    }
+    if (n_slots == 0) {
+        GST_ELEMENT_WARNING(src, RESOURCE, NO_SPACE_LEFT,
+                            ("Ring recorder disabled: no frame fits 'ring-max-size'"), (NULL));
+        return;
+    }
+
+    gchar *desc = gst_caps_to_string(caps);
+    ring = gst_zed_frame_ring_new(src->out_framesize, n_slots, desc);
+    g_free(desc);
+
+    if (!ring) {
+        GST_ELEMENT_WARNING(src, RESOURCE, NO_SPACE_LEFT,
+                            ("Failed to allocate the ring recorder (%u frames of %u bytes)",
+                             n_slots, src->out_framesize),
+                            (NULL));
+        return;
+    }
+    GST_INFO_OBJECT(src, "Ring recorder: %u frames of %u bytes", n_slots, src->out_framesize);
+
+    GST_OBJECT_LOCK(src);
+    src->ring = ring;
+    GST_OBJECT_UNLOCK(src);
+}
+
+/* Called from the ring flush thread */
+static void gst_zedsrc_ring_flushed(const gchar *location, guint frames, gboolean success,
+                                    gpointer user_data) {
+    GstZedSrc *src = GST_ZED_SRC(user_data);
+
+    if (success) {
+        GST_INFO_OBJECT(src, "%u frames written to '%s'", frames, location);
+    } else {
+        GST_ELEMENT_WARNING(src, RESOURCE, WRITE,
+                            ("Failed to write the ring recorder capture '%s'", location), (NULL));
+    }
+
+    gst_element_post_message(
+        GST_ELEMENT(src),
+        gst_message_new_element(GST_OBJECT(src),
+                                gst_structure_new("zed-capture", "location", G_TYPE_STRING,
+                                                  location, "frames", G_TYPE_UINT, frames,
+                                                  "success", G_TYPE_BOOLEAN, success, NULL)));
+}
+
+/* `trigger-capture` action signal: write the ring recorder content to a new file */
+static gboolean gst_zedsrc_trigger_capture(GstZedSrc *src) {
+    GDateTime *now = g_date_time_new_now_local();
+    gchar *stamp = g_date_time_format(now, "%Y%m%d-%H%M%S");
+    gchar *name = g_strdup_printf("zed-capture-%s-%03d.zedring", stamp,
+                                  g_date_time_get_microsecond(now) / 1000);
+    gboolean ret = FALSE;
+
+    GST_OBJECT_LOCK(src);
+    gchar *location = g_build_filename(src->ring_location, name, NULL);
+    gboolean enabled = (src->ring != NULL);
+    if (enabled) {
+        ret = gst_zed_frame_ring_flush(src->ring, location, gst_zedsrc_ring_flushed, src);
+    }
+    GST_OBJECT_UNLOCK(src);
+
+    if (ret) {
+        GST_INFO_OBJECT(src, "Writing the ring recorder to '%s'", location);
+    } else {
+        GST_WARNING_OBJECT(src, "'trigger-capture' ignored: %s",
+                           enabled ? "previous capture still running or no frame recorded"
+                                   : "ring recorder disabled");
+    }
+
+    g_free(location);
+    g_free(name);
+    g_free(stamp);
+    g_date_time_unref(now);
+
+    return ret;
+}
+
+/* Parse a comma-separated list of QoS ladder steps into `steps` (both output
+ * arguments can be NULL to only validate the list) */
+static gboolean gst_zedsrc_parse_qos_ladder(const gchar *str, guint *steps, guint *n_steps) {
+    static const struct {
+        const gchar *name;
+        GstZedSrcQosStep step;
+    } step_names[] = {
+        {"skip-depth", GST_ZEDSRC_QOS_SKIP_DEPTH},
+        {"decimate", GST_ZEDSRC_QOS_DECIMATE},
+        {"scale-half", GST_ZEDSRC_QOS_SCALE_HALF},
+    };
+    gchar **tokens = g_strsplit(str ? str : "", ",", -1);
+    gboolean valid = TRUE;
+    guint n = 0;
+
+    for (gchar **token = tokens; *token && valid; token++) {
+        const gchar *name = g_strstrip(*token);
+        guint i;
+
+        if (*name == '\0') {
+            continue;
+        }
+        for (i = 0; i < G_N_ELEMENTS(step_names); i++) {
+            if (g_str_equal(name, step_names[i].name)) {
+                break;
+            }
+        }
+        valid = (i < G_N_ELEMENTS(step_names) && n < GST_ZEDSRC_QOS_MAX_STEPS);
+        if (valid && steps) {
+            steps[n] = step_names[i].step;
+        }
+        n++;
+    }
+    g_strfreev(tokens);
+
+    if (valid && n_steps) {
+        *n_steps = n;
+    }
+    return valid;
+}
+
+/* Keep the steps of the QoS ladder that lighten the capture of the opened camera.
+ * On a shared camera the grab is driven by the camera hub: only the retrieval of
+ * this element can be degraded. */
+static void gst_zedsrc_qos_setup(GstZedSrc *src) {
+    guint steps[GST_ZEDSRC_QOS_MAX_STEPS];
+    guint n_steps = 0;
+    gboolean depth_computed = src->zed->getInitParameters().depth_mode != sl::DEPTH_MODE::NONE;
+
+    gst_zedsrc_parse_qos_ladder(src->qos_ladder, steps, &n_steps);
+
+    src->qos_n_steps = 0;
+    for (guint i = 0; i < n_steps; i++) {
+        gboolean applicable = TRUE;
+
+        if (steps[i] == GST_ZEDSRC_QOS_SKIP_DEPTH) {
+            applicable = src->shared_camera ? GST_ZEDSRC_NEEDS_DEPTH(src->stream_type)
+                                            : depth_computed;
+        } else if (steps[i] == GST_ZEDSRC_QOS_SCALE_HALF) {
+            applicable = GST_ZEDSRC_IS_COLOR(src->stream_type);
+        }
+
+        if (applicable) {
+            src->qos_steps[src->qos_n_steps++] = steps[i];
+        } else {
+            GST_INFO_OBJECT(src, "QoS ladder step #%u does not apply to the stream, skipped", i);
+        }
+    }
+
+    src->qos_level = 0;
+    src->qos_active = 0;
+    src->qos_last_change = 0;
+    src->qos_frame = 0;
+    src->qos_renegotiate = FALSE;
+    g_atomic_int_set(&src->qos_skip_measures, FALSE);
+
+    GST_OBJECT_LOCK(src);
+    src->qos_received = FALSE;
+    GST_OBJECT_UNLOCK(src);
+}
+
+static const gchar *gst_zedsrc_qos_step_name(guint step) {
+    switch (step) {
+    case GST_ZEDSRC_QOS_SKIP_DEPTH:
+        return "skip-depth";
+    case GST_ZEDSRC_QOS_DECIMATE:
+        return "decimate";
+    case GST_ZEDSRC_QOS_SCALE_HALF:
+        return "scale-half";
+    default:
+        return "unknown";
+    }
+}
+
+/* Move one step along the QoS ladder according to the last QoS event received:
+ * down when downstream is late, back up once it keeps up again. Transitions are
+ * separated by a hold time letting the downstream measurement settle, and each of
+ * them is posted on the bus as a `zed-qos` element message. */
+static void gst_zedsrc_qos_update(GstZedSrc *src) {
+    GST_OBJECT_LOCK(src);
+    gboolean enabled = src->qos;
+    gboolean received = src->qos_received;
+    gdouble proportion = src->qos_proportion;
+    GstClockTimeDiff jitter = src->qos_jitter;
+    GST_OBJECT_UNLOCK(src);
+
+    gint64 elapsed = g_get_monotonic_time() - src->qos_last_change;
+    guint level = src->qos_level;
+
+    if (!enabled) {
+        if (level == 0) {
+            return;
+        }
+        level--;   // Disabled while degraded: back to full quality, one step per frame
+    } else if (!received) {
+        return;
+    } else if (proportion > GST_ZEDSRC_QOS_DEGRADE_PROPORTION && level < src->qos_n_steps &&
+               elapsed >= GST_ZEDSRC_QOS_DEGRADE_HOLD) {
+        level++;
+    } else if (proportion < GST_ZEDSRC_QOS_RECOVER_PROPORTION && jitter <= 0 && level > 0 &&
+               elapsed >= GST_ZEDSRC_QOS_RECOVER_HOLD) {
+        level--;
+    } else {
+        return;
+    }
+
+    gboolean degraded = (level > src->qos_level);
+    guint step = src->qos_steps[degraded ? level - 1 : level];
+    guint active = 0;
+
+    for (guint i = 0; i < level; i++) {
+        active |= src->qos_steps[i];
+    }
+    gboolean renegotiate =
+        ((active ^ src->qos_active) & (GST_ZEDSRC_QOS_DECIMATE | GST_ZEDSRC_QOS_SCALE_HALF)) != 0;
+
+    src->qos_level = level;
+    src->qos_active = active;
+    src->qos_last_change = g_get_monotonic_time();
+
+    // Wait for QoS events measuring the new level
+    GST_OBJECT_LOCK(src);
+    src->qos_received = FALSE;
+    GST_OBJECT_UNLOCK(src);
+
+    GST_INFO_OBJECT(src, "QoS level %u: '%s' %s (proportion %.3f, jitter %" G_GINT64_FORMAT ")",
+                    level, gst_zedsrc_qos_step_name(step), degraded ? "applied" : "removed",
+                    proportion, jitter);
+
+    if (renegotiate) {
+        src->qos_renegotiate = TRUE;   // The buffer being filled keeps the negotiated caps
+    }
+
+    gst_element_post_message(
+        GST_ELEMENT(src),
+        gst_message_new_element(
+            GST_OBJECT(src),
+            gst_structure_new("zed-qos", "level", G_TYPE_UINT, level, "step", G_TYPE_STRING,
+                              gst_zedsrc_qos_step_name(step), "degraded", G_TYPE_BOOLEAN,
+                              degraded, "proportion", G_TYPE_DOUBLE, proportion, "jitter",
+                              G_TYPE_INT64, jitter, NULL)));
+}
+
+static gboolean gst_zedsrc_event(GstBaseSrc *bsrc, GstEvent *event) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+
+    if (GST_EVENT_TYPE(event) == GST_EVENT_QOS) {
+        GstQOSType type;
+        gdouble proportion;
+        GstClockTimeDiff diff;
+        GstClockTime timestamp;
+
+        gst_event_parse_qos(event, &type, &proportion, &diff, &timestamp);
+        GST_LOG_OBJECT(src, "QoS event: proportion %.3f, jitter %" G_GINT64_FORMAT, proportion,
+                       diff);
+
+        // Throttling requests come from the application, not from a late downstream
+        if (type != GST_QOS_TYPE_THROTTLE) {
+            GST_OBJECT_LOCK(src);
+            src->qos_proportion = proportion;
+            src->qos_jitter = diff;
+            src->qos_received = TRUE;
+            GST_OBJECT_UNLOCK(src);
+        }
+        return TRUE;
+    }
+
+    return GST_BASE_SRC_CLASS(gst_zedsrc_parent_class)->event(bsrc, event);
+}
+
+static GstCaps *gst_zedsrc_get_caps(GstBaseSrc *bsrc, GstCaps *filter) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+    GstCaps *caps;
+
+    const GstZedCameraMode *modes = NULL;
+    guint n_modes;
+
+    if (src->caps) {
+        caps = gst_zedsrc_streaming_caps(src);
+    } else if ((n_modes = gst_zedsrc_probe_modes(src, &modes)) > 0) {
+        // Not started: modes of the connected camera
+        caps = gst_zedsrc_probe_caps(src, modes, n_modes);
+    } else {
+        caps = gst_pad_get_pad_template_caps(GST_BASE_SRC_PAD(src));
+    }
+
+    if (src->allocator == GST_ZEDSRC_ALLOCATOR_DMABUF && caps) {
+        GstAllocator *udmabuf = gst_zed_udmabuf_allocator_get();
+
+        // Only offered when the frames can actually be DMABufs
+        if (udmabuf) {
+            gst_object_unref(udmabuf);
+            caps = gst_zed_caps_add_dmabuf(caps);
+        }
+    }
+
+    GST_DEBUG_OBJECT(src, "The caps before filtering are %" GST_PTR_FORMAT, caps);
+
+    if (filter && caps) {
+        GstCaps *tmp = gst_caps_intersect(caps, filter);
+        gst_caps_unref(caps);
+        caps = tmp;
+    }
+
+    GST_DEBUG_OBJECT(src, "The caps after filtering are %" GST_PTR_FORMAT, caps);
+
+    return caps;
+}
+
+static gboolean gst_zedsrc_set_caps(GstBaseSrc *bsrc, GstCaps *caps) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+    GST_TRACE_OBJECT(src, "gst_zedsrc_set_caps");
+
+    GstVideoInfo vinfo;
+
+    gst_caps_get_structure(caps, 0);
+
+    GST_DEBUG_OBJECT(src, "The caps being set are %" GST_PTR_FORMAT, caps);
+
+    GST_OBJECT_LOCK(src);
+    src->mode_update = FALSE;
+    GST_OBJECT_UNLOCK(src);
+
+    // The memory features are not part of the camera mode. The camera mode is
+    // switched before its caps are set, see `gst_zedsrc_negotiate`
+    if (src->caps && !gst_zed_caps_can_intersect_any_memory(caps, src->caps)) {
+        goto unsupported_caps;
+    }
+
+    if (gst_structure_has_name(gst_caps_get_structure(caps, 0), "application/x-zed-pointcloud") ||
+        gst_structure_has_name(gst_caps_get_structure(caps, 0), "application/x-zed-disparity")) {
+        gst_zedsrc_setup_ring(src, caps);
+        return TRUE;
+    }
+
+    gst_video_info_from_caps(&vinfo, caps);
+
+    if (GST_VIDEO_INFO_FORMAT(&vinfo) == GST_VIDEO_FORMAT_UNKNOWN) {
+        goto unsupported_caps;
+    }
+
+    src->out_format = GST_VIDEO_INFO_FORMAT(&vinfo);
+    src->out_framesize = (guint) GST_VIDEO_INFO_SIZE(&vinfo);
+    src->out_stride = (guint) GST_VIDEO_INFO_PLANE_STRIDE(&vinfo, 0);
+    src->out_width = (guint) GST_VIDEO_INFO_WIDTH(&vinfo);
+    src->out_height = (guint) GST_VIDEO_INFO_HEIGHT(&vinfo);
+    src->out_scale = src->caps_scale;
+    gst_base_src_set_blocksize(bsrc, src->out_framesize);
+    gst_zedsrc_setup_ring(src, caps);
+
+    return TRUE;
+
+unsupported_caps:
+    GST_ERROR_OBJECT(src, "Unsupported caps: %" GST_PTR_FORMAT, caps);
+    return FALSE;
+}
+
+/* Negotiation before a buffer. When downstream prefers another camera mode the
+ * current caps are kept while the camera is re-opened in this mode, the caps of
+ * the new mode being negotiated once it streams. */
+static gboolean gst_zedsrc_negotiate(GstBaseSrc *bsrc) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+
+    GST_TRACE_OBJECT(src, "gst_zedsrc_negotiate");
+
+    if (src->mode_switching) {
+        if (src->recovery) {
+            return TRUE;   // Negotiated again once the camera is re-opened
+        }
+        gst_zedsrc_end_mode_switch(src);
+    } else if (src->is_started && !src->recovery && gst_zedsrc_request_mode_switch(src)) {
+        return TRUE;
+    }
+
+    return GST_BASE_SRC_CLASS(gst_zedsrc_parent_class)->negotiate(bsrc);
+}
+
+/* Allocator of the 'allocator' property, NULL if not supported. The udmabuf one
+ * falls back to memfd: both pass the frames by file descriptor. */
+static GstAllocator *gst_zedsrc_frame_allocator(GstZedSrc *src) {
+    GstAllocator *allocator = NULL;
+
+    switch (src->allocator) {
+    case GST_ZEDSRC_ALLOCATOR_HUGEPAGE:
+        allocator = gst_zed_hugepage_allocator_get();
+        break;
+    case GST_ZEDSRC_ALLOCATOR_DMABUF:
+        allocator = gst_zed_udmabuf_allocator_get();
+        if (allocator) {
+            break;
+        }
+        GST_WARNING_OBJECT(src, "/dev/udmabuf not available, using memfd memories");
+        // fallthrough
+    case GST_ZEDSRC_ALLOCATOR_MEMFD:
+        allocator = gst_zed_memfd_allocator_get();
+        break;
+    default:
+        break;
+    }
+
+    return allocator;
+}
+
+/* Allocation of the output frames: at least 64 bytes aligned for the SIMD kernels
+ * downstream. With another allocator than the default one, the downstream pool is
+ * replaced by a pool of the base class recycling the memories of that allocator. */
+static gboolean gst_zedsrc_decide_allocation(GstBaseSrc *bsrc, GstQuery *query) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+    GstAllocator *allocator = NULL;
+    GstAllocationParams params;
+
+    if (gst_query_get_n_allocation_params(query) > 0) {
+        gst_query_parse_nth_allocation_param(query, 0, &allocator, &params);
+    } else {
+        gst_allocation_params_init(&params);
+    }
+    params.align |= GST_ZED_ALLOCATOR_ALIGN;
+
+    if (src->allocator != GST_ZEDSRC_ALLOCATOR_DEFAULT) {
+        GstAllocator *frames = gst_zedsrc_frame_allocator(src);
+
+        if (frames) {
+            gst_object_replace((GstObject **) &allocator, GST_OBJECT_CAST(frames));
+            gst_object_unref(frames);
+
+            guint size = src->out_framesize, min = 0, max = 0;
+            if (gst_query_get_n_allocation_pools(query) > 0) {
+                GstBufferPool *pool = NULL;
+                gst_query_parse_nth_allocation_pool(query, 0, &pool, &size, &min, &max);
+                if (pool) {
+                    gst_object_unref(pool);
+                }
+                size = MAX(size, src->out_framesize);
+                gst_query_set_nth_allocation_pool(query, 0, NULL, size, min, max);
+            } else {
+                // Without a pool each frame would be mapped again
+                gst_query_add_allocation_pool(query, NULL, size, min, max);
+            }
+        } else {
+            GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS,
+                                ("Frame allocator not supported, using the default allocator"),
+                                (NULL));
+        }
+    }
+
+    if (gst_query_get_n_allocation_params(query) > 0) {
+        gst_query_set_nth_allocation_param(query, 0, allocator, &params);
+    } else {
+        gst_query_add_allocation_param(query, allocator, &params);
+    }
+    if (allocator) {
+        gst_object_unref(allocator);
+    }
+
+    return GST_BASE_SRC_CLASS(gst_zedsrc_parent_class)->decide_allocation(bsrc, query);
+}
+
+static gboolean gst_zedsrc_unlock(GstBaseSrc *bsrc) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
+
+    GST_TRACE_OBJECT(src, "gst_zedsrc_unlock");
+
+    g_mutex_lock(&src->reconnect_lock);
+    src->stop_requested = TRUE;
+    if (src->recovery) {
+        gst_zed_recovery_set_flushing(src->recovery, TRUE);
+    }
+    g_mutex_unlock(&src->reconnect_lock);
+
+    if (src->hub) {
+        gst_zed_camera_hub_set_flushing(src->hub, &src->hub_consumer, TRUE);
+    }
+    if (src->grab_worker) {
+        gst_zed_grab_worker_set_flushing(src->grab_worker, TRUE);
+    }
+
+    return TRUE;
+}
+
+static gboolean gst_zedsrc_unlock_stop(GstBaseSrc *bsrc) {
+    GstZedSrc *src = GST_ZED_SRC(bsrc);
 
     GST_TRACE_OBJECT(src, "gst_zedsrc_unlock_stop");
 
+    g_mutex_lock(&src->reconnect_lock);
     src->stop_requested = FALSE;
+    if (src->recovery) {
+        gst_zed_recovery_set_flushing(src->recovery, FALSE);
+    }
+    g_mutex_unlock(&src->reconnect_lock);
+
+    if (src->hub) {
+        gst_zed_camera_hub_set_flushing(src->hub, &src->hub_consumer, FALSE);
+    }
+    if (src->grab_worker) {
+        gst_zed_grab_worker_set_flushing(src->grab_worker, FALSE);
+    }
 
     return TRUE;
 }
 
-static GstFlowReturn gst_zedsrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
-    GstZedSrc *src = GST_ZED_SRC(psrc);
+/* Copy the `rect` area of `mat` row by row into `dst`, whose rows are `dst_stride`
+ * bytes apart, skipping the Mat padding and the pixels out of the crop */
+static void gst_zedsrc_copy_rect(guint8 *dst, gsize dst_stride, sl::Mat &mat,
+                                 const sl::Rect &rect) {
+    gsize pixel_bytes = mat.getPixelBytes();
+    gsize src_stride = mat.getStepBytes(sl::MEM::CPU);
+    gsize row_bytes = rect.width * pixel_bytes;
+    const guint8 *src_row =
+        mat.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * src_stride + rect.x * pixel_bytes;
+
+    for (size_t v = 0; v < rect.height; v++) {
+        memcpy(dst, src_row, row_bytes);
+        dst += dst_stride;
+        src_row += src_stride;
+    }
+}
 
-    GST_TRACE_OBJECT(src, "gst_zedsrc_fill");
+/* Copy the `rect` area of the retrieved color image into the `dst_w`x`dst_h` area of
+ * `dst`, scaling it and converting it to the negotiated output format in one pass. The
+ * statistics of the written pixels are added to `stats` when not NULL */
+static void gst_zedsrc_copy_image(GstZedSrc *src, guint8 *dst, sl::Mat &mat, const sl::Rect &rect,
+                                  guint dst_w, guint dst_h, GstZedImageStatsAccumulator *stats) {
+    gsize in_stride = mat.getStepBytes(sl::MEM::CPU);
+    const guint8 *in = mat.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * in_stride +
+                       rect.x * mat.getPixelBytes();
+    GstZedConvertFunc convert = NULL;
+
+    switch (src->out_format) {
+    case GST_VIDEO_FORMAT_BGR:
+        convert = gst_zed_convert_bgra_to_bgr;
+        break;
+    case GST_VIDEO_FORMAT_RGB:
+        convert = gst_zed_convert_bgra_to_rgb;
+        break;
+    case GST_VIDEO_FORMAT_GRAY8:
+        if (mat.getChannels() == 4) {   // Single views are retrieved in gray from the SDK
+            convert = gst_zed_convert_bgra_to_gray8;
+        }
+        break;
+    default:
+        break;
+    }
+
+    gst_zed_copy_engine_copy_image(src->copy_engine, in, in_stride, rect.width, rect.height,
+                                   mat.getPixelBytes(), dst, src->out_stride, dst_w, dst_h,
+                                   convert, stats);
+}
+
+/* Layout of the output pixels, for the image statistics */
+static GstZedPixelLayout gst_zedsrc_pixel_layout(GstZedSrc *src) {
+    switch (src->out_format) {
+    case GST_VIDEO_FORMAT_BGR:
+        return GST_ZED_PIXEL_BGR;
+    case GST_VIDEO_FORMAT_RGB:
+        return GST_ZED_PIXEL_RGB;
+    case GST_VIDEO_FORMAT_GRAY8:
+        return GST_ZED_PIXEL_GRAY8;
+    default:
+        return GST_ZED_PIXEL_BGRA;
+    }
+}
+
+/* Pack the points of the `rect` area of the F32_C4 `cloud` into `dst`, keeping one
+ * point every `stride` along rows and columns. With `xyz` the fourth channel
+ * (packed color) is dropped. */
+static void gst_zedsrc_copy_pointcloud(guint8 *dst, sl::Mat &cloud, const sl::Rect &rect,
+                                       gint stride, gboolean xyz) {
+    gsize src_stride = cloud.getStepBytes(sl::MEM::CPU);
+    const guint8 *src_row = cloud.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * src_stride +
+                            rect.x * cloud.getPixelBytes();
+
+    if (stride == 1 && !xyz) {
+        gst_zedsrc_copy_rect(dst, rect.width * cloud.getPixelBytes(), cloud, rect);
+        return;
+    }
+
+    gst_zed_convert_points(src_row, src_stride, dst, rect.width, rect.height, stride, xyz);
+}
+
+/* Convert the `rect` area of the F32 confidence measure [0-100] to GRAY8 [0-255] */
+static void gst_zedsrc_copy_confidence(guint8 *dst, gsize dst_stride, sl::Mat &conf,
+                                       const sl::Rect &rect) {
+    gsize conf_stride = conf.getStepBytes(sl::MEM::CPU);
+    const guint8 *conf_row =
+        conf.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * conf_stride + rect.x * sizeof(float);
+
+    gst_zed_convert_confidence_to_gray8(conf_row, conf_stride, dst, dst_stride, rect.width,
+                                        rect.height);
+}
 
+/* Convert the `rect` area of the F32 disparity measure to unsigned fixed point
+ * GRAY16, invalid disparities are set to 0 */
+static void gst_zedsrc_copy_disparity16(guint8 *dst, gsize dst_stride, sl::Mat &disp,
+                                        const sl::Rect &rect) {
+    gsize disp_stride = disp.getStepBytes(sl::MEM::CPU);
+    const guint8 *disp_row =
+        disp.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * disp_stride + rect.x * sizeof(float);
+
+    gst_zed_convert_disparity_to_gray16(disp_row, disp_stride, dst, dst_stride, rect.width,
+                                        rect.height, DISPARITY_16_SCALE);
+}
+
+/* Copy the `rect` area of the U16 depth map, setting to 0 the pixels whose
+ * confidence value is above `threshold` (less reliable) in the same pass */
+static void gst_zedsrc_copy_masked_depth(guint8 *dst, gsize dst_stride, sl::Mat &depth,
+                                         sl::Mat &conf, const sl::Rect &rect, gint threshold) {
+    gsize depth_stride = depth.getStepBytes(sl::MEM::CPU);
+    gsize conf_stride = conf.getStepBytes(sl::MEM::CPU);
+    const guint8 *depth_row = depth.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * depth_stride +
+                              rect.x * sizeof(guint16);
+    const guint8 *conf_row =
+        conf.getPtr<sl::uchar1>(sl::MEM::CPU) + rect.y * conf_stride + rect.x * sizeof(float);
+
+    gst_zed_mask_depth_gray16(depth_row, depth_stride, conf_row, conf_stride, dst, dst_stride,
+                              rect.width, rect.height, static_cast<float>(threshold));
+}
+
+/* Measure copies split in row slices by the copy engine */
+typedef enum {
+    GST_ZEDSRC_COPY_RECT,
+    GST_ZEDSRC_COPY_POINTCLOUD,
+    GST_ZEDSRC_COPY_POINTCLOUD_XYZ,
+    GST_ZEDSRC_COPY_CONFIDENCE,
+    GST_ZEDSRC_COPY_DISPARITY16,
+    GST_ZEDSRC_COPY_MASKED_DEPTH
+} GstZedSrcCopyKind;
+
+typedef struct {
+    GstZedSrcCopyKind kind;
+    guint8 *dst;
+    gsize dst_stride;   // Output row size [bytes]
+    sl::Mat *mat;
+    sl::Mat *conf;      // Confidence map of the masked depth
+    sl::Rect rect;
+    gint arg;           // Point cloud stride or confidence threshold
+} GstZedSrcCopyJob;
+
+static void gst_zedsrc_copy_slice(gpointer data, guint first_row, guint n_rows) {
+    const GstZedSrcCopyJob *job = static_cast<const GstZedSrcCopyJob *>(data);
+    guint8 *dst = job->dst + first_row * job->dst_stride;
+    sl::Rect rect = job->rect;
+
+    if (job->kind == GST_ZEDSRC_COPY_POINTCLOUD || job->kind == GST_ZEDSRC_COPY_POINTCLOUD_XYZ) {
+        // One output row every `arg` input rows
+        rect.y += first_row * job->arg;
+        rect.height = MIN(n_rows * job->arg, job->rect.height - first_row * job->arg);
+    } else {
+        rect.y += first_row;
+        rect.height = n_rows;
+    }
+
+    switch (job->kind) {
+    case GST_ZEDSRC_COPY_RECT:
+        gst_zedsrc_copy_rect(dst, job->dst_stride, *job->mat, rect);
+        break;
+    case GST_ZEDSRC_COPY_POINTCLOUD:
+    case GST_ZEDSRC_COPY_POINTCLOUD_XYZ:
+        gst_zedsrc_copy_pointcloud(dst, *job->mat, rect, job->arg,
+                                   job->kind == GST_ZEDSRC_COPY_POINTCLOUD_XYZ);
+        break;
+    case GST_ZEDSRC_COPY_CONFIDENCE:
+        gst_zedsrc_copy_confidence(dst, job->dst_stride, *job->mat, rect);
+        break;
+    case GST_ZEDSRC_COPY_DISPARITY16:
+        gst_zedsrc_copy_disparity16(dst, job->dst_stride, *job->mat, rect);
+        break;
+    case GST_ZEDSRC_COPY_MASKED_DEPTH:
+        gst_zedsrc_copy_masked_depth(dst, job->dst_stride, *job->mat, *job->conf, rect, job->arg);
+        break;
+    }
+}
+
+/* Copy the `rect` area of the measure `mat` into `dst` with the copy engine. Point
+ * clouds are packed, `dst_stride` being ignored; `arg` is the point cloud stride or
+ * the confidence threshold of the masked depth. */
+static void gst_zedsrc_copy_measure(GstZedSrc *src, GstZedSrcCopyKind kind, guint8 *dst,
+                                    gsize dst_stride, sl::Mat &mat, sl::Mat *conf,
+                                    const sl::Rect &rect, gint arg) {
+    GstZedSrcCopyJob job = {kind, dst, dst_stride, &mat, conf, rect, arg};
+    guint n_rows = rect.height;
+
+    if (kind == GST_ZEDSRC_COPY_POINTCLOUD || kind == GST_ZEDSRC_COPY_POINTCLOUD_XYZ) {
+        guint point_bytes = (kind == GST_ZEDSRC_COPY_POINTCLOUD_XYZ ? 3 : 4) * sizeof(float);
+        n_rows = (rect.height + arg - 1) / arg;
+        job.dst_stride = ((rect.width + arg - 1) / arg) * point_bytes;
+    }
+
+    gst_zed_copy_engine_run(src->copy_engine, n_rows, gst_zedsrc_copy_slice, &job);
+}
+
+/* Number of camera frames to drop before the next output frame, following the
+ * `output-framerate` accumulator. The QoS decimation drops every other output frame. */
+static guint gst_zedsrc_frames_to_drop(GstZedSrc *src) {
+    guint n_dropped = 0;
+
+    if (src->decimate_n > 0) {
+        while (src->decimate_acc + src->decimate_n < src->decimate_d) {
+            src->decimate_acc += src->decimate_n;
+            n_dropped++;
+        }
+        src->decimate_acc = src->decimate_acc + src->decimate_n - src->decimate_d;
+    }
+
+    if (src->qos_active & GST_ZEDSRC_QOS_DECIMATE) {
+        n_dropped = 2 * n_dropped + 1;
+    }
+
+    return n_dropped;
+}
+
+/* State of the grab worker thread, reference counted: when the element stops with
+ * the grab blocked, the worker keeps it, and the camera, until the grab returns */
+struct GstZedSrcGrab {
+    std::shared_ptr<sl::Camera> zed;
+    gint enable_depth;   // Depth computed by the next grab [atomic]
+
+    GMutex lock;
+    std::shared_ptr<sl::Mat> roi_mask;   // Set before the next grab, under the lock
+    sl::ERROR_CODE roi_ret;              // Result of the last mask set, under the lock
+
+    explicit GstZedSrcGrab(const std::shared_ptr<sl::Camera> &camera)
+        : zed(camera), enable_depth(TRUE), roi_ret(sl::ERROR_CODE::SUCCESS) {
+        g_mutex_init(&lock);
+    }
+    ~GstZedSrcGrab() { g_mutex_clear(&lock); }
+};
+
+/* Grab function of the worker thread, only using its state: the element may be
+ * stopped while the grab is blocked. */
+static gint gst_zedsrc_grab_frame(gpointer user_data) {
+    GstZedSrcGrab *grab = static_cast<std::shared_ptr<GstZedSrcGrab> *>(user_data)->get();
+    sl::RuntimeParameters rt_params;
     sl::ERROR_CODE ret;
-    GstMapInfo minfo;
-    GstClock *clock;
-    GstClockTime clock_time;
 
-    static int temp_ugly_buf_index = 0;
+    rt_params.enable_depth = g_atomic_int_get(&grab->enable_depth);
 
-    if (!src->is_started) {
-        src->acq_start_time = gst_clock_get_time(gst_element_get_clock(GST_ELEMENT(src)));
+    cuCtxPushCurrent_v2(grab->zed->getCUDAContext());
 
-        src->is_started = TRUE;
+    // ----> Region of interest update
+    g_mutex_lock(&grab->lock);
+    std::shared_ptr<sl::Mat> roi_mask = std::move(grab->roi_mask);
+    g_mutex_unlock(&grab->lock);
+
+    if (roi_mask) {
+        ret = grab->zed->setRegionOfInterest(*roi_mask);
+        g_mutex_lock(&grab->lock);
+        grab->roi_ret = ret;
+        g_mutex_unlock(&grab->lock);
     }
+    // <---- Region of interest update
 
+    ret = grab->zed->grab(rt_params);
+    cuCtxPopCurrent_v2(NULL);
 
-    CUcontext zctx = src->zed.getCUDAContext();
+    return static_cast<gint>(ret);
+}
 
-    /// Push zed cuda context as current
-    int cu_err = (int)cudaGetLastError();
-    if (cu_err>0)
-    GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
-                      ("Cuda ERROR trigger before ZED SDK : %d",cu_err),
-                      (NULL));
+/* Grab a frame on the worker thread, FALSE if the wait is interrupted by a flush */
+static gboolean gst_zedsrc_wait_grab(GstZedSrc *src, gboolean enable_depth, sl::ERROR_CODE *ret) {
+    GstZedSrcGrab *grab = src->grab_ctx.get();
+    gint code;
+
+    g_atomic_int_set(&grab->enable_depth, enable_depth);
+
+    // ----> Region of interest update
+    // Set by the worker before its next grab, not to set it while grabbing
+    if (src->roi_updated) {
+        std::shared_ptr<sl::Mat> mask = gst_zedsrc_build_roi(src);
+        if (mask) {
+            g_mutex_lock(&grab->lock);
+            grab->roi_mask = mask;
+            g_mutex_unlock(&grab->lock);
+        }
+    }
+    // <---- Region of interest update
+
+    if (gst_zed_grab_worker_grab(src->grab_worker, &code) == GST_ZED_GRAB_FLUSHING) {
+        return FALSE;
+    }
+    *ret = static_cast<sl::ERROR_CODE>(code);
 
-    cuCtxPushCurrent_v2(zctx);
+    g_mutex_lock(&grab->lock);
+    sl::ERROR_CODE roi_ret = grab->roi_ret;
+    grab->roi_ret = sl::ERROR_CODE::SUCCESS;
+    g_mutex_unlock(&grab->lock);
+
+    if (roi_ret != sl::ERROR_CODE::SUCCESS) {
+        GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS,
+                            ("Failed to update region of interest, '%s'",
+                             sl::toString(roi_ret).c_str()),
+                            (NULL));
+    }
+
+    return TRUE;
+}
+
+/* Grab a new frame from the camera opened by the element and retrieve its views,
+ * unless `retrieve` is FALSE. The camera recovery is handled here: with the REPEAT
+ * policy `buf` may be filled with the last valid frame, in this case `*repeated`
+ * is set. */
+static GstFlowReturn gst_zedsrc_grab(GstZedSrc *src, GstBuffer *buf, GstClockTime *clock_time,
+                                     gboolean *repeated, gboolean enable_depth,
+                                     gboolean retrieve) {
+    sl::ERROR_CODE ret;
+
+    *repeated = FALSE;
+
+    // ----> Camera recovery
+    if (src->recovery) {
+        GstFlowReturn flow = gst_zedsrc_wait_reconnection(src, buf, repeated);
+        if (flow != GST_FLOW_OK || *repeated) {
+            return flow;
+        }
+    }
+    // <---- Camera recovery
 
     // ----> ZED grab
-    ret = src->zed.grab();
+    if (!gst_zedsrc_wait_grab(src, enable_depth, &ret)) {
+        return GST_FLOW_FLUSHING;
+    }
 
     if (ret > sl::ERROR_CODE::SUCCESS) {
+        if (src->reconnect_policy == GST_ZEDSRC_RECONNECT_NONE || src->svo_file.len != 0) {
+            GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
+                              ("Grabbing failed with error: '%s' - %s", sl::toString(ret).c_str(),
+                               sl::toVerbose(ret).c_str()),
+                              (NULL));
+            return GST_FLOW_ERROR;
+        }
+
+        GST_ELEMENT_WARNING(src, RESOURCE, READ,
+                            ("Camera lost with error: '%s' - %s. Reconnecting...",
+                             sl::toString(ret).c_str(), sl::toVerbose(ret).c_str()),
+                            (NULL));
+        gst_zed_counter_add(src->metrics.reconnects, 1);
+        gst_zedsrc_start_reconnection(src);
+
+        GstFlowReturn flow = gst_zedsrc_wait_reconnection(src, buf, repeated);
+        if (flow != GST_FLOW_OK || *repeated) {
+            return flow;
+        }
+
+        // Camera is back: grab the first new frame
+        if (!gst_zedsrc_wait_grab(src, enable_depth, &ret)) {
+            return GST_FLOW_FLUSHING;
+        }
+        if (ret > sl::ERROR_CODE::SUCCESS) {
+            GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
+                              ("Grabbing failed after reconnection: '%s' - %s",
+                               sl::toString(ret).c_str(), sl::toVerbose(ret).c_str()),
+                              (NULL));
+            return GST_FLOW_ERROR;
+        }
+    }
+    // <---- ZED grab
+
+    // ----> Clock update
+    *clock_time = gst_zedsrc_clock_time(src);
+    // <---- Clock update
+
+    // ----> Mats retrieving
+    if (!retrieve) {
+        return GST_FLOW_OK;
+    }
+
+    cuCtxPushCurrent_v2(src->cuda_ctx);
+    ret = gst_zedsrc_retrieve(*src->zed, src);
+    cuCtxPopCurrent_v2(NULL);
+
+    if (ret != sl::ERROR_CODE::SUCCESS) {
         GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
                           ("Grabbing failed with error: '%s' - %s", sl::toString(ret).c_str(),
                            sl::toVerbose(ret).c_str()),
                           (NULL));
-        cuCtxPopCurrent_v2(NULL);
         return GST_FLOW_ERROR;
     }
-    // <---- ZED grab
+    // <---- Mats retrieving
+
+    return GST_FLOW_OK;
+}
+
+/* Wait for the next frame grabbed by the camera hub, its views are retrieved by
+ * the hub grab thread. While the shared camera fails to grab, the pipeline is
+ * kept alive at the nominal frame rate according to the recovery policy, as in
+ * `gst_zedsrc_wait_reconnection`. */
+static GstFlowReturn gst_zedsrc_wait_hub_frame(GstZedSrc *src, GstBuffer *buf,
+                                               GstClockTime *clock_time, gboolean *repeated) {
+    GstPad *srcpad = GST_BASE_SRC_PAD(src);
+
+    *repeated = FALSE;
+
+    if (src->roi_updated) {
+        src->roi_updated = FALSE;
+        GST_WARNING_OBJECT(src, "Region of interest cannot be changed on a shared camera");
+    }
+
+    gint64 end_time = g_get_monotonic_time() + src->hub_frame_duration / GST_USECOND;
+    for (;;) {
+        GstZedHubWaitResult res =
+            gst_zed_camera_hub_wait_frame(src->hub, &src->hub_consumer, end_time);
+
+        if (res == GST_ZED_HUB_FLUSHING) {
+            return GST_FLOW_FLUSHING;
+        }
+
+        if (res == GST_ZED_HUB_FRAME) {
+            sl::ERROR_CODE ret = src->hub_consumer.ret;
+
+            if (ret == sl::ERROR_CODE::SUCCESS) {
+                if (src->hub_camera_lost) {
+                    src->hub_camera_lost = FALSE;
+                    GST_ELEMENT_INFO(src, RESOURCE, OPEN_READ, ("Shared camera grabbing again"),
+                                     (NULL));
+                }
+                break;
+            }
+
+            if (src->reconnect_policy == GST_ZEDSRC_RECONNECT_NONE || src->svo_file.len != 0) {
+                GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
+                                  ("Grabbing failed with error: '%s' - %s",
+                                   sl::toString(ret).c_str(), sl::toVerbose(ret).c_str()),
+                                  (NULL));
+                return GST_FLOW_ERROR;
+            }
+
+            if (!src->hub_camera_lost) {
+                src->hub_camera_lost = TRUE;
+                gst_zed_counter_add(src->metrics.reconnects, 1);
+                GST_ELEMENT_WARNING(src, RESOURCE, READ,
+                                    ("Shared camera lost with error: '%s' - %s",
+                                     sl::toString(ret).c_str(), sl::toVerbose(ret).c_str()),
+                                    (NULL));
+            }
+            continue;   // Wait until the end of the frame period
+        }
+
+        // ----> Frame period elapsed without frame
+        end_time += src->hub_frame_duration / GST_USECOND;
+        if (!src->hub_camera_lost) {
+            continue;   // Slow camera, not a failure
+        }
+
+        GstClockTime now = gst_zedsrc_clock_time(src);
+        GstClockTime ts = GST_CLOCK_DIFF(gst_element_get_base_time(GST_ELEMENT(src)), now);
+
+        if (src->reconnect_policy == GST_ZEDSRC_RECONNECT_REPEAT && src->last_buffer) {
+            GstMapInfo last_info;
+            if (gst_buffer_map(src->last_buffer, &last_info, GST_MAP_READ)) {
+                gst_buffer_fill(buf, 0, last_info.data, last_info.size);
+                gst_buffer_unmap(src->last_buffer, &last_info);
+            }
+            GST_BUFFER_TIMESTAMP(buf) = ts;
+            GST_BUFFER_DTS(buf) = ts;
+            GST_BUFFER_DURATION(buf) = src->hub_frame_duration;
+            *repeated = TRUE;
+            return GST_FLOW_OK;
+        }
+
+        GstEvent *segment = gst_pad_get_sticky_event(srcpad, GST_EVENT_SEGMENT, 0);
+        if (segment) {
+            gst_event_unref(segment);
+            gst_pad_push_event(srcpad, gst_event_new_gap(ts, src->hub_frame_duration));
+        }
+        // <---- Frame period elapsed without frame
+    }
 
     // ----> Clock update
-    clock = gst_element_get_clock(GST_ELEMENT(src));
-    clock_time = gst_clock_get_time(clock);
-    gst_object_unref(clock);
+    *clock_time = gst_zedsrc_clock_time(src);
     // <---- Clock update
 
+    return GST_FLOW_OK;
+}
+
+/* Apply the real-time settings to the streaming thread, called from its first frame */
+static void gst_zedsrc_setup_thread(GstZedSrc *src) {
+    if (!gst_zed_thread_setup(src->thread_priority, src->cpu_affinity, &src->thread_status)) {
+        GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS,
+                            ("Capture thread scheduling not applied"),
+                            ("'thread-priority' %d, 'cpu-affinity' 0x%" G_GINT64_MODIFIER
+                             "x: check the CAP_SYS_NICE capability and the CPU mask",
+                             src->thread_priority, src->cpu_affinity));
+    }
+
+    GstZedThreadStatus *status = &src->thread_status;
+    GST_INFO_OBJECT(src, "Capture thread: %s priority %d, CPU mask 0x%" G_GINT64_MODIFIER "x",
+                    status->realtime ? "SCHED_FIFO" : "default", status->priority,
+                    status->cpu_mask);
+
+    if (src->thread_priority > 0 || src->cpu_affinity != 0) {
+        gst_element_post_message(
+            GST_ELEMENT(src),
+            gst_message_new_element(
+                GST_OBJECT(src),
+                gst_structure_new("zed-thread-status", "realtime", G_TYPE_BOOLEAN,
+                                  status->realtime, "priority", G_TYPE_INT, status->priority,
+                                  "cpu-mask", G_TYPE_UINT64, status->cpu_mask, NULL)));
+    }
+}
+
+/* Update the metrics read from the camera, called once per second */
+static void gst_zedsrc_update_camera_metrics(GstZedSrc *src) {
+    // ----> Camera frame drops
+    guint dropped = src->zed->getFrameDroppedCount();
+    if (dropped < src->total_dropped_frames) {
+        src->total_dropped_frames = 0;   // Camera re-opened
+    }
+    gst_zed_counter_add(src->metrics.camera_drops, dropped - src->total_dropped_frames);
+    src->total_dropped_frames = dropped;
+    // <---- Camera frame drops
+
+    // ----> Temperature
+    sl::SensorsData sensors;
+    float temperature;
+    if (src->zed->getSensorsData(sensors, sl::TIME_REFERENCE::CURRENT) ==
+            sl::ERROR_CODE::SUCCESS &&
+        sensors.temperature.get(sl::SensorsData::TemperatureData::SENSOR_LOCATION::IMU,
+                                temperature) == sl::ERROR_CODE::SUCCESS) {
+        gst_zed_gauge_set(src->metrics.temperature, temperature);
+    } else {
+        gst_zed_gauge_set(src->metrics.temperature, NAN);   // No IMU
+    }
+    // <---- Temperature
+}
+
+static GstFlowReturn gst_zedsrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
+    GstZedSrc *src = GST_ZED_SRC(psrc);
+
+    GST_TRACE_OBJECT(src, "gst_zedsrc_fill");
+
+    GstFlowReturn flow;
+    GstMapInfo minfo;
+    GstClockTime clock_time;
+    gboolean repeated;
+
+    static int temp_ugly_buf_index = 0;
+
+    if (!src->is_started) {
+        src->acq_start_time = gst_zedsrc_clock_time(src);
+        gst_zedsrc_setup_thread(src);
+        // Created here for the workers to inherit the capture thread scheduling
+        src->copy_engine = gst_zed_copy_engine_new(src->n_threads);
+        if (!src->hub && !src->grab_worker) {
+            gint fps = static_cast<gint>(
+                src->zed->getCameraInformation().camera_configuration.fps);
+            src->grab_period = gst_util_uint64_scale_int(GST_SECOND, 1, MAX(fps, 1));
+            src->grab_ctx = std::make_shared<GstZedSrcGrab>(src->zed);
+            src->grab_worker = gst_zed_grab_worker_new(
+                "zedsrc-grab", gst_zedsrc_grab_frame,
+                new std::shared_ptr<GstZedSrcGrab>(src->grab_ctx), gst_zedsrc_release_grab);
+            gst_zed_grab_worker_set_flushing(src->grab_worker, src->stop_requested);
+        }
+
+        src->is_started = TRUE;
+    }
+
+    // ----> QoS ladder
+    gst_zedsrc_qos_update(src);
+
+    gboolean skip_depth = FALSE;
+    if (src->qos_active & GST_ZEDSRC_QOS_SKIP_DEPTH) {
+        // Depth not output: never computed. Depth output: computed every other frame
+        skip_depth = !GST_ZEDSRC_NEEDS_DEPTH(src->stream_type) || (src->qos_frame++ % 2) == 1;
+    }
+    g_atomic_int_set(&src->qos_skip_measures, skip_depth);
+    // <---- QoS ladder
+
+    // ----> New frame
+    // Frames dropped by the output frame rate or the QoS ladder are grabbed without
+    // depth processing nor retrieval
+    guint n_dropped = gst_zedsrc_frames_to_drop(src);
+    for (guint i = 0; i <= n_dropped; i++) {
+        gboolean output = (i == n_dropped);
+
+        g_atomic_int_set(&src->skip_retrieve, !output);
+        GstClockTime grab_start = gst_util_get_timestamp();
+        if (src->hub) {
+            flow = gst_zedsrc_wait_hub_frame(src, buf, &clock_time, &repeated);
+        } else {
+            flow = gst_zedsrc_grab(src, buf, &clock_time, &repeated, output && !skip_depth,
+                                   output);
+        }
+        if (flow != GST_FLOW_OK || repeated) {
+            g_atomic_int_set(&src->skip_retrieve, FALSE);
+            if (repeated) {
+                gst_zed_counter_add(src->metrics.repeated, 1);
+            }
+            return flow;
+        }
+        gst_zed_histogram_record(src->metrics.grab, gst_util_get_timestamp() - grab_start);
+        gst_zed_counter_add(src->metrics.grabs, 1);
+    }
+    // <---- New frame
+
+    // Pooled buffers are locked once, before their first write
+    if (src->mlock_buffers && !src->mlock_failed && !gst_zed_buffer_lock_memory(buf)) {
+        src->mlock_failed = TRUE;
+        GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS, ("Output buffers not locked in memory"),
+                            ("Check the CAP_IPC_LOCK capability or RLIMIT_MEMLOCK"));
+    }
+
     // Memory mapping
     if (FALSE == gst_buffer_map(buf, &minfo, GST_MAP_WRITE)) {
         GST_ELEMENT_ERROR(src, RESOURCE, FAILED, ("Failed to map buffer for writing"), (NULL));
-        cuCtxPopCurrent_v2(NULL);
         return GST_FLOW_ERROR;
     }
 
-    // ZED Mats
-    sl::Mat left_img;
-    sl::Mat right_img;
-    sl::Mat depth_data;
-
-    // ----> Mats retrieving
-    auto check_ret = [src](sl::ERROR_CODE ret) {
-        if (ret != sl::ERROR_CODE::SUCCESS) {
-            GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
-                            ("Grabbing failed with error: '%s' - %s", sl::toString(ret).c_str(),
-                            sl::toVerbose(ret).c_str()),
-                            (NULL));
-            return false;
+    // Computed by the copy engine slices, on the pixels they just wrote
+    gboolean image_stats = GST_ZEDSRC_IS_COLOR(src->stream_type) &&
+                           (src->image_stats || src->min_sharpness > 0.0);
+    gboolean gated = GST_ZEDSRC_IS_COLOR(src->stream_type) &&
+                           src->motion_mode != GST_ZEDSRC_MOTION_GATE_NONE;
+    GstZedImageStatsAccumulator stats_acc;
+    GstZedImageStatsAccumulator *analysis = NULL;
+    if (image_stats || gated) {
+        gst_zed_image_stats_begin(&stats_acc, gst_zedsrc_pixel_layout(src), image_stats);
+        analysis = &stats_acc;
+    }
+    if (gated) {
+        if (!src->motion_gate) {
+            src->motion_gate = gst_zed_motion_gate_new();
         }
-        return true;
-    };
-
-    if (src->stream_type == GST_ZEDSRC_ONLY_LEFT) {
-        ret = src->zed.retrieveImage(left_img, sl::VIEW::LEFT, sl::MEM::CPU);
-        if(!check_ret(ret)) return GST_FLOW_ERROR;
-    } else if (src->stream_type == GST_ZEDSRC_ONLY_RIGHT) {
-        ret = src->zed.retrieveImage(left_img, sl::VIEW::RIGHT, sl::MEM::CPU);
-        if(!check_ret(ret)) return GST_FLOW_ERROR;
-    } else if (src->stream_type == GST_ZEDSRC_LEFT_RIGHT) {
-        ret = src->zed.retrieveImage(left_img, sl::VIEW::SIDE_BY_SIDE, sl::MEM::CPU);
-        if(!check_ret(ret)) return GST_FLOW_ERROR;
-    } else if (src->stream_type == GST_ZEDSRC_DEPTH_16) {
-        ret = src->zed.retrieveMeasure(depth_data, sl::MEASURE::DEPTH_U16_MM, sl::MEM::CPU);
-        if(!check_ret(ret)) return GST_FLOW_ERROR;
-    } else if (src->stream_type == GST_ZEDSRC_LEFT_DEPTH) {
-        ret = src->zed.retrieveImage(left_img, sl::VIEW::LEFT, sl::MEM::CPU);
-        if(!check_ret(ret)) return GST_FLOW_ERROR;
-        ret = src->zed.retrieveMeasure(depth_data, sl::MEASURE::DEPTH, sl::MEM::CPU);
-        if(!check_ret(ret)) return GST_FLOW_ERROR;
+        gst_zed_motion_gate_begin(src->motion_gate, &stats_acc, minfo.data, src->out_stride,
+                                  src->out_width, src->out_height);
     }
-    // <---- Mats retrieving
+
+    GstClockTime copy_start = gst_util_get_timestamp();
 
     // ----> Memory copy
-    if (src->stream_type == GST_ZEDSRC_DEPTH_16) {
-        memcpy(minfo.data, depth_data.getPtr<sl::ushort1>(), minfo.size);
-    } else if (src->stream_type == GST_ZEDSRC_LEFT_DEPTH) {
+    if (src->stream_type == GST_ZEDSRC_LEFT_DEPTH) {
         // TODO: Implement left depth copy
         return GST_FLOW_ERROR;
+    } else if (GST_ZEDSRC_IS_POINTCLOUD(src->stream_type)) {
+        sl::Rect rect = src->out_crop ? src->out_crop_rect
+                                      : sl::Rect(0, 0, src->point_cloud->getWidth(),
+                                                 src->point_cloud->getHeight());
+        gst_zedsrc_copy_measure(src,
+                                src->stream_type == GST_ZEDSRC_POINTCLOUD_XYZ
+                                    ? GST_ZEDSRC_COPY_POINTCLOUD_XYZ
+                                    : GST_ZEDSRC_COPY_POINTCLOUD,
+                                minfo.data, 0, *src->point_cloud, NULL, rect,
+                                src->pointcloud_stride);
+    } else if (src->stream_type == GST_ZEDSRC_CONFIDENCE_8) {
+        sl::Rect rect = src->out_crop ? src->out_crop_rect
+                                      : sl::Rect(0, 0, src->confidence_map->getWidth(),
+                                                 src->confidence_map->getHeight());
+        gst_zedsrc_copy_measure(src, GST_ZEDSRC_COPY_CONFIDENCE, minfo.data, src->out_stride,
+                                *src->confidence_map, NULL, rect, 0);
+    } else if (src->stream_type == GST_ZEDSRC_DISPARITY_16 ||
+               src->stream_type == GST_ZEDSRC_DEPTH_CONFIDENCE) {
+        sl::Rect rect = src->out_crop ? src->out_crop_rect
+                                      : sl::Rect(0, 0, src->depth_data->getWidth(),
+                                                 src->depth_data->getHeight());
+        if (src->stream_type == GST_ZEDSRC_DISPARITY_16) {
+            gst_zedsrc_copy_measure(src, GST_ZEDSRC_COPY_DISPARITY16, minfo.data, src->out_stride,
+                                    *src->depth_data, NULL, rect, 0);
+        } else {
+            gst_zedsrc_copy_measure(src, GST_ZEDSRC_COPY_MASKED_DEPTH, minfo.data, src->out_stride,
+                                    *src->depth_data, src->confidence_map.get(), rect,
+                                    src->confidence_threshold);
+        }
+    } else if (GST_ZEDSRC_IS_COLOR(src->stream_type)) {
+        sl::Mat &mat = *src->left_img;
+
+        sl::Rect rect = src->out_crop ? src->out_crop_rect
+                                      : sl::Rect(0, 0, mat.getWidth(), mat.getHeight());
+
+        if (src->stream_type == GST_ZEDSRC_LEFT_RIGHT && (src->out_crop || src->out_scale)) {
+            // Process both views of the side-by-side frame separately
+            const GstVideoFormatInfo *finfo = gst_video_format_get_info(src->out_format);
+            guint half_w = src->out_width / 2;
+            sl::Rect right_rect = rect;
+
+            if (!src->out_crop) {
+                rect.width /= 2;
+                right_rect.width /= 2;
+            }
+            right_rect.x += mat.getWidth() / 2;
+            guint8 *right_dst = minfo.data + half_w * GST_VIDEO_FORMAT_INFO_PSTRIDE(finfo, 0);
+
+            gst_zedsrc_copy_image(src, minfo.data, mat, rect, half_w, src->out_height,
+                                  analysis);
+            gst_zedsrc_copy_image(src, right_dst, mat, right_rect, half_w, src->out_height,
+                                  analysis);
+        } else {
+            gst_zedsrc_copy_image(src, minfo.data, mat, rect, src->out_width, src->out_height,
+                                  analysis);
+        }
     } else {
-        memcpy(minfo.data, left_img.getPtr<sl::uchar4>(), minfo.size);
+        sl::Rect rect = src->out_crop ? src->out_crop_rect
+                                      : sl::Rect(0, 0, src->depth_data->getWidth(),
+                                                 src->depth_data->getHeight());
+        gst_zedsrc_copy_measure(src, GST_ZEDSRC_COPY_RECT, minfo.data, src->out_stride,
+                                *src->depth_data, NULL, rect, 0);
     }
-    cuCtxPopCurrent_v2(NULL);
     // <---- Memory copy
 
+    // ----> Image statistics
+    GstZedImageStats stats;
+    if (analysis) {
+        gst_zed_image_stats_end(analysis, &stats);
+    }
+    gst_zed_histogram_record(src->metrics.copy, gst_util_get_timestamp() - copy_start);
+
+    if (image_stats && stats.sharpness < src->min_sharpness) {
+        // Blurry frame: the base class checks for flushing and calls fill again
+        gst_buffer_unmap(buf, &minfo);
+        gst_zed_counter_add(src->metrics.sharpness_drops, 1);
+        GST_LOG_OBJECT(src, "Frame dropped: sharpness %.1f below %.1f", stats.sharpness,
+                       src->min_sharpness);
+        return GST_BASE_SRC_FLOW_DROPPED;
+    }
+    // <---- Image statistics
+
+    // ----> Motion gate
+    GstZedMotionMask motion;
+    gboolean still = FALSE;
+    if (gated) {
+        guint changed =
+            gst_zed_motion_gate_compare(src->motion_gate, src->motion_threshold, &motion);
+        gboolean keep_alive =
+            src->motion_keep_alive > 0 && GST_CLOCK_TIME_IS_VALID(src->motion_output_time) &&
+            clock_time >= src->motion_output_time + src->motion_keep_alive * GST_MSECOND;
+        still = changed < src->motion_min_blocks && !keep_alive;
+
+        if (still && src->motion_mode == GST_ZEDSRC_MOTION_GATE_DROP) {
+            gst_buffer_unmap(buf, &minfo);
+            gst_zed_counter_add(src->metrics.motion_drops, 1);
+            GST_LOG_OBJECT(src, "Frame dropped: %u changed blocks", changed);
+            return GST_BASE_SRC_FLOW_DROPPED;
+        }
+        if (!still) {
+            // Compared to the last frame with motion: slow changes add up
+            gst_zed_motion_gate_commit(src->motion_gate);
+            src->motion_output_time = clock_time;
+        }
+    }
+    // <---- Motion gate
+
+    // ----> Analysis meta-data
+    if (image_stats && src->image_stats) {
+        gst_buffer_add_zed_image_stats_meta(buf, &stats);
+    }
+    if (gated) {
+        gst_buffer_add_zed_motion_meta(buf, &motion);
+        if (still) {
+            GST_BUFFER_FLAG_SET(buf, GST_BUFFER_FLAG_GAP);
+        }
+    }
+    // <---- Analysis meta-data
 
     // ----> Timestamp meta-data
     GST_BUFFER_TIMESTAMP(buf) =
@@ -1701,9 +4582,53 @@ static GstFlowReturn gst_zedsrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
     GST_BUFFER_OFFSET(buf) = temp_ugly_buf_index++;
     // <---- Timestamp meta-data
 
+    // ----> Pre-event ring recorder
+    if (src->ring) {
+        GstZedFrameRingRecord record = {GST_BUFFER_PTS(buf), clock_time, GST_BUFFER_OFFSET(buf)};
+        if (!gst_zed_frame_ring_push(src->ring, minfo.data, &record)) {
+            GST_LOG_OBJECT(src, "Ring recorder slot still being written: frame not recorded");
+        }
+    }
+    // <---- Pre-event ring recorder
+
+    // ----> Frame kept for the camera recovery
+    // Copied: a reference on `buf` would make it read-only for the elements downstream
+    if (src->reconnect_policy == GST_ZEDSRC_RECONNECT_REPEAT || src->mode_switch_pending) {
+        if (!src->last_buffer || gst_buffer_get_size(src->last_buffer) != minfo.size) {
+            gst_buffer_replace(&src->last_buffer, NULL);
+            src->last_buffer = gst_buffer_new_allocate(NULL, minfo.size, NULL);
+        }
+        gst_buffer_fill(src->last_buffer, 0, minfo.data, minfo.size);
+    }
+    // <---- Frame kept for the camera recovery
+
     // Buffer release
     gst_buffer_unmap(buf, &minfo);
 
+    if (gst_zed_capture_metrics_frame(&src->metrics, gst_buffer_get_size(buf), clock_time)) {
+        gst_zedsrc_update_camera_metrics(src);
+    }
+
+    // ----> QoS output caps
+    // Renegotiated by basesrc before the next buffer, output at the new size and frame
+    // rate from then
+    if (src->qos_renegotiate) {
+        src->qos_renegotiate = FALSE;
+        gst_zedsrc_calculate_caps(src);
+        gst_pad_mark_reconfigure(GST_BASE_SRC_PAD(src));
+    }
+    // <---- QoS output caps
+
+    // ----> Camera mode switch
+    // A camera cannot be opened twice: the old mode stops when the camera is re-opened
+    // in the new one, meanwhile this frame is repeated with the current caps
+    if (src->mode_switch_pending) {
+        src->mode_switch_pending = FALSE;
+        src->mode_switching = TRUE;
+        gst_zedsrc_start_reconnection(src);
+    }
+    // <---- Camera mode switch
+
     if (src->stop_requested) {
         return GST_FLOW_FLUSHING;
     }
@@ -23,9 +23,21 @@
 #define _GST_ZED_SRC_H_
 
 #include <gst/base/gstpushsrc.h>
+#include <gst/video/video.h>
+
+#include <memory>
 
 #include "sl/Camera.hpp"
 
+#include "gstzedcamerahub.h"
+#include "gstzedframering.h"
+#include "gst-zed-common/gstzedcopyengine.h"
+#include "gst-zed-common/gstzedgrabworker.h"
+#include "gst-zed-common/gstzedmetrics.h"
+#include "gst-zed-common/gstzedmotion.h"
+#include "gst-zed-common/gstzedrecovery.h"
+#include "gst-zed-common/gstzedthread.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_ZED_SRC (gst_zedsrc_get_type())
@@ -38,11 +50,17 @@ G_BEGIN_DECLS
 typedef struct _GstZedSrc GstZedSrc;
 typedef struct _GstZedSrcClass GstZedSrcClass;
 
+struct GstZedSrcGrab;   // State of the grab worker thread
+
+#define GST_ZEDSRC_QOS_MAX_STEPS 8
+
 struct _GstZedSrc {
     GstPushSrc base_zedsrc;
 
     // ZED camera object
-    sl::Camera zed;
+    std::shared_ptr<sl::Camera> zed;
+    gchar *input_key;    // Camera input identifier for the camera registry
+    gchar *params_key;   // Opening parameters summary for the camera registry
 
     gboolean is_started;   // grab started flag
 
@@ -69,6 +87,32 @@ struct _GstZedSrc {
     gint roi_y;
     gint roi_w;
     gint roi_h;
+    gboolean roi_output_crop;   // Crop the output buffers to the region of interest
+    gchar *roi_list;            // Region of interest shapes, see `gstzedroimask.h`
+    gint pointcloud_stride;     // Point cloud decimation step
+    guint scale_width;          // Output width, 0 for the camera resolution
+    guint scale_height;         // Output height, 0 for the camera resolution
+    gint output_fps_n;          // Output frame rate numerator, 0 for the camera frame rate
+    gint output_fps_d;          // Output frame rate denominator
+    gdouble ring_duration;      // Ring recorder length [sec], 0 to disable it
+    guint ring_max_size;        // Ring recorder memory limit [MB]
+    gchar *ring_location;       // Directory of the ring recorder captures
+    gboolean qos;               // Degrade the capture when downstream is late
+    gchar *qos_ladder;          // Comma-separated QoS degradation steps
+    gint thread_priority;       // SCHED_FIFO priority of the streaming thread, 0 to keep it
+    guint64 cpu_affinity;       // CPU mask of the streaming thread, 0 to keep it
+    gboolean mlock_buffers;     // Lock the output buffers in RAM
+    guint n_threads;            // Frame copy threads, 0 for automatic
+    gint allocator;             // Output frame allocator [enum]
+    gboolean image_stats;       // Attach the luma statistics meta to the color frames
+    gdouble min_sharpness;      // Drop the color frames less sharp than this, 0 to keep them
+    gint motion_mode;           // Handling of the color frames without motion [enum]
+    guint motion_threshold;     // Mean luma difference of a changed block
+    guint motion_min_blocks;    // Changed blocks of a frame with motion
+    guint motion_keep_alive;    // Longest time without a frame with motion [msec], 0 for none
+    gchar *metrics_location;    // Prometheus text file of the metrics, NULL for none
+    gchar *metrics_socket;      // Unix domain socket serving the metrics, NULL for none
+    guint metrics_interval;     // Period of the metrics file updates [msec]
     // gboolean enable_right_side_measure;
 
     gint confidence_threshold;
@@ -96,20 +140,113 @@ struct _GstZedSrc {
     gint whitebalance_temperature;
     gboolean whitebalance_temperature_auto;
     gboolean led_status;
+    gint reconnect_policy;         // Camera recovery policy [enum]
+    gint reconnect_min_delay;      // First reconnection attempt delay [msec]
+    gint reconnect_max_delay;      // Maximum reconnection attempt delay [msec]
+    gint reconnect_max_attempts;   // Maximum number of attempts (0 for unlimited)
+    gboolean keep_open;            // Keep the camera opened when the element is stopped
+    gboolean shared_camera;        // Share the opened camera with other zedsrc elements
     // <---- Properties
 
     GstClockTime acq_start_time;
     guint32 last_frame_count;
-    guint32 total_dropped_frames;
+    guint32 total_dropped_frames;   // Frames dropped by the camera, counted in the metrics
+
+    gint mode_resolution;           // Camera resolution picked from the caps, -1 if none
+    gint mode_fps;                  // Camera frame rate picked from the caps
+    gboolean mode_update;           // Mode properties changed, under the object lock
+    gboolean mode_switch_pending;   // Caps of another camera mode preferred downstream
+    gboolean mode_switching;        // Camera being re-opened in the new mode
 
     GstCaps *caps;
     guint out_framesize;
+    guint out_stride;                 // Output row size [bytes]
+    GstVideoFormat out_format;        // Negotiated video format
+    guint out_width;                  // Negotiated width [pixels]
+    guint out_height;                 // Negotiated height [pixels]
+    gboolean out_scale;               // Output scaled to `scale_width`x`scale_height`
+    gboolean caps_scale;              // `out_scale` of the computed caps, applied once negotiated
+    gboolean out_crop;                // Output cropped to the region of interest
+    sl::Rect out_crop_rect;           // Cropped rectangle in each view [pixels]
+
+    // ----> Output frame rate
+    guint64 decimate_n;     // Output frame rate step of the accumulator, 0 if not decimated
+    guint64 decimate_d;     // Camera frame period of the accumulator
+    guint64 decimate_acc;   // Output frame accumulator
+    gint skip_retrieve;     // Frame not output, nothing retrieved [atomic]
+    // <---- Output frame rate
+
+    GstZedFrameRing *ring;   // Pre-event ring recorder, NULL if disabled
+
+    // ----> QoS ladder
+    guint qos_steps[GST_ZEDSRC_QOS_MAX_STEPS];   // Steps of `qos_ladder` applicable to the stream
+    guint qos_n_steps;
+    guint qos_level;                // Number of steps applied
+    guint qos_active;               // Flags of the steps applied
+    gint64 qos_last_change;         // Monotonic time of the last transition [usec]
+    guint64 qos_frame;              // Frame counter of the alternate frame steps
+    gint qos_skip_measures;         // Measures not retrieved for this frame [atomic]
+    gboolean qos_renegotiate;       // Output caps to renegotiate after the current buffer
+    gboolean qos_received;          // QoS event received since the last transition
+    gdouble qos_proportion;         // Last downstream proportion, under the object lock
+    GstClockTimeDiff qos_jitter;    // Last downstream lateness [nsec], under the object lock
+    // <---- QoS ladder
 
     gboolean stop_requested;
+
+    // ----> Capture thread
+    GstZedThreadStatus thread_status;   // Scheduling of the streaming thread
+    gboolean mlock_failed;              // Buffer locking refused, not retried
+    GstZedCopyEngine *copy_engine;      // Row sliced frame copy workers
+    GstZedGrabWorker *grab_worker;      // Thread grabbing the camera, NULL when shared
+    std::shared_ptr<GstZedSrcGrab> grab_ctx;   // Shared with `grab_worker`
+    GstClockTime grab_period;           // Camera frame period
+    // <---- Capture thread
+
+    // ----> Motion gate
+    GstZedMotionGate *motion_gate;      // Thumbnail of the reference frame
+    GstClockTime motion_output_time;    // Clock time of the last frame with motion
+    // <---- Motion gate
+
+    GstZedCaptureMetrics metrics;   // Statistics of the `stats` property and the export
+
+    // ----> Camera recovery
+    GstZedRecovery *recovery;   // Camera lost, recovery in progress
+    GMutex reconnect_lock;      // `recovery` and `stop_requested` changes
+    GstBuffer *last_buffer;     // Copy of the last valid frame, used by the REPEAT policy
+                                // and the camera mode switches
+    // <---- Camera recovery
+
+    // ----> Camera sharing
+    GstZedCameraHub *hub;              // Hub grabbing the shared camera, NULL if not shared
+    GstZedHubConsumer hub_consumer;    // Registration of this element to the hub
+    gboolean hub_camera_lost;          // Shared camera grab failing
+    GstClockTime hub_frame_duration;   // Camera frame period
+    // <---- Camera sharing
+
+    // ----> Region of interest
+    gboolean roi_updated;                // ROI properties changed while streaming
+    std::shared_ptr<sl::Mat> roi_mask;   // Last mask built, never modified once set
+    guint64 roi_mask_hash;               // Geometry hash of `roi_mask`
+    // <---- Region of interest
+
+    // ----> Cached handles
+    CUcontext cuda_ctx;   // CUDA context of the opened camera
+    GstClock *clock;      // Element clock, renewed only when the pipeline clock changes
+    // <---- Cached handles
+
+    // ZED Mats, filled by `gst_zedsrc_retrieve` for each frame
+    std::unique_ptr<sl::Mat> left_img;
+    std::unique_ptr<sl::Mat> depth_data;
+    std::unique_ptr<sl::Mat> point_cloud;
+    std::unique_ptr<sl::Mat> confidence_map;
 };
 
 struct _GstZedSrcClass {
     GstPushSrcClass base_zedsrc_class;
+
+    // Action signals
+    gboolean (*trigger_capture)(GstZedSrc *src);
 };
 
 G_GNUC_INTERNAL GType gst_zedsrc_get_type(void);
@@ -26,6 +26,13 @@
 #include <unistd.h>
 
 #include "gstzedxonesrc.h"
+#include "gst-zed-common/gstzedallocator.h"
+#include "gst-zed-common/gstzedconvert.h"
+#include "gst-zed-common/gstzedcopyengine.h"
+#include "gst-zed-common/gstzedimagestatsmeta.h"
+#include "gst-zed-common/gstzedmotionmeta.h"
+#include "gst-zed-common/gstzedscale.h"
+#include "gst-zed-common/gstzedthread.h"
 
 #include <chrono>
 
@@ -44,11 +51,14 @@ static gboolean gst_zedxonesrc_start(GstBaseSrc *src);
 static gboolean gst_zedxonesrc_stop(GstBaseSrc *src);
 static GstCaps *gst_zedxonesrc_get_caps(GstBaseSrc *src, GstCaps *filter);
 static gboolean gst_zedxonesrc_set_caps(GstBaseSrc *src, GstCaps *caps);
+static gboolean gst_zedxonesrc_decide_allocation(GstBaseSrc *src, GstQuery *query);
 static gboolean gst_zedxonesrc_unlock(GstBaseSrc *src);
 static gboolean gst_zedxonesrc_unlock_stop(GstBaseSrc *src);
 
 static GstFlowReturn gst_zedxonesrc_fill(GstPushSrc *src, GstBuffer *buf);
 
+static void gst_zedxonesrc_stop_reconnection(GstZedXOneSrc *src);
+
 enum {
     PROP_0,
     PROP_CAM_RES,
@@ -60,6 +70,7 @@ enum {
     PROP_OPENCV_CALIB_FILE,
     PROP_IMAGE_FLIP,
     PROP_ENABLE_HDR,
+    PROP_SCALE_OUTPUT,
     PROP_SATURATION,
     PROP_SHARPNESS,
     PROP_GAMMA,
@@ -79,6 +90,26 @@ enum {
     PROP_DIGITAL_GAIN_RANGE_MIN,
     PROP_DIGITAL_GAIN_RANGE_MAX,
     PROP_DENOISING,
+    PROP_RECONNECT_POLICY,
+    PROP_RECONNECT_MIN_DELAY,
+    PROP_RECONNECT_MAX_DELAY,
+    PROP_RECONNECT_MAX_ATTEMPTS,
+    PROP_THREAD_PRIORITY,
+    PROP_CPU_AFFINITY,
+    PROP_MLOCK_BUFFERS,
+    PROP_N_THREADS,
+    PROP_ALLOCATOR,
+    PROP_CAMERA_META_INTERVAL,
+    PROP_IMAGE_STATS,
+    PROP_MIN_SHARPNESS,
+    PROP_MOTION_GATE,
+    PROP_MOTION_THRESHOLD,
+    PROP_MOTION_MIN_BLOCKS,
+    PROP_MOTION_KEEP_ALIVE,
+    PROP_STATS,
+    PROP_METRICS_LOCATION,
+    PROP_METRICS_SOCKET,
+    PROP_METRICS_INTERVAL,
     N_PROPERTIES
 };
 
@@ -97,6 +128,25 @@ typedef enum {
     GST_ZEDXONESRC_15FPS = 15
 } GstZedXOneSrcFPS;
 
+typedef enum {
+    GST_ZEDXONESRC_RECONNECT_NONE = 0,
+    GST_ZEDXONESRC_RECONNECT_GAP = 1,
+    GST_ZEDXONESRC_RECONNECT_REPEAT = 2
+} GstZedXOneSrcReconnectPolicy;
+
+typedef enum {
+    GST_ZEDXONESRC_ALLOCATOR_DEFAULT = 0,
+    GST_ZEDXONESRC_ALLOCATOR_HUGEPAGE = 1,
+    GST_ZEDXONESRC_ALLOCATOR_MEMFD = 2,
+    GST_ZEDXONESRC_ALLOCATOR_DMABUF = 3
+} GstZedXOneSrcAllocatorType;
+
+typedef enum {
+    GST_ZEDXONESRC_MOTION_GATE_NONE = 0,
+    GST_ZEDXONESRC_MOTION_GATE_DROP = 1,
+    GST_ZEDXONESRC_MOTION_GATE_GAP = 2
+} GstZedXOneSrcMotionGateMode;
+
 //////////////// DEFAULT PARAMETERS
 /////////////////////////////////////////////////////////////////////////////
 
@@ -109,6 +159,7 @@ typedef enum {
 #define DEFAULT_PROP_CAM_FLIP FALSE
 #define DEFAULT_PROP_ENABLE_HDR FALSE
 #define DEFAULT_PROP_OPENCV_CALIB_FILE ""
+#define DEFAULT_PROP_SCALE_OUTPUT ""
 #define DEFAULT_PROP_SATURATION 4
 #define DEFAULT_PROP_SHARPNESS 1
 #define DEFAULT_PROP_GAMMA 2
@@ -128,6 +179,25 @@ typedef enum {
 #define DEFAULT_PROP_DIGITAL_GAIN_RANGE_MIN 1
 #define DEFAULT_PROP_DIGITAL_GAIN_RANGE_MAX 256
 #define DEFAULT_PROP_DENOISING 50
+#define DEFAULT_PROP_RECONNECT_POLICY GST_ZEDXONESRC_RECONNECT_NONE
+#define DEFAULT_PROP_RECONNECT_MIN_DELAY 100
+#define DEFAULT_PROP_RECONNECT_MAX_DELAY 5000
+#define DEFAULT_PROP_RECONNECT_MAX_ATTEMPTS 0
+#define DEFAULT_PROP_THREAD_PRIORITY 0
+#define DEFAULT_PROP_CPU_AFFINITY 0
+#define DEFAULT_PROP_MLOCK_BUFFERS FALSE
+#define DEFAULT_PROP_N_THREADS 0
+#define DEFAULT_PROP_ALLOCATOR GST_ZEDXONESRC_ALLOCATOR_DEFAULT
+#define DEFAULT_PROP_CAMERA_META_INTERVAL 0
+#define DEFAULT_PROP_IMAGE_STATS FALSE
+#define DEFAULT_PROP_MIN_SHARPNESS 0.0
+#define DEFAULT_PROP_MOTION_GATE GST_ZEDXONESRC_MOTION_GATE_NONE
+#define DEFAULT_PROP_MOTION_THRESHOLD 8
+#define DEFAULT_PROP_MOTION_MIN_BLOCKS 1
+#define DEFAULT_PROP_MOTION_KEEP_ALIVE 1000
+#define DEFAULT_PROP_METRICS_LOCATION NULL
+#define DEFAULT_PROP_METRICS_SOCKET NULL
+#define DEFAULT_PROP_METRICS_INTERVAL 10000
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define GST_TYPE_ZEDXONE_RESOL (gst_zedxonesrc_resol_get_type())
@@ -169,37 +239,111 @@ static GType gst_zedxonesrc_fps_get_type(void) {
     return zedxonesrc_fps_type;
 }
 
+#define GST_TYPE_ZEDXONE_RECONNECT_POLICY (gst_zedxonesrc_reconnect_policy_get_type())
+static GType gst_zedxonesrc_reconnect_policy_get_type(void) {
+    static GType zedxonesrc_reconnect_policy_type = 0;
+
+    if (!zedxonesrc_reconnect_policy_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDXONESRC_RECONNECT_NONE,
+             "Stop the pipeline with an error when the camera is lost", "NONE"},
+            {GST_ZEDXONESRC_RECONNECT_GAP,
+             "Re-open the camera in background and push GAP events while it is missing", "GAP"},
+            {GST_ZEDXONESRC_RECONNECT_REPEAT,
+             "Re-open the camera in background and repeat the last frame while it is missing",
+             "REPEAT"},
+            {0, NULL, NULL},
+        };
+
+        zedxonesrc_reconnect_policy_type =
+            g_enum_register_static("GstZedXOneSrcReconnectPolicy", pattern_types);
+    }
+
+    return zedxonesrc_reconnect_policy_type;
+}
+
+#define GST_TYPE_ZEDXONE_ALLOCATOR (gst_zedxonesrc_allocator_get_type())
+static GType gst_zedxonesrc_allocator_get_type(void) {
+    static GType zedxonesrc_allocator_type = 0;
+
+    if (!zedxonesrc_allocator_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDXONESRC_ALLOCATOR_DEFAULT, "Allocator proposed by downstream or system memory",
+             "default"},
+            {GST_ZEDXONESRC_ALLOCATOR_HUGEPAGE,
+             "Pre-faulted huge page memory recycled by the element buffer pool", "hugepage"},
+            {GST_ZEDXONESRC_ALLOCATOR_MEMFD,
+             "memfd file descriptors, shareable with other processes", "memfd"},
+            {GST_ZEDXONESRC_ALLOCATOR_DMABUF,
+             "udmabuf DMABuf file descriptors, memfd if /dev/udmabuf is not available",
+             "dmabuf"},
+            {0, NULL, NULL},
+        };
+
+        zedxonesrc_allocator_type =
+            g_enum_register_static("GstZedXOneSrcAllocator", pattern_types);
+    }
+
+    return zedxonesrc_allocator_type;
+}
+
+#define GST_TYPE_ZEDXONE_MOTION_GATE (gst_zedxonesrc_motion_gate_get_type())
+static GType gst_zedxonesrc_motion_gate_get_type(void) {
+    static GType zedxonesrc_motion_gate_type = 0;
+
+    if (!zedxonesrc_motion_gate_type) {
+        static GEnumValue pattern_types[] = {
+            {GST_ZEDXONESRC_MOTION_GATE_NONE, "Output every frame", "none"},
+            {GST_ZEDXONESRC_MOTION_GATE_DROP, "Drop the frames without motion", "drop"},
+            {GST_ZEDXONESRC_MOTION_GATE_GAP, "Flag the frames without motion as GAP buffers",
+             "gap"},
+            {0, NULL, NULL},
+        };
+
+        zedxonesrc_motion_gate_type =
+            g_enum_register_static("GstZedXOneSrcMotionGate", pattern_types);
+    }
+
+    return zedxonesrc_motion_gate_type;
+}
+
 /* pad templates */
 static GstStaticPadTemplate gst_zedxonesrc_src_template =
     GST_STATIC_PAD_TEMPLATE("src", GST_PAD_SRC, GST_PAD_ALWAYS,
                             GST_STATIC_CAPS(("video/x-raw, "   // Color 4K
-                                             "format = (string)BGRA, "
+                                             "format = (string) { BGRA, BGR, RGB, GRAY8 }, "
                                              "width = (int)3840, "
                                              "height = (int)2160, "
                                              "framerate = (fraction) { 15, 30 }"
                                              ";"
                                              "video/x-raw, "   // Color QHDPLUS
-                                             "format = (string)BGRA, "
+                                             "format = (string) { BGRA, BGR, RGB, GRAY8 }, "
                                              "width = (int)3200, "
                                              "height = (int)1800, "
                                              "framerate = (fraction) { 15, 30 }"
                                              ";"
                                              "video/x-raw, "   // Color HD1200
-                                             "format = (string)BGRA, "
+                                             "format = (string) { BGRA, BGR, RGB, GRAY8 }, "
                                              "width = (int)1920, "
                                              "height = (int)1200, "
                                              "framerate = (fraction) { 15, 30, 60 }"
                                              ";"
                                              "video/x-raw, "   // Color HD1080
-                                             "format = (string)BGRA, "
+                                             "format = (string) { BGRA, BGR, RGB, GRAY8 }, "
                                              "width = (int)1920, "
                                              "height = (int)1080, "
                                              "framerate = (fraction) { 15, 30, 60 }"
                                              ";"
                                              "video/x-raw, "   // Color SVGA
-                                             "format = (string)BGRA, "
+                                             "format = (string) { BGRA, BGR, RGB, GRAY8 }, "
                                              "width = (int)960, "
                                              "height = (int)600, "
+                                             "framerate = (fraction) { 15, 30, 60, 120 }"
+                                             ";"
+                                             "video/x-raw, "   // Color scaled
+                                             "format = (string) { BGRA, BGR, RGB, GRAY8 }, "
+                                             "width = (int) [ 1, 3840 ], "
+                                             "height = (int) [ 1, 2160 ], "
                                              "framerate = (fraction) { 15, 30, 60, 120 }")));
 
 /* Tools */
@@ -266,6 +410,7 @@ static void gst_zedxonesrc_class_init(GstZedXOneSrcClass *klass) {
     gstbasesrc_class->set_caps = GST_DEBUG_FUNCPTR(gst_zedxonesrc_set_caps);
     gstbasesrc_class->unlock = GST_DEBUG_FUNCPTR(gst_zedxonesrc_unlock);
     gstbasesrc_class->unlock_stop = GST_DEBUG_FUNCPTR(gst_zedxonesrc_unlock_stop);
+    gstbasesrc_class->decide_allocation = GST_DEBUG_FUNCPTR(gst_zedxonesrc_decide_allocation);
 
     gstpushsrc_class->fill = GST_DEBUG_FUNCPTR(gst_zedxonesrc_fill);
 
@@ -324,6 +469,14 @@ static void gst_zedxonesrc_class_init(GstZedXOneSrcClass *klass) {
                              "Enable HDR if supported by resolution and frame rate.", DEFAULT_PROP_ENABLE_HDR,
                              (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+    g_object_class_install_property(
+        gobject_class, PROP_SCALE_OUTPUT,
+        g_param_spec_string("scale-output", "Output size",
+                            "Downscale the output to 'WxH' while copying the frame, e.g. "
+                            "'960x600'. Empty for the camera resolution",
+                            DEFAULT_PROP_SCALE_OUTPUT,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
     g_object_class_install_property(
         gobject_class, PROP_SATURATION,
         g_param_spec_int("ctrl-saturation", "Camera control: saturation", "Image saturation", 0, 8,
@@ -457,15 +610,209 @@ static void gst_zedxonesrc_class_init(GstZedXOneSrcClass *klass) {
         g_param_spec_int("ctrl-denoising", "Camera control: Denoising", "Denoising factor", 0, 100,
                          DEFAULT_PROP_DENOISING,
                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_POLICY,
+        g_param_spec_enum("reconnect-policy", "Camera recovery policy",
+                          "Behavior when the camera is lost while grabbing. With REPEAT each "
+                          "frame is copied, to output the last one again",
+                          GST_TYPE_ZEDXONE_RECONNECT_POLICY, DEFAULT_PROP_RECONNECT_POLICY,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_MIN_DELAY,
+        g_param_spec_int("reconnect-min-delay", "Reconnection minimum delay [msec]",
+                         "Delay before the first reconnection attempt, doubled at each failure",
+                         10, 60000, DEFAULT_PROP_RECONNECT_MIN_DELAY,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_MAX_DELAY,
+        g_param_spec_int("reconnect-max-delay", "Reconnection maximum delay [msec]",
+                         "Maximum delay between two reconnection attempts", 10, 600000,
+                         DEFAULT_PROP_RECONNECT_MAX_DELAY,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_RECONNECT_MAX_ATTEMPTS,
+        g_param_spec_int("reconnect-max-attempts", "Reconnection maximum attempts",
+                         "Number of failed reconnection attempts before stopping with an error "
+                         "(0 for unlimited)",
+                         0, G_MAXINT, DEFAULT_PROP_RECONNECT_MAX_ATTEMPTS,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_THREAD_PRIORITY,
+        g_param_spec_int("thread-priority", "Capture thread priority",
+                         "Real-time SCHED_FIFO priority of the capture thread (requires "
+                         "CAP_SYS_NICE). 0 to keep the default scheduling",
+                         0, 99, DEFAULT_PROP_THREAD_PRIORITY,
+                         (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_CPU_AFFINITY,
+        g_param_spec_uint64("cpu-affinity", "Capture thread CPU affinity",
+                            "Mask of the CPUs the capture thread runs on, bit N for CPU N. 0 to "
+                            "keep the default affinity",
+                            0, G_MAXUINT64, DEFAULT_PROP_CPU_AFFINITY,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MLOCK_BUFFERS,
+        g_param_spec_boolean("mlock-buffers", "Lock buffers in memory",
+                             "Lock the output buffer memory in RAM to avoid page faults while "
+                             "copying the frames (requires CAP_IPC_LOCK or a large enough "
+                             "RLIMIT_MEMLOCK)",
+                             DEFAULT_PROP_MLOCK_BUFFERS,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_N_THREADS,
+        g_param_spec_uint("n-threads", "Copy threads",
+                          "Number of threads copying and converting each frame in row slices, "
+                          "including the capture thread. 0 for automatic",
+                          0, 64, DEFAULT_PROP_N_THREADS,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_ALLOCATOR,
+        g_param_spec_enum("allocator", "Frame allocator",
+                          "Memory of the output frames. 'hugepage', 'memfd' and 'dmabuf' replace "
+                          "the downstream pools. 'dmabuf' also negotiates memory:DMABuf caps",
+                          GST_TYPE_ZEDXONE_ALLOCATOR, DEFAULT_PROP_ALLOCATOR,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_CAMERA_META_INTERVAL,
+        g_param_spec_uint("camera-meta-interval", "Camera state meta interval",
+                          "Frames between two reads of the exposure, gain and white balance "
+                          "applied by the camera, attached to each buffer as GstZedCameraMeta. "
+                          "0 to attach no meta",
+                          0, 3600, DEFAULT_PROP_CAMERA_META_INTERVAL,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_IMAGE_STATS,
+        g_param_spec_boolean("image-stats", "Image statistics",
+                             "Attach the luma histogram, mean, variance and sharpness of the "
+                             "frames as GstZedImageStatsMeta, computed while copying them",
+                             DEFAULT_PROP_IMAGE_STATS,
+                             (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MIN_SHARPNESS,
+        g_param_spec_double("min-sharpness", "Minimum sharpness",
+                            "Drop the frames whose sharpness (variance of the luma Laplacian) "
+                            "is below this value. 0 to keep every frame",
+                            0.0, G_MAXDOUBLE, DEFAULT_PROP_MIN_SHARPNESS,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_GATE,
+        g_param_spec_enum("motion-gate", "Motion gate",
+                          "Handling of the frames without motion since the last frame with "
+                          "motion. The changed blocks are attached as GstZedMotionMeta",
+                          GST_TYPE_ZEDXONE_MOTION_GATE, DEFAULT_PROP_MOTION_GATE,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_THRESHOLD,
+        g_param_spec_uint("motion-threshold", "Motion threshold",
+                          "Mean absolute luma difference over which a 32x32 block changed",
+                          0, 255, DEFAULT_PROP_MOTION_THRESHOLD,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_MIN_BLOCKS,
+        g_param_spec_uint("motion-min-blocks", "Motion minimum blocks",
+                          "Changed blocks for a frame to have motion",
+                          1, G_MAXUINT, DEFAULT_PROP_MOTION_MIN_BLOCKS,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_MOTION_KEEP_ALIVE,
+        g_param_spec_uint("motion-keep-alive", "Motion gate keep-alive",
+                          "A frame is output as with motion when none was for this long [msec]. "
+                          "0 to never force one",
+                          0, 3600000, DEFAULT_PROP_MOTION_KEEP_ALIVE,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_STATS,
+        g_param_spec_boxed("stats", "Capture statistics",
+                           "Frame, byte and drop counters, output frame rate, camera "
+                           "temperature and grab and copy time percentiles [nsec]",
+                           GST_TYPE_STRUCTURE,
+                           (GParamFlags) (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_LOCATION,
+        g_param_spec_string("metrics-location", "Metrics file",
+                            "Prometheus text file the 'stats' are written to every "
+                            "'metrics-interval', e.g. for the node exporter textfile collector. "
+                            "NULL for none",
+                            DEFAULT_PROP_METRICS_LOCATION,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_SOCKET,
+        g_param_spec_string("metrics-socket", "Metrics socket",
+                            "Unix domain socket sending the 'stats' in the Prometheus text "
+                            "format to each client connecting. NULL for none",
+                            DEFAULT_PROP_METRICS_SOCKET,
+                            (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+    g_object_class_install_property(
+        gobject_class, PROP_METRICS_INTERVAL,
+        g_param_spec_uint("metrics-interval", "Metrics interval",
+                          "Period of the 'metrics-location' updates [msec]",
+                          100, 3600000, DEFAULT_PROP_METRICS_INTERVAL,
+                          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+}
+
+/* Release the reference of the grab worker on the camera. A camera abandoned with
+ * a blocked grab is closed by its destructor, from the worker thread. */
+static void gst_zedxonesrc_release_camera(gpointer data) {
+    delete static_cast<std::shared_ptr<sl::CameraOne> *>(data);
 }
 
 static void gst_zedxonesrc_reset(GstZedXOneSrc *src) {
+    gst_zedxonesrc_stop_reconnection(src);
+
+    if (src->_grabWorker) {
+        // A stalled camera must not delay the state change by more than a few frames
+        if (!gst_zed_grab_worker_free(src->_grabWorker, 2 * src->_grabPeriod / GST_USECOND)) {
+            GST_WARNING_OBJECT(src, "Grab still blocked: the camera is closed when it returns");
+            src->_zed = std::make_shared<sl::CameraOne>();
+        }
+        src->_grabWorker = NULL;
+    }
+    gst_buffer_replace(&src->_lastBuffer, NULL);
+
     if (src->_zed->isOpened()) {
         src->_zed->close();
     }
 
     src->_outFramesize = 0;
+    src->_outStride = 0;
+    src->_outWidth = 0;
+    src->_outHeight = 0;
+    src->_outFormat = GST_VIDEO_FORMAT_UNKNOWN;
     src->_isStarted = FALSE;
+    src->_mlockFailed = FALSE;
+
+    gst_zed_copy_engine_free(src->_copyEngine);
+    src->_copyEngine = NULL;
+    src->_grabPeriod = 0;
+    gst_zed_motion_gate_free(src->_motionGate);
+    src->_motionGate = NULL;
+    src->_motionOutputTime = GST_CLOCK_TIME_NONE;
+    src->_cameraStateValid = FALSE;
+    src->_cameraStateAge = 0;
+
+    // The counters keep adding up over the element life
+    gst_zed_metrics_stop_export(src->_metrics.registry);
+    gst_zed_capture_metrics_reset(&src->_metrics);
 
     if (src->_caps) {
         gst_caps_unref(src->_caps);
@@ -490,6 +837,7 @@ static void gst_zedxonesrc_init(GstZedXOneSrc *src) {
     src->_opencvCalibrationFile = *g_string_new(DEFAULT_PROP_OPENCV_CALIB_FILE);
     src->_cameraImageFlip = DEFAULT_PROP_CAM_FLIP;
     src->_enableHDR = DEFAULT_PROP_ENABLE_HDR;
+    gst_zed_parse_size(DEFAULT_PROP_SCALE_OUTPUT, &src->_scaleWidth, &src->_scaleHeight);
 
     src->_saturation = DEFAULT_PROP_SATURATION;
     src->_sharpness = DEFAULT_PROP_SHARPNESS;
@@ -514,14 +862,41 @@ static void gst_zedxonesrc_init(GstZedXOneSrc *src) {
     src->_digitalGain = DEFAULT_PROP_DIGITAL_GAIN;
 
     src->_denoising = DEFAULT_PROP_DENOISING;
+
+    src->_reconnectPolicy = DEFAULT_PROP_RECONNECT_POLICY;
+    src->_reconnectMinDelay = DEFAULT_PROP_RECONNECT_MIN_DELAY;
+    src->_reconnectMaxDelay = DEFAULT_PROP_RECONNECT_MAX_DELAY;
+    src->_reconnectMaxAttempts = DEFAULT_PROP_RECONNECT_MAX_ATTEMPTS;
+    src->_threadPriority = DEFAULT_PROP_THREAD_PRIORITY;
+    src->_cpuAffinity = DEFAULT_PROP_CPU_AFFINITY;
+    src->_mlockBuffers = DEFAULT_PROP_MLOCK_BUFFERS;
+    src->_nThreads = DEFAULT_PROP_N_THREADS;
+    src->_allocator = DEFAULT_PROP_ALLOCATOR;
+    src->_cameraMetaInterval = DEFAULT_PROP_CAMERA_META_INTERVAL;
+    src->_imageStats = DEFAULT_PROP_IMAGE_STATS;
+    src->_minSharpness = DEFAULT_PROP_MIN_SHARPNESS;
+    src->_motionMode = DEFAULT_PROP_MOTION_GATE;
+    src->_motionThreshold = DEFAULT_PROP_MOTION_THRESHOLD;
+    src->_motionMinBlocks = DEFAULT_PROP_MOTION_MIN_BLOCKS;
+    src->_motionKeepAlive = DEFAULT_PROP_MOTION_KEEP_ALIVE;
+    src->_metricsLocation = g_strdup(DEFAULT_PROP_METRICS_LOCATION);
+    src->_metricsSocket = g_strdup(DEFAULT_PROP_METRICS_SOCKET);
+    src->_metricsInterval = DEFAULT_PROP_METRICS_INTERVAL;
     // <---- Parameters initialization
 
     src->_stopRequested = FALSE;
     src->_caps = NULL;
 
+    g_mutex_init(&src->_reconnectLock);
+    src->_recovery = NULL;
+    src->_lastBuffer = NULL;
+
     if (!src->_zed) {
-        src->_zed = std::make_unique<sl::CameraOne>();
+        src->_zed = std::make_shared<sl::CameraOne>();
     }
+    src->_img = std::make_unique<sl::Mat>();
+
+    gst_zed_capture_metrics_init(&src->_metrics);
 
     gst_zedxonesrc_reset(src);
 }
@@ -564,6 +939,12 @@ void gst_zedxonesrc_set_property(GObject *object, guint property_id, const GValu
     case PROP_ENABLE_HDR:
         src->_enableHDR = g_value_get_boolean(value);
         break;
+    case PROP_SCALE_OUTPUT:
+        str = g_value_get_string(value);
+        if (!gst_zed_parse_size(str, &src->_scaleWidth, &src->_scaleHeight)) {
+            GST_WARNING_OBJECT(src, "Invalid 'scale-output' value '%s', ignored", str);
+        }
+        break;
     case PROP_SATURATION:
         src->_saturation = g_value_get_int(value);
         break;
@@ -621,6 +1002,65 @@ void gst_zedxonesrc_set_property(GObject *object, guint property_id, const GValu
     case PROP_DENOISING:
         src->_denoising = g_value_get_int(value);
         break;
+    case PROP_RECONNECT_POLICY:
+        src->_reconnectPolicy = g_value_get_enum(value);
+        break;
+    case PROP_RECONNECT_MIN_DELAY:
+        src->_reconnectMinDelay = g_value_get_int(value);
+        break;
+    case PROP_RECONNECT_MAX_DELAY:
+        src->_reconnectMaxDelay = g_value_get_int(value);
+        break;
+    case PROP_RECONNECT_MAX_ATTEMPTS:
+        src->_reconnectMaxAttempts = g_value_get_int(value);
+        break;
+    case PROP_THREAD_PRIORITY:
+        src->_threadPriority = g_value_get_int(value);
+        break;
+    case PROP_CPU_AFFINITY:
+        src->_cpuAffinity = g_value_get_uint64(value);
+        break;
+    case PROP_MLOCK_BUFFERS:
+        src->_mlockBuffers = g_value_get_boolean(value);
+        break;
+    case PROP_N_THREADS:
+        src->_nThreads = g_value_get_uint(value);
+        break;
+    case PROP_ALLOCATOR:
+        src->_allocator = g_value_get_enum(value);
+        break;
+    case PROP_CAMERA_META_INTERVAL:
+        src->_cameraMetaInterval = g_value_get_uint(value);
+        break;
+    case PROP_IMAGE_STATS:
+        src->_imageStats = g_value_get_boolean(value);
+        break;
+    case PROP_MIN_SHARPNESS:
+        src->_minSharpness = g_value_get_double(value);
+        break;
+    case PROP_MOTION_GATE:
+        src->_motionMode = g_value_get_enum(value);
+        break;
+    case PROP_MOTION_THRESHOLD:
+        src->_motionThreshold = g_value_get_uint(value);
+        break;
+    case PROP_MOTION_MIN_BLOCKS:
+        src->_motionMinBlocks = g_value_get_uint(value);
+        break;
+    case PROP_MOTION_KEEP_ALIVE:
+        src->_motionKeepAlive = g_value_get_uint(value);
+        break;
+    case PROP_METRICS_LOCATION:
+        g_free(src->_metricsLocation);
+        src->_metricsLocation = g_value_dup_string(value);
+        break;
+    case PROP_METRICS_SOCKET:
+        g_free(src->_metricsSocket);
+        src->_metricsSocket = g_value_dup_string(value);
+        break;
+    case PROP_METRICS_INTERVAL:
+        src->_metricsInterval = g_value_get_uint(value);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -664,6 +1104,14 @@ void gst_zedxonesrc_get_property(GObject *object, guint property_id, GValue *val
     case PROP_ENABLE_HDR:
         g_value_set_boolean(value, src->_enableHDR);
         break;
+    case PROP_SCALE_OUTPUT:
+        if (src->_scaleWidth != 0) {
+            g_value_take_string(value,
+                                g_strdup_printf("%ux%u", src->_scaleWidth, src->_scaleHeight));
+        } else {
+            g_value_set_string(value, "");
+        }
+        break;
     case PROP_SATURATION:
         g_value_set_int(value, src->_saturation);
         break;
@@ -721,6 +1169,67 @@ void gst_zedxonesrc_get_property(GObject *object, guint property_id, GValue *val
     case PROP_DENOISING:
         g_value_set_int(value, src->_denoising);
         break;
+    case PROP_RECONNECT_POLICY:
+        g_value_set_enum(value, src->_reconnectPolicy);
+        break;
+    case PROP_RECONNECT_MIN_DELAY:
+        g_value_set_int(value, src->_reconnectMinDelay);
+        break;
+    case PROP_RECONNECT_MAX_DELAY:
+        g_value_set_int(value, src->_reconnectMaxDelay);
+        break;
+    case PROP_RECONNECT_MAX_ATTEMPTS:
+        g_value_set_int(value, src->_reconnectMaxAttempts);
+        break;
+    case PROP_THREAD_PRIORITY:
+        g_value_set_int(value, src->_threadPriority);
+        break;
+    case PROP_CPU_AFFINITY:
+        g_value_set_uint64(value, src->_cpuAffinity);
+        break;
+    case PROP_MLOCK_BUFFERS:
+        g_value_set_boolean(value, src->_mlockBuffers);
+        break;
+    case PROP_N_THREADS:
+        g_value_set_uint(value, src->_nThreads);
+        break;
+    case PROP_ALLOCATOR:
+        g_value_set_enum(value, src->_allocator);
+        break;
+    case PROP_CAMERA_META_INTERVAL:
+        g_value_set_uint(value, src->_cameraMetaInterval);
+        break;
+    case PROP_IMAGE_STATS:
+        g_value_set_boolean(value, src->_imageStats);
+        break;
+    case PROP_MIN_SHARPNESS:
+        g_value_set_double(value, src->_minSharpness);
+        break;
+    case PROP_MOTION_GATE:
+        g_value_set_enum(value, src->_motionMode);
+        break;
+    case PROP_MOTION_THRESHOLD:
+        g_value_set_uint(value, src->_motionThreshold);
+        break;
+    case PROP_MOTION_MIN_BLOCKS:
+        g_value_set_uint(value, src->_motionMinBlocks);
+        break;
+    case PROP_MOTION_KEEP_ALIVE:
+        g_value_set_uint(value, src->_motionKeepAlive);
+        break;
+    case PROP_STATS:
+        g_value_take_boxed(value,
+                           gst_zed_metrics_get_structure(src->_metrics.registry, "zed-stats"));
+        break;
+    case PROP_METRICS_LOCATION:
+        g_value_set_string(value, src->_metricsLocation);
+        break;
+    case PROP_METRICS_SOCKET:
+        g_value_set_string(value, src->_metricsSocket);
+        break;
+    case PROP_METRICS_INTERVAL:
+        g_value_set_uint(value, src->_metricsInterval);
+        break;
     default:
         G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
         break;
@@ -754,6 +1263,15 @@ void gst_zedxonesrc_finalize(GObject *object) {
         src->_caps = NULL;
     }
 
+    g_mutex_clear(&src->_reconnectLock);
+    src->_img.reset();
+
+    g_free(src->_metricsLocation);
+    src->_metricsLocation = NULL;
+    g_free(src->_metricsSocket);
+    src->_metricsSocket = NULL;
+    gst_zed_capture_metrics_clear(&src->_metrics);
+
     G_OBJECT_CLASS(gst_zedxonesrc_parent_class)->finalize(object);
 }
 
@@ -762,8 +1280,8 @@ static gboolean gst_zedxonesrc_calculate_caps(GstZedXOneSrc *src) {
 
     guint32 width, height;
     gint fps;
-    GstVideoInfo vinfo;
-    GstVideoFormat format = GST_VIDEO_FORMAT_BGRA;
+    GValue formats = G_VALUE_INIT;
+    GValue fmt = G_VALUE_INIT;
 
     if (!resol_to_w_h(static_cast<GstZedXOneSrcRes>(src->_cameraResolution), width, height)) {
         return FALSE;
@@ -771,40 +1289,43 @@ static gboolean gst_zedxonesrc_calculate_caps(GstZedXOneSrc *src) {
 
     fps = src->_cameraFps;
 
-    if (format != GST_VIDEO_FORMAT_UNKNOWN) {
-        gst_video_info_init(&vinfo);
-        gst_video_info_set_format(&vinfo, format, width, height);
-        if (src->_caps) {
-            gst_caps_unref(src->_caps);
+    if (src->_scaleWidth != 0) {
+        if (src->_scaleWidth > width || src->_scaleHeight > height) {
+            GST_WARNING_OBJECT(src,
+                               "'scale-output' %ux%u larger than the camera resolution %ux%u: "
+                               "not scaled",
+                               src->_scaleWidth, src->_scaleHeight, width, height);
+        } else {
+            width = src->_scaleWidth;
+            height = src->_scaleHeight;
         }
-        src->_outFramesize = (guint) GST_VIDEO_INFO_SIZE(&vinfo);
-        vinfo.fps_n = fps;
-        vinfo.fps_d = 1;
-        src->_caps = gst_video_info_to_caps(&vinfo);
     }
 
-    gst_base_src_set_blocksize(GST_BASE_SRC(src), src->_outFramesize);
-    gst_base_src_set_caps(GST_BASE_SRC(src), src->_caps);
+    // Downstream picks the cheapest format, the frame size is known once negotiated
+    gst_value_list_init(&formats, 4);
+    g_value_init(&fmt, G_TYPE_STRING);
+    for (const gchar *name : {"BGRA", "BGR", "RGB", "GRAY8"}) {
+        g_value_set_string(&fmt, name);
+        gst_value_list_append_value(&formats, &fmt);
+    }
+
+    if (src->_caps) {
+        gst_caps_unref(src->_caps);
+    }
+    src->_caps = gst_caps_new_simple("video/x-raw", "width", G_TYPE_INT, width, "height",
+                                     G_TYPE_INT, height, "framerate", GST_TYPE_FRACTION, fps, 1,
+                                     "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1, NULL);
+    gst_caps_set_value(src->_caps, "format", &formats);
+    g_value_unset(&fmt);
+    g_value_unset(&formats);
+
     GST_DEBUG_OBJECT(src, "Created caps %" GST_PTR_FORMAT, src->_caps);
 
     return TRUE;
 }
 
-static gboolean gst_zedxonesrc_start(GstBaseSrc *bsrc) {
-#if (ZED_SDK_MAJOR_VERSION != 5)
-    GST_ELEMENT_ERROR(src, LIBRARY, FAILED,
-    ("Wrong ZED SDK version. SDK v5.0 EA or newer required "),
-                      (NULL));
-#endif
-
-    GstZedXOneSrc *src = GST_ZED_X_ONE_SRC(bsrc);
-    sl::ERROR_CODE ret;
-
-    GST_TRACE_OBJECT(src, "gst_zedxonesrc_calculate_caps");
-
-    // ----> Set init parameters
-    sl::InitParametersOne init_params;
-
+static gboolean gst_zedxonesrc_set_init_params(GstZedXOneSrc *src,
+                                               sl::InitParametersOne &init_params) {
     if (src->_cameraId != DEFAULT_PROP_CAM_ID) {
         init_params.input.setFromCameraID(src->_cameraId);
 
@@ -852,17 +1373,12 @@ static gboolean gst_zedxonesrc_start(GstBaseSrc *bsrc) {
     sl::String opencv_calibration_file(src->_opencvCalibrationFile.str);
     init_params.optional_opencv_calibration_file = opencv_calibration_file;
     GST_INFO(" * OpenCV calib file: %s", init_params.optional_opencv_calibration_file.c_str());
-    // <---- Set init parameters
 
-    // ----> Open camera
-    ret = src->_zed->open(init_params);
+    return TRUE;
+}
 
-    if (ret > sl::ERROR_CODE::SUCCESS) {
-        GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
-                          ("Failed to open camera, '%s'", sl::toString(ret).c_str()), (NULL));
-        return FALSE;
-    }
-    // <---- Open camera
+static gboolean gst_zedxonesrc_configure_camera(GstZedXOneSrc *src) {
+    sl::ERROR_CODE ret;
 
     // Check FPS
     src->_realFps = static_cast<int>(src->_zed->getCameraInformation().camera_configuration.fps);
@@ -1035,18 +1551,226 @@ static gboolean gst_zedxonesrc_start(GstBaseSrc *bsrc) {
     GST_INFO(" * Denoising: %d", src->_denoising);
     // <---- Camera Controls
 
+    return TRUE;
+}
+
+/* Export the metrics while streaming, failures leave the stream going */
+static void gst_zedxonesrc_start_metrics(GstZedXOneSrc *src) {
+    gchar *name = gst_object_get_name(GST_OBJECT(src));
+    gchar *labels = g_strdup_printf("element=\"%s\"", name);
+    g_free(name);
+
+    if (!gst_zed_metrics_start_export(src->_metrics.registry, labels, src->_metricsLocation,
+                                      src->_metricsSocket, src->_metricsInterval)) {
+        GST_ELEMENT_WARNING(src, RESOURCE, OPEN_WRITE, ("Metrics not exported"),
+                            ("Cannot listen on 'metrics-socket' %s", src->_metricsSocket));
+    }
+    g_free(labels);
+}
+
+static gboolean gst_zedxonesrc_start(GstBaseSrc *bsrc) {
+#if (ZED_SDK_MAJOR_VERSION != 5)
+    GST_ELEMENT_ERROR(src, LIBRARY, FAILED,
+    ("Wrong ZED SDK version. SDK v5.0 EA or newer required "),
+                      (NULL));
+#endif
+
+    GstZedXOneSrc *src = GST_ZED_X_ONE_SRC(bsrc);
+    sl::ERROR_CODE ret;
+
+    GST_TRACE_OBJECT(src, "gst_zedxonesrc_calculate_caps");
+
+    // ----> Set init parameters
+    sl::InitParametersOne init_params;
+
+    if (!gst_zedxonesrc_set_init_params(src, init_params)) {
+        return FALSE;
+    }
+    // <---- Set init parameters
+
+    // ----> Open camera
+    ret = src->_zed->open(init_params);
+
+    if (ret > sl::ERROR_CODE::SUCCESS) {
+        GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
+                          ("Failed to open camera, '%s'", sl::toString(ret).c_str()), (NULL));
+        return FALSE;
+    }
+    // <---- Open camera
+
+    if (!gst_zedxonesrc_configure_camera(src)) {
+        return FALSE;
+    }
+
     if (!gst_zedxonesrc_calculate_caps(src)) {
         return FALSE;
     }
 
+    gst_zedxonesrc_start_metrics(src);
+
+    return TRUE;
+}
+
+/* Camera re-opened by the recovery thread, with the parameters of the element
+ * when the camera was lost */
+struct GstZedXOneSrcReopen {
+    std::shared_ptr<sl::CameraOne> zed;
+    sl::InitParametersOne init_params;
+};
+
+static gboolean gst_zedxonesrc_reopen_camera(gpointer data, gint attempt) {
+    GstZedXOneSrcReopen *reopen = static_cast<GstZedXOneSrcReopen *>(data);
+
+    GST_INFO("Camera reconnection attempt #%d", attempt);
+
+    sl::ERROR_CODE ret = reopen->zed->open(reopen->init_params);
+    if (ret > sl::ERROR_CODE::SUCCESS) {
+        GST_DEBUG("Reconnection attempt #%d failed: '%s'", attempt, sl::toString(ret).c_str());
+        return FALSE;
+    }
+
     return TRUE;
 }
 
+static void gst_zedxonesrc_close_camera(gpointer data) {
+    static_cast<GstZedXOneSrcReopen *>(data)->zed->close();
+}
+
+static void gst_zedxonesrc_free_reopen(gpointer data) {
+    delete static_cast<GstZedXOneSrcReopen *>(data);
+}
+
+static void gst_zedxonesrc_start_reconnection(GstZedXOneSrc *src) {
+    src->_cameraStateValid = FALSE;   // Read again from the re-opened camera
+
+    GstZedXOneSrcReopen *reopen = new GstZedXOneSrcReopen;
+    reopen->zed = src->_zed;
+    // Parameters have already been validated by `gst_zedxonesrc_start`
+    gst_zedxonesrc_set_init_params(src, reopen->init_params);
+
+    g_mutex_lock(&src->_reconnectLock);
+    src->_recovery = gst_zed_recovery_new(
+        "zedxonesrc-reconnect", gst_zedxonesrc_reopen_camera, gst_zedxonesrc_close_camera,
+        reopen, gst_zedxonesrc_free_reopen, src->_reconnectMinDelay, src->_reconnectMaxDelay,
+        src->_reconnectMaxAttempts);
+    gst_zed_recovery_set_flushing(src->_recovery, src->_stopRequested);
+    g_mutex_unlock(&src->_reconnectLock);
+}
+
+static void gst_zedxonesrc_stop_reconnection(GstZedXOneSrc *src) {
+    g_mutex_lock(&src->_reconnectLock);
+    GstZedRecovery *recovery = src->_recovery;
+    src->_recovery = NULL;
+    g_mutex_unlock(&src->_reconnectLock);
+
+    if (!recovery) {
+        return;
+    }
+
+    // A camera slow to open must not delay the state change by more than a few frames
+    GstClockTime timeout = 2 * gst_util_uint64_scale_int(GST_SECOND, 1, MAX(src->_cameraFps, 1));
+    if (!gst_zed_recovery_free(recovery, timeout / GST_USECOND)) {
+        GST_WARNING_OBJECT(src, "Camera still opening: it is closed when the open returns");
+        src->_zed = std::make_shared<sl::CameraOne>();
+    }
+}
+
+/* Called by the streaming thread while the camera is being re-opened. The
+ * pipeline is kept alive at the nominal frame rate: with the GAP policy a GAP
+ * event is pushed for each missing frame, with the REPEAT policy the last valid
+ * frame is copied into `buf` and `*repeated` is set. Returns GST_FLOW_OK when
+ * a new frame can be grabbed or `buf` has been filled. */
+static GstFlowReturn gst_zedxonesrc_wait_reconnection(GstZedXOneSrc *src, GstBuffer *buf,
+                                                      gboolean *repeated) {
+    GstClockTime frame_duration = gst_util_uint64_scale_int(GST_SECOND, 1, src->_cameraFps);
+    GstPad *srcpad = GST_BASE_SRC_PAD(src);
+
+    gint attempts = 0;
+
+    *repeated = FALSE;
+
+    while (TRUE) {
+        gint64 end_time = g_get_monotonic_time() + frame_duration / GST_USECOND;
+        GstZedRecoveryResult result = gst_zed_recovery_wait(src->_recovery, end_time, &attempts);
+        if (result == GST_ZED_RECOVERY_FLUSHING) {
+            return GST_FLOW_FLUSHING;
+        }
+        if (result == GST_ZED_RECOVERY_FAILED) {
+            GST_ELEMENT_ERROR(src, RESOURCE, NOT_FOUND,
+                              ("Camera reconnection failed after %d attempts", attempts), (NULL));
+            return GST_FLOW_ERROR;
+        }
+        if (result == GST_ZED_RECOVERY_DONE) {
+            break;
+        }
+
+        // ----> Frame period elapsed without camera
+        GstClock *clock = gst_element_get_clock(GST_ELEMENT(src));
+        GstClockTime clock_time = gst_clock_get_time(clock);
+        gst_object_unref(clock);
+        GstClockTime ts = GST_CLOCK_DIFF(gst_element_get_base_time(GST_ELEMENT(src)), clock_time);
+
+        if (src->_reconnectPolicy == GST_ZEDXONESRC_RECONNECT_REPEAT && src->_lastBuffer) {
+            GstMapInfo last_info;
+            if (gst_buffer_map(src->_lastBuffer, &last_info, GST_MAP_READ)) {
+                gst_buffer_fill(buf, 0, last_info.data, last_info.size);
+                gst_buffer_unmap(src->_lastBuffer, &last_info);
+            }
+            GST_BUFFER_TIMESTAMP(buf) = ts;
+            GST_BUFFER_DTS(buf) = ts;
+            GST_BUFFER_DURATION(buf) = frame_duration;
+            *repeated = TRUE;
+            gst_zed_counter_add(src->_metrics.repeated, 1);
+            return GST_FLOW_OK;
+        }
+
+        GstEvent *segment = gst_pad_get_sticky_event(srcpad, GST_EVENT_SEGMENT, 0);
+        if (segment) {
+            gst_event_unref(segment);
+            gst_pad_push_event(srcpad, gst_event_new_gap(ts, frame_duration));
+        }
+        // <---- Frame period elapsed without camera
+    }
+
+    // The recovery thread is done: the camera is configured again from here
+    gst_zedxonesrc_stop_reconnection(src);
+
+    if (!gst_zedxonesrc_configure_camera(src)) {
+        return GST_FLOW_ERROR;
+    }
+
+    GST_ELEMENT_INFO(src, RESOURCE, OPEN_READ,
+                     ("Camera reconnected after %d attempts", attempts), (NULL));
+
+    return GST_FLOW_OK;
+}
+
+/* Log the counters of the huge page allocator, shared by all the elements */
+static void gst_zedxonesrc_log_allocator_stats(GstZedXOneSrc *src) {
+    GstAllocator *allocator;
+    GstZedAllocatorStats stats;
+
+    if (src->_allocator != GST_ZEDXONESRC_ALLOCATOR_HUGEPAGE ||
+        !(allocator = gst_zed_hugepage_allocator_get())) {
+        return;
+    }
+
+    gst_zed_hugepage_allocator_get_stats(allocator, &stats);
+    gst_object_unref(allocator);
+
+    GST_INFO_OBJECT(src,
+                    "Huge page allocator: %" G_GUINT64_FORMAT " memories (%" G_GUINT64_FORMAT
+                    " with reserved huge pages), %" G_GUINT64_FORMAT " MB, %" G_GUINT64_FORMAT
+                    " page faults avoided",
+                    stats.allocations, stats.hugetlb, stats.bytes >> 20, stats.faults_avoided);
+}
+
 static gboolean gst_zedxonesrc_stop(GstBaseSrc *bsrc) {
     GstZedXOneSrc *src = GST_ZED_X_ONE_SRC(bsrc);
 
     GST_TRACE_OBJECT(src, "gst_zedxonesrc_stop");
 
+    gst_zedxonesrc_log_allocator_stats(src);
     gst_zedxonesrc_reset(src);
 
     return TRUE;
@@ -1062,6 +1786,16 @@ static GstCaps *gst_zedxonesrc_get_caps(GstBaseSrc *bsrc, GstCaps *filter) {
         caps = gst_pad_get_pad_template_caps(GST_BASE_SRC_PAD(src));
     }
 
+    if (src->_allocator == GST_ZEDXONESRC_ALLOCATOR_DMABUF && caps) {
+        GstAllocator *udmabuf = gst_zed_udmabuf_allocator_get();
+
+        // Only offered when the frames can actually be DMABufs
+        if (udmabuf) {
+            gst_object_unref(udmabuf);
+            caps = gst_zed_caps_add_dmabuf(caps);
+        }
+    }
+
     GST_DEBUG_OBJECT(src, "The caps before filtering are %" GST_PTR_FORMAT, caps);
 
     if (filter && caps) {
@@ -1091,6 +1825,13 @@ static gboolean gst_zedxonesrc_set_caps(GstBaseSrc *bsrc, GstCaps *caps) {
         goto unsupported_caps;
     }
 
+    src->_outFormat = GST_VIDEO_INFO_FORMAT(&vinfo);
+    src->_outFramesize = (guint) GST_VIDEO_INFO_SIZE(&vinfo);
+    src->_outStride = (guint) GST_VIDEO_INFO_PLANE_STRIDE(&vinfo, 0);
+    src->_outWidth = (guint) GST_VIDEO_INFO_WIDTH(&vinfo);
+    src->_outHeight = (guint) GST_VIDEO_INFO_HEIGHT(&vinfo);
+    gst_base_src_set_blocksize(bsrc, src->_outFramesize);
+
     return TRUE;
 
 unsupported_caps:
@@ -1098,12 +1839,101 @@ unsupported_caps:
     return FALSE;
 }
 
+/* Allocator of the 'allocator' property, NULL if not supported. The udmabuf one
+ * falls back to memfd: both pass the frames by file descriptor. */
+static GstAllocator *gst_zedxonesrc_frame_allocator(GstZedXOneSrc *src) {
+    GstAllocator *allocator = NULL;
+
+    switch (src->_allocator) {
+    case GST_ZEDXONESRC_ALLOCATOR_HUGEPAGE:
+        allocator = gst_zed_hugepage_allocator_get();
+        break;
+    case GST_ZEDXONESRC_ALLOCATOR_DMABUF:
+        allocator = gst_zed_udmabuf_allocator_get();
+        if (allocator) {
+            break;
+        }
+        GST_WARNING_OBJECT(src, "/dev/udmabuf not available, using memfd memories");
+        // fallthrough
+    case GST_ZEDXONESRC_ALLOCATOR_MEMFD:
+        allocator = gst_zed_memfd_allocator_get();
+        break;
+    default:
+        break;
+    }
+
+    return allocator;
+}
+
+/* Allocation of the output frames: at least 64 bytes aligned for the SIMD kernels
+ * downstream. With another allocator than the default one, the downstream pool is
+ * replaced by a pool of the base class recycling the memories of that allocator. */
+static gboolean gst_zedxonesrc_decide_allocation(GstBaseSrc *bsrc, GstQuery *query) {
+    GstZedXOneSrc *src = GST_ZED_X_ONE_SRC(bsrc);
+    GstAllocator *allocator = NULL;
+    GstAllocationParams params;
+
+    if (gst_query_get_n_allocation_params(query) > 0) {
+        gst_query_parse_nth_allocation_param(query, 0, &allocator, &params);
+    } else {
+        gst_allocation_params_init(&params);
+    }
+    params.align |= GST_ZED_ALLOCATOR_ALIGN;
+
+    if (src->_allocator != GST_ZEDXONESRC_ALLOCATOR_DEFAULT) {
+        GstAllocator *frames = gst_zedxonesrc_frame_allocator(src);
+
+        if (frames) {
+            gst_object_replace((GstObject **) &allocator, GST_OBJECT_CAST(frames));
+            gst_object_unref(frames);
+
+            guint size = src->_outFramesize, min = 0, max = 0;
+            if (gst_query_get_n_allocation_pools(query) > 0) {
+                GstBufferPool *pool = NULL;
+                gst_query_parse_nth_allocation_pool(query, 0, &pool, &size, &min, &max);
+                if (pool) {
+                    gst_object_unref(pool);
+                }
+                size = MAX(size, src->_outFramesize);
+                gst_query_set_nth_allocation_pool(query, 0, NULL, size, min, max);
+            } else {
+                // Without a pool each frame would be mapped again
+                gst_query_add_allocation_pool(query, NULL, size, min, max);
+            }
+        } else {
+            GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS,
+                                ("Frame allocator not supported, using the default allocator"),
+                                (NULL));
+        }
+    }
+
+    if (gst_query_get_n_allocation_params(query) > 0) {
+        gst_query_set_nth_allocation_param(query, 0, allocator, &params);
+    } else {
+        gst_query_add_allocation_param(query, allocator, &params);
+    }
+    if (allocator) {
+        gst_object_unref(allocator);
+    }
+
+    return GST_BASE_SRC_CLASS(gst_zedxonesrc_parent_class)->decide_allocation(bsrc, query);
+}
+
 static gboolean gst_zedxonesrc_unlock(GstBaseSrc *bsrc) {
     GstZedXOneSrc *src = GST_ZED_X_ONE_SRC(bsrc);
 
     GST_TRACE_OBJECT(src, "gst_zedxonesrc_unlock");
 
+    g_mutex_lock(&src->_reconnectLock);
     src->_stopRequested = TRUE;
+    if (src->_recovery) {
+        gst_zed_recovery_set_flushing(src->_recovery, TRUE);
+    }
+    g_mutex_unlock(&src->_reconnectLock);
+
+    if (src->_grabWorker) {
+        gst_zed_grab_worker_set_flushing(src->_grabWorker, TRUE);
+    }
 
     return TRUE;
 }
@@ -1113,7 +1943,102 @@ static gboolean gst_zedxonesrc_unlock_stop(GstBaseSrc *bsrc) {
 
     GST_TRACE_OBJECT(src, "gst_zedxonesrc_unlock_stop");
 
+    g_mutex_lock(&src->_reconnectLock);
     src->_stopRequested = FALSE;
+    if (src->_recovery) {
+        gst_zed_recovery_set_flushing(src->_recovery, FALSE);
+    }
+    g_mutex_unlock(&src->_reconnectLock);
+
+    if (src->_grabWorker) {
+        gst_zed_grab_worker_set_flushing(src->_grabWorker, FALSE);
+    }
+
+    return TRUE;
+}
+
+/* Apply the real-time settings to the streaming thread, called from its first frame */
+static void gst_zedxonesrc_setup_thread(GstZedXOneSrc *src) {
+    if (!gst_zed_thread_setup(src->_threadPriority, src->_cpuAffinity, &src->_threadStatus)) {
+        GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS,
+                            ("Capture thread scheduling not applied"),
+                            ("'thread-priority' %d, 'cpu-affinity' 0x%" G_GINT64_MODIFIER
+                             "x: check the CAP_SYS_NICE capability and the CPU mask",
+                             src->_threadPriority, src->_cpuAffinity));
+    }
+
+    GstZedThreadStatus *status = &src->_threadStatus;
+    GST_INFO_OBJECT(src, "Capture thread: %s priority %d, CPU mask 0x%" G_GINT64_MODIFIER "x",
+                    status->realtime ? "SCHED_FIFO" : "default", status->priority,
+                    status->cpu_mask);
+
+    if (src->_threadPriority > 0 || src->_cpuAffinity != 0) {
+        gst_element_post_message(
+            GST_ELEMENT(src),
+            gst_message_new_element(
+                GST_OBJECT(src),
+                gst_structure_new("zed-thread-status", "realtime", G_TYPE_BOOLEAN,
+                                  status->realtime, "priority", G_TYPE_INT, status->priority,
+                                  "cpu-mask", G_TYPE_UINT64, status->cpu_mask, NULL)));
+    }
+}
+
+/* Read the image controls applied by the camera for the next frames meta. The auto
+ * flags come from the properties, the controls being set at opening only. */
+static void gst_zedxonesrc_read_camera_state(GstZedXOneSrc *src) {
+    GstZedCameraState *state = &src->_cameraState;
+    auto read = [src](sl::VIDEO_SETTINGS setting) {
+        int value;
+        return src->_zed->getCameraSettings(setting, value) == sl::ERROR_CODE::SUCCESS ? value
+                                                                                         : -1;
+    };
+
+    state->flags = (src->_autoExposure ? GST_ZED_CAMERA_STATE_AUTO_EXPOSURE : 0) |
+                   (src->_autoAnalogGain ? GST_ZED_CAMERA_STATE_AUTO_ANALOG_GAIN : 0) |
+                   (src->_autoDigitalGain ? GST_ZED_CAMERA_STATE_AUTO_DIGITAL_GAIN : 0) |
+                   (src->_autoWb ? GST_ZED_CAMERA_STATE_AUTO_WHITE_BALANCE : 0) |
+                   (src->_enableHDR ? GST_ZED_CAMERA_STATE_HDR : 0);
+    state->exposure_time = read(sl::VIDEO_SETTINGS::EXPOSURE_TIME);
+    state->analog_gain = read(sl::VIDEO_SETTINGS::ANALOG_GAIN);
+    state->digital_gain = read(sl::VIDEO_SETTINGS::DIGITAL_GAIN);
+    state->white_balance = read(sl::VIDEO_SETTINGS::WHITEBALANCE_TEMPERATURE);
+
+    src->_cameraStateValid = TRUE;
+    src->_cameraStateAge = 0;
+}
+
+/* Update the metrics read from the camera, called once per second. The camera frame
+ * drops are only counted by zedsrc. */
+static void gst_zedxonesrc_update_camera_metrics(GstZedXOneSrc *src) {
+    sl::SensorsData sensors;
+    float temperature;
+
+    if (src->_zed->getSensorsData(sensors, sl::TIME_REFERENCE::CURRENT) ==
+            sl::ERROR_CODE::SUCCESS &&
+        sensors.temperature.get(sl::SensorsData::TemperatureData::SENSOR_LOCATION::IMU,
+                                temperature) == sl::ERROR_CODE::SUCCESS) {
+        gst_zed_gauge_set(src->_metrics.temperature, temperature);
+    } else {
+        gst_zed_gauge_set(src->_metrics.temperature, NAN);   // No IMU
+    }
+}
+
+/* Grab function of the worker thread, only using its reference on the camera: the
+ * element may be stopped while the grab is blocked. */
+static gint gst_zedxonesrc_grab_frame(gpointer user_data) {
+    std::shared_ptr<sl::CameraOne> &zed = *static_cast<std::shared_ptr<sl::CameraOne> *>(user_data);
+
+    return static_cast<gint>(zed->grab());
+}
+
+/* Grab a frame on the worker thread, FALSE if the wait is interrupted by a flush */
+static gboolean gst_zedxonesrc_wait_grab(GstZedXOneSrc *src, sl::ERROR_CODE *ret) {
+    gint code;
+
+    if (gst_zed_grab_worker_grab(src->_grabWorker, &code) == GST_ZED_GRAB_FLUSHING) {
+        return FALSE;
+    }
+    *ret = static_cast<sl::ERROR_CODE>(code);
 
     return TRUE;
 }
@@ -1132,20 +2057,68 @@ static GstFlowReturn gst_zedxonesrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
 
     if (!src->_isStarted) {
         src->_acqStartTime = gst_clock_get_time(gst_element_get_clock(GST_ELEMENT(src)));
+        gst_zedxonesrc_setup_thread(src);
+        // Created here for the workers to inherit the capture thread scheduling
+        src->_copyEngine = gst_zed_copy_engine_new(src->_nThreads);
+        src->_grabPeriod = gst_util_uint64_scale_int(GST_SECOND, 1, MAX(src->_realFps, 1));
+        src->_grabWorker = gst_zed_grab_worker_new(
+            "zedxonesrc-grab", gst_zedxonesrc_grab_frame,
+            new std::shared_ptr<sl::CameraOne>(src->_zed), gst_zedxonesrc_release_camera);
+        gst_zed_grab_worker_set_flushing(src->_grabWorker, src->_stopRequested);
 
         src->_isStarted = TRUE;
     }
 
+    // ----> Camera recovery
+    if (src->_recovery) {
+        gboolean repeated;
+        GstFlowReturn flow = gst_zedxonesrc_wait_reconnection(src, buf, &repeated);
+        if (flow != GST_FLOW_OK || repeated) {
+            return flow;
+        }
+    }
+    // <---- Camera recovery
+
     // ----> ZED grab
     GST_TRACE(" Data Grabbing");
-    ret = src->_zed->grab();
+    GstClockTime grab_start = gst_util_get_timestamp();
+    if (!gst_zedxonesrc_wait_grab(src, &ret)) {
+        return GST_FLOW_FLUSHING;
+    }
 
     if (ret > sl::ERROR_CODE::SUCCESS) {
-        GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
-                          ("Grabbing failed with error: '%s' - %s", sl::toString(ret).c_str(),
-                           sl::toVerbose(ret).c_str()),
-                          (NULL));
-        return GST_FLOW_ERROR;
+        if (src->_reconnectPolicy == GST_ZEDXONESRC_RECONNECT_NONE) {
+            GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
+                              ("Grabbing failed with error: '%s' - %s", sl::toString(ret).c_str(),
+                               sl::toVerbose(ret).c_str()),
+                              (NULL));
+            return GST_FLOW_ERROR;
+        }
+
+        GST_ELEMENT_WARNING(src, RESOURCE, READ,
+                            ("Camera lost with error: '%s' - %s. Reconnecting...",
+                             sl::toString(ret).c_str(), sl::toVerbose(ret).c_str()),
+                            (NULL));
+        gst_zed_counter_add(src->_metrics.reconnects, 1);
+        gst_zedxonesrc_start_reconnection(src);
+
+        gboolean repeated;
+        GstFlowReturn flow = gst_zedxonesrc_wait_reconnection(src, buf, &repeated);
+        if (flow != GST_FLOW_OK || repeated) {
+            return flow;
+        }
+
+        // Camera is back: grab the first new frame
+        if (!gst_zedxonesrc_wait_grab(src, &ret)) {
+            return GST_FLOW_FLUSHING;
+        }
+        if (ret > sl::ERROR_CODE::SUCCESS) {
+            GST_ELEMENT_ERROR(src, RESOURCE, FAILED,
+                              ("Grabbing failed after reconnection: '%s' - %s",
+                               sl::toString(ret).c_str(), sl::toVerbose(ret).c_str()),
+                              (NULL));
+            return GST_FLOW_ERROR;
+        }
     }
     // <---- ZED grab
 
@@ -1156,6 +2129,13 @@ static GstFlowReturn gst_zedxonesrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
     gst_object_unref(clock);
     // <---- Clock update
 
+    // Pooled buffers are locked once, before their first write
+    if (src->_mlockBuffers && !src->_mlockFailed && !gst_zed_buffer_lock_memory(buf)) {
+        src->_mlockFailed = TRUE;
+        GST_ELEMENT_WARNING(src, RESOURCE, SETTINGS, ("Output buffers not locked in memory"),
+                            ("Check the CAP_IPC_LOCK capability or RLIMIT_MEMLOCK"));
+    }
+
     // Memory mapping
     GST_TRACE("Memory mapping");
     if (FALSE == gst_buffer_map(buf, &minfo, GST_MAP_WRITE)) {
@@ -1163,8 +2143,7 @@ static GstFlowReturn gst_zedxonesrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
         return GST_FLOW_ERROR;
     }
 
-    // ZED Mats
-    sl::Mat img;
+    sl::Mat &img = *src->_img;
 
     // ----> Retrieve images
     GST_TRACE("Retrieve images");
@@ -1179,13 +2158,108 @@ static GstFlowReturn gst_zedxonesrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
         return true;
     };
 
-    ret = src->_zed->retrieveImage(img, sl::VIEW::LEFT, sl::MEM::CPU);
+    // The SDK provides the gray view directly
+    gboolean gray = (src->_outFormat == GST_VIDEO_FORMAT_GRAY8);
+    ret = src->_zed->retrieveImage(img, gray ? sl::VIEW::LEFT_GRAY : sl::VIEW::LEFT,
+                                   sl::MEM::CPU);
     if(!check_ret(ret)) return GST_FLOW_ERROR;
     // <---- Retrieve images
 
-    // Memory copy
+    gst_zed_histogram_record(src->_metrics.grab, gst_util_get_timestamp() - grab_start);
+    gst_zed_counter_add(src->_metrics.grabs, 1);
+    GstClockTime copy_start = gst_util_get_timestamp();
+
+    // ----> Memory copy
     GST_TRACE("Memory copy");
-    memcpy(minfo.data, img.getPtr<sl::uchar4>(), minfo.size);
+    const guint8 *in = img.getPtr<sl::uchar1>(sl::MEM::CPU);
+    gsize in_stride = img.getStepBytes(sl::MEM::CPU);
+    GstZedConvertFunc convert = NULL;
+    GstZedPixelLayout layout = gray ? GST_ZED_PIXEL_GRAY8 : GST_ZED_PIXEL_BGRA;
+    if (src->_outFormat == GST_VIDEO_FORMAT_BGR) {
+        convert = gst_zed_convert_bgra_to_bgr;
+        layout = GST_ZED_PIXEL_BGR;
+    } else if (src->_outFormat == GST_VIDEO_FORMAT_RGB) {
+        convert = gst_zed_convert_bgra_to_rgb;
+        layout = GST_ZED_PIXEL_RGB;
+    }
+
+    // Computed by the copy engine slices, on the pixels they just wrote
+    gboolean image_stats = src->_imageStats || src->_minSharpness > 0.0;
+    gboolean gated = src->_motionMode != GST_ZEDXONESRC_MOTION_GATE_NONE;
+    GstZedImageStatsAccumulator stats_acc;
+    GstZedImageStatsAccumulator *analysis = NULL;
+    if (image_stats || gated) {
+        gst_zed_image_stats_begin(&stats_acc, layout, image_stats);
+        analysis = &stats_acc;
+    }
+    if (gated) {
+        if (!src->_motionGate) {
+            src->_motionGate = gst_zed_motion_gate_new();
+        }
+        gst_zed_motion_gate_begin(src->_motionGate, &stats_acc, minfo.data, src->_outStride,
+                                  src->_outWidth, src->_outHeight);
+    }
+
+    // Scaled in the same pass as the copy and the conversion
+    gst_zed_copy_engine_copy_image(src->_copyEngine, in, in_stride, img.getWidth(),
+                                   img.getHeight(), img.getPixelBytes(), minfo.data,
+                                   src->_outStride, src->_outWidth, src->_outHeight, convert,
+                                   analysis);
+    // <---- Memory copy
+
+    // ----> Image statistics
+    GstZedImageStats stats;
+    if (analysis) {
+        gst_zed_image_stats_end(analysis, &stats);
+    }
+    gst_zed_histogram_record(src->_metrics.copy, gst_util_get_timestamp() - copy_start);
+
+    if (image_stats && stats.sharpness < src->_minSharpness) {
+        // Blurry frame: the base class checks for flushing and calls fill again
+        gst_buffer_unmap(buf, &minfo);
+        gst_zed_counter_add(src->_metrics.sharpness_drops, 1);
+        GST_LOG_OBJECT(src, "Frame dropped: sharpness %.1f below %.1f", stats.sharpness,
+                       src->_minSharpness);
+        return GST_BASE_SRC_FLOW_DROPPED;
+    }
+    // <---- Image statistics
+
+    // ----> Motion gate
+    GstZedMotionMask motion;
+    gboolean still = FALSE;
+    if (gated) {
+        guint changed =
+            gst_zed_motion_gate_compare(src->_motionGate, src->_motionThreshold, &motion);
+        gboolean keep_alive =
+            src->_motionKeepAlive > 0 && GST_CLOCK_TIME_IS_VALID(src->_motionOutputTime) &&
+            clock_time >= src->_motionOutputTime + src->_motionKeepAlive * GST_MSECOND;
+        still = changed < src->_motionMinBlocks && !keep_alive;
+
+        if (still && src->_motionMode == GST_ZEDXONESRC_MOTION_GATE_DROP) {
+            gst_buffer_unmap(buf, &minfo);
+            gst_zed_counter_add(src->_metrics.motion_drops, 1);
+            GST_LOG_OBJECT(src, "Frame dropped: %u changed blocks", changed);
+            return GST_BASE_SRC_FLOW_DROPPED;
+        }
+        if (!still) {
+            // Compared to the last frame with motion: slow changes add up
+            gst_zed_motion_gate_commit(src->_motionGate);
+            src->_motionOutputTime = clock_time;
+        }
+    }
+    // <---- Motion gate
+
+    // ----> Analysis meta-data
+    if (image_stats && src->_imageStats) {
+        gst_buffer_add_zed_image_stats_meta(buf, &stats);
+    }
+    if (gated) {
+        gst_buffer_add_zed_motion_meta(buf, &motion);
+        if (still) {
+            GST_BUFFER_FLAG_SET(buf, GST_BUFFER_FLAG_GAP);
+        }
+    }
+    // <---- Analysis meta-data
 
     // ----> Timestamp meta-data
     GST_TRACE("Timestamp meta-data");
@@ -1195,11 +2269,36 @@ static GstFlowReturn gst_zedxonesrc_fill(GstPushSrc *psrc, GstBuffer *buf) {
     GST_BUFFER_OFFSET(buf) = temp_ugly_buf_index++;
     // <---- Timestamp meta-data
 
+    // ----> Camera state meta-data
+    // Polled every few frames only: each read is a driver round trip
+    if (src->_cameraMetaInterval > 0) {
+        if (!src->_cameraStateValid || src->_cameraStateAge >= src->_cameraMetaInterval) {
+            gst_zedxonesrc_read_camera_state(src);
+        }
+        gst_buffer_add_zed_camera_meta(buf, &src->_cameraState, src->_cameraStateAge++);
+    }
+    // <---- Camera state meta-data
+
+    // ----> Frame kept for the camera recovery
+    // Copied: a reference on `buf` would make it read-only for the elements downstream
+    if (src->_reconnectPolicy == GST_ZEDXONESRC_RECONNECT_REPEAT) {
+        if (!src->_lastBuffer || gst_buffer_get_size(src->_lastBuffer) != minfo.size) {
+            gst_buffer_replace(&src->_lastBuffer, NULL);
+            src->_lastBuffer = gst_buffer_new_allocate(NULL, minfo.size, NULL);
+        }
+        gst_buffer_fill(src->_lastBuffer, 0, minfo.data, minfo.size);
+    }
+    // <---- Frame kept for the camera recovery
+
     // Buffer release
     GST_TRACE("Buffer release");
     gst_buffer_unmap(buf, &minfo);
     // gst_buffer_unref(buf); // NOTE(Walter) do not uncomment to not crash
 
+    if (gst_zed_capture_metrics_frame(&src->_metrics, gst_buffer_get_size(buf), clock_time)) {
+        gst_zedxonesrc_update_camera_metrics(src);
+    }
+
     if (src->_stopRequested) {
         return GST_FLOW_FLUSHING;
     }
@@ -23,9 +23,20 @@
 #define _GST_ZED_X_ONE_SRC_H_
 
 #include <gst/base/gstpushsrc.h>
+#include <gst/video/video.h>
+
+#include <memory>
 
 #include "sl/CameraOne.hpp"
 
+#include "gst-zed-common/gstzedcamerameta.h"
+#include "gst-zed-common/gstzedcopyengine.h"
+#include "gst-zed-common/gstzedgrabworker.h"
+#include "gst-zed-common/gstzedmetrics.h"
+#include "gst-zed-common/gstzedmotion.h"
+#include "gst-zed-common/gstzedrecovery.h"
+#include "gst-zed-common/gstzedthread.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_ZED_X_ONE_SRC (gst_zedxonesrc_get_type())
@@ -43,7 +54,8 @@ struct _GstZedXOneSrc {
     GstPushSrc _base_zedxonesrc;
 
     // ZED X One camera object
-    std::unique_ptr<sl::CameraOne> _zed;   // ZED X One object
+    std::shared_ptr<sl::CameraOne> _zed;   // ZED X One object
+    std::unique_ptr<sl::Mat> _img;         // Image retrieved for each frame, kept allocated
 
     gboolean _isStarted;       // grab started flag
     gboolean _stopRequested;   // stop request flagout_framesize
@@ -58,6 +70,8 @@ struct _GstZedXOneSrc {
     GString _opencvCalibrationFile; // OpenCV calibration file path
     gboolean _cameraImageFlip;      // Camera flipped
     gboolean _enableHDR;            // HDR mode
+    guint _scaleWidth;              // Output width, 0 for the camera resolution
+    guint _scaleHeight;             // Output height, 0 for the camera resolution
 
     gint _saturation;   // Image Saturation
     gint _sharpness;    // Image Sharpness
@@ -83,6 +97,26 @@ struct _GstZedXOneSrc {
     gint _digitalGainRange_max; // Maximum value for Automatic Digital Gain [1,256]
     
     gint _denoising;    // Image Denoising [0,100]
+
+    gint _reconnectPolicy;        // Camera recovery policy [enum]
+    gint _reconnectMinDelay;      // First reconnection attempt delay [msec]
+    gint _reconnectMaxDelay;      // Maximum reconnection attempt delay [msec]
+    gint _reconnectMaxAttempts;   // Maximum number of attempts (0 for unlimited)
+    gint _threadPriority;         // SCHED_FIFO priority of the streaming thread, 0 to keep it
+    guint64 _cpuAffinity;         // CPU mask of the streaming thread, 0 to keep it
+    gboolean _mlockBuffers;       // Lock the output buffers in RAM
+    guint _nThreads;              // Frame copy threads, 0 for automatic
+    gint _allocator;              // Output frame allocator [enum]
+    guint _cameraMetaInterval;    // Frames between two camera state reads, 0 for no meta
+    gboolean _imageStats;         // Attach the luma statistics meta to the frames
+    gdouble _minSharpness;        // Drop the frames less sharp than this, 0 to keep them
+    gint _motionMode;             // Handling of the frames without motion [enum]
+    guint _motionThreshold;       // Mean luma difference of a changed block
+    guint _motionMinBlocks;       // Changed blocks of a frame with motion
+    guint _motionKeepAlive;       // Longest time without a frame with motion [msec], 0 for none
+    gchar *_metricsLocation;      // Prometheus text file of the metrics, NULL for none
+    gchar *_metricsSocket;        // Unix domain socket serving the metrics, NULL for none
+    guint _metricsInterval;       // Period of the metrics file updates [msec]
     // <---- Properties
 
     int _realFps;   // Real FPS
@@ -91,6 +125,37 @@ struct _GstZedXOneSrc {
 
     GstCaps *_caps;         // Stream caps
     guint _outFramesize;   // Output frame size in byte
+    guint _outStride;      // Output row size in byte
+    guint _outWidth;       // Output width in pixels
+    guint _outHeight;      // Output height in pixels
+    GstVideoFormat _outFormat;   // Negotiated video format
+
+    // ----> Capture thread
+    GstZedThreadStatus _threadStatus;   // Scheduling of the streaming thread
+    gboolean _mlockFailed;              // Buffer locking refused, not retried
+    GstZedCopyEngine *_copyEngine;      // Row sliced frame copy workers
+    GstZedGrabWorker *_grabWorker;      // Thread grabbing the camera
+    GstClockTime _grabPeriod;           // Camera frame period
+    // <---- Capture thread
+
+    // ----> Motion gate
+    GstZedMotionGate *_motionGate;      // Thumbnail of the reference frame
+    GstClockTime _motionOutputTime;     // Clock time of the last frame with motion
+    // <---- Motion gate
+
+    GstZedCaptureMetrics _metrics;   // Statistics of the `stats` property and the export
+
+    // ----> Camera state meta
+    GstZedCameraState _cameraState;   // Last image controls read from the camera
+    gboolean _cameraStateValid;       // `_cameraState` read since the camera was opened
+    guint _cameraStateAge;            // Frames since `_cameraState` was read
+    // <---- Camera state meta
+
+    // ----> Camera recovery
+    GstZedRecovery *_recovery;   // Camera lost, recovery in progress
+    GMutex _reconnectLock;       // `_recovery` and `_stopRequested` changes
+    GstBuffer *_lastBuffer;      // Copy of the last valid frame, used by the REPEAT policy
+    // <---- Camera recovery
 };
 
 struct _GstZedXOneSrcClass {
@@ -0,0 +1,174 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+/* Heap allocation counter preloaded in the allocation tests (`ENABLE_ALLOC_TRACE`
+ * CMake option). The C allocation functions are interposed, so that the allocations
+ * done by GLib, GStreamer, the ZED SDK and the C++ operators are all counted.
+ *
+ *   LD_PRELOAD=libgstzedalloctrace.so <program>
+ *
+ * The count is read with `gst_zed_alloc_trace_count`, looked up with `dlsym`. */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <dlfcn.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef void *(*MallocFunc)(size_t);
+typedef void *(*CallocFunc)(size_t, size_t);
+typedef void *(*ReallocFunc)(void *, size_t);
+typedef void (*FreeFunc)(void *);
+typedef int (*PosixMemalignFunc)(void **, size_t, size_t);
+typedef void *(*AlignedAllocFunc)(size_t, size_t);
+
+static MallocFunc real_malloc;
+static CallocFunc real_calloc;
+static ReallocFunc real_realloc;
+static FreeFunc real_free;
+static PosixMemalignFunc real_posix_memalign;
+static AlignedAllocFunc real_aligned_alloc;
+static AlignedAllocFunc real_memalign;
+
+static uint64_t alloc_count;   // All the threads of the process
+
+// ----> Bootstrap
+/* `dlsym` may allocate before the real functions are known: these allocations are
+ * served from a static arena, never freed */
+static char bootstrap_arena[4096] __attribute__((aligned(16)));
+static size_t bootstrap_used;
+static int initializing;
+
+static void *bootstrap_alloc(size_t size) {
+    size = (size + 15) & ~static_cast<size_t>(15);
+    if (bootstrap_used + size > sizeof(bootstrap_arena)) {
+        return NULL;
+    }
+    void *ptr = bootstrap_arena + bootstrap_used;
+    bootstrap_used += size;
+    return ptr;
+}
+
+static bool is_bootstrap(void *ptr) {
+    return static_cast<char *>(ptr) >= bootstrap_arena &&
+           static_cast<char *>(ptr) < bootstrap_arena + sizeof(bootstrap_arena);
+}
+
+static void alloc_trace_init() {
+    initializing = 1;
+    real_malloc = reinterpret_cast<MallocFunc>(dlsym(RTLD_NEXT, "malloc"));
+    real_calloc = reinterpret_cast<CallocFunc>(dlsym(RTLD_NEXT, "calloc"));
+    real_realloc = reinterpret_cast<ReallocFunc>(dlsym(RTLD_NEXT, "realloc"));
+    real_free = reinterpret_cast<FreeFunc>(dlsym(RTLD_NEXT, "free"));
+    real_posix_memalign =
+        reinterpret_cast<PosixMemalignFunc>(dlsym(RTLD_NEXT, "posix_memalign"));
+    real_aligned_alloc = reinterpret_cast<AlignedAllocFunc>(dlsym(RTLD_NEXT, "aligned_alloc"));
+    real_memalign = reinterpret_cast<AlignedAllocFunc>(dlsym(RTLD_NEXT, "memalign"));
+    initializing = 0;
+}
+// <---- Bootstrap
+
+static inline void alloc_trace_count() {
+    __atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+}
+
+extern "C" {
+
+uint64_t gst_zed_alloc_trace_count(void) {
+    return __atomic_load_n(&alloc_count, __ATOMIC_RELAXED);
+}
+
+void *malloc(size_t size) {
+    if (!real_malloc) {
+        if (initializing) {
+            return bootstrap_alloc(size);
+        }
+        alloc_trace_init();
+    }
+    alloc_trace_count();
+    return real_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    if (!real_calloc) {
+        if (initializing) {
+            return bootstrap_alloc(n * size);   // Static arena: already zeroed
+        }
+        alloc_trace_init();
+    }
+    alloc_trace_count();
+    return real_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (!real_realloc) {
+        alloc_trace_init();
+    }
+    alloc_trace_count();
+    if (ptr && is_bootstrap(ptr)) {
+        void *copy = real_malloc(size);
+        if (copy) {
+            size_t available = bootstrap_arena + sizeof(bootstrap_arena) - static_cast<char *>(ptr);
+            memcpy(copy, ptr, size < available ? size : available);
+        }
+        return copy;
+    }
+    return real_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (!ptr || is_bootstrap(ptr)) {
+        return;
+    }
+    if (!real_free) {
+        alloc_trace_init();
+    }
+    real_free(ptr);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+    if (!real_posix_memalign) {
+        alloc_trace_init();
+    }
+    alloc_trace_count();
+    return real_posix_memalign(ptr, alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    if (!real_aligned_alloc) {
+        alloc_trace_init();
+    }
+    alloc_trace_count();
+    return real_aligned_alloc(alignment, size);
+}
+
+void *memalign(size_t alignment, size_t size) {
+    if (!real_memalign) {
+        alloc_trace_init();
+    }
+    alloc_trace_count();
+    return real_memalign(alignment, size);
+}
+
+}   // extern "C"
@@ -0,0 +1,182 @@
+// /////////////////////////////////////////////////////////////////////////
+
+//
+// Copyright (c) 2024, STEREOLABS.
+//
+// All rights reserved.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// /////////////////////////////////////////////////////////////////////////
+
+/* Check that `zedsrc` streams without any heap allocation once warmed up. The
+ * allocations of the whole process are counted by the preloaded allocation shim
+ * between consecutive output buffers, grab and worker threads included.
+ *
+ *   LD_PRELOAD=libgstzedalloctrace.so test-zedsrc-alloc ["<pipeline>"]
+ *
+ * Exit code: 0 without allocation, 1 on failure, 77 when no camera can be opened.
+ * Per-frame meta-data (`image-stats`, `motion-gate`) is allocated with each buffer:
+ * the default pipeline leaves it disabled. */
+
+#include <dlfcn.h>
+#include <stdlib.h>
+
+#include <gst/gst.h>
+
+// Frames output before counting the allocations
+#define WARMUP_FRAMES 60
+// Frames checked after the warm-up
+#define CHECKED_FRAMES 300
+// Time allowed for the camera to open and stream all the frames [sec]
+#define TEST_TIMEOUT 60
+
+#define DEFAULT_PIPELINE "zedsrc name=src ! fakesink sync=false enable-last-sample=false"
+
+#define EXIT_SKIP 77
+
+typedef guint64 (*AllocCountFunc)(void);
+
+typedef struct {
+    AllocCountFunc alloc_count;
+    GstBus *bus;
+    guint64 frames;
+    guint64 last_count;
+    guint64 allocations;      // After the warm-up
+    guint64 first_frame;      // First frame allocating after the warm-up
+    guint64 worst_frame;      // Frame with the most allocations
+    guint64 worst_count;
+} AllocTest;
+
+/* Called from the streaming thread for each output buffer: must not allocate
+ * once the warm-up is over */
+static GstPadProbeReturn buffer_probe(GstPad *pad, GstPadProbeInfo *info, gpointer data) {
+    AllocTest *test = static_cast<AllocTest *>(data);
+    guint64 count = test->alloc_count();
+    guint64 delta = count - test->last_count;
+
+    if (test->frames > WARMUP_FRAMES && test->frames <= WARMUP_FRAMES + CHECKED_FRAMES) {
+        if (delta > 0 && test->allocations == 0) {
+            test->first_frame = test->frames;
+        }
+        if (delta > test->worst_count) {
+            test->worst_frame = test->frames;
+            test->worst_count = delta;
+        }
+        test->allocations += delta;
+    }
+    test->frames++;
+
+    if (test->frames == WARMUP_FRAMES + CHECKED_FRAMES + 1) {
+        gst_bus_post(test->bus, gst_message_new_application(
+                                    NULL, gst_structure_new_empty("alloc-test-done")));
+    }
+
+    test->last_count = test->alloc_count();   // Allocations of the message not counted
+
+    return GST_PAD_PROBE_OK;
+}
+
+int main(int argc, char *argv[]) {
+    AllocTest test = {};
+    GError *error = NULL;
+    int result = EXIT_FAILURE;
+
+    gst_init(&argc, &argv);
+
+    test.alloc_count =
+        reinterpret_cast<AllocCountFunc>(dlsym(RTLD_DEFAULT, "gst_zed_alloc_trace_count"));
+    if (!test.alloc_count) {
+        g_printerr("The allocation shim is not loaded: run with "
+                   "LD_PRELOAD=libgstzedalloctrace.so\n");
+        return EXIT_FAILURE;
+    }
+
+    GstElement *pipeline = gst_parse_launch(argc > 1 ? argv[1] : DEFAULT_PIPELINE, &error);
+    if (!pipeline) {
+        g_printerr("Cannot create the pipeline: %s\n", error->message);
+        g_error_free(error);
+        return EXIT_FAILURE;
+    }
+
+    GstElement *src = gst_bin_get_by_name(GST_BIN(pipeline), "src");
+    if (!src) {
+        g_printerr("No element named 'src' in the pipeline\n");
+        gst_object_unref(pipeline);
+        return EXIT_FAILURE;
+    }
+    GstPad *srcpad = gst_element_get_static_pad(src, "src");
+    gst_pad_add_probe(srcpad, GST_PAD_PROBE_TYPE_BUFFER, buffer_probe, &test, NULL);
+    gst_object_unref(srcpad);
+    gst_object_unref(src);
+
+    test.bus = gst_element_get_bus(pipeline);
+
+    if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+        g_printerr("Camera not available: test skipped\n");
+        result = EXIT_SKIP;
+        goto done;
+    }
+
+    while (TRUE) {
+        GstMessage *msg = gst_bus_timed_pop_filtered(
+            test.bus, TEST_TIMEOUT * GST_SECOND,
+            (GstMessageType) (GST_MESSAGE_ERROR | GST_MESSAGE_EOS | GST_MESSAGE_APPLICATION));
+        if (!msg) {
+            g_printerr("Timeout after %" G_GUINT64_FORMAT " frames\n", test.frames);
+            break;
+        }
+
+        GstMessageType type = GST_MESSAGE_TYPE(msg);
+        if (type == GST_MESSAGE_APPLICATION && !gst_message_has_name(msg, "alloc-test-done")) {
+            gst_message_unref(msg);
+            continue;   // Not ours
+        }
+
+        if (type == GST_MESSAGE_ERROR) {
+            gst_message_parse_error(msg, &error, NULL);
+            g_printerr("Error after %" G_GUINT64_FORMAT " frames: %s\n", test.frames,
+                       error->message);
+            g_error_free(error);
+            // Camera never opened: nothing to check on this machine
+            result = (test.frames == 0) ? EXIT_SKIP : EXIT_FAILURE;
+        } else if (type == GST_MESSAGE_EOS) {
+            g_printerr("End of stream after %" G_GUINT64_FORMAT " frames\n", test.frames);
+        }
+        gst_message_unref(msg);
+        break;
+    }
+
+done:
+    gst_element_set_state(pipeline, GST_STATE_NULL);
+
+    if (test.frames > WARMUP_FRAMES + CHECKED_FRAMES) {
+        if (test.allocations == 0) {
+            g_print("No heap allocation in %d frames after %d warm-up frames\n", CHECKED_FRAMES,
+                    WARMUP_FRAMES);
+            result = EXIT_SUCCESS;
+        } else {
+            g_printerr("%" G_GUINT64_FORMAT " heap allocations in %d frames: first at frame #%"
+                       G_GUINT64_FORMAT ", %" G_GUINT64_FORMAT " at frame #%" G_GUINT64_FORMAT
+                       "\n",
+                       test.allocations, CHECKED_FRAMES, test.first_frame, test.worst_count,
+                       test.worst_frame);
+            result = EXIT_FAILURE;
+        }
+    }
+
+    gst_object_unref(test.bus);
+    gst_object_unref(pipeline);
+
+    return result;
+}